@@ -4,18 +4,29 @@
 // Row configuration: label, type, min, max, smallStep, largeStep, suffix
 const BraidsVSTEditor::RowConfig BraidsVSTEditor::kRowConfigs[kNumRows] = {
     {"PRESET", RowType::Preset,    0,   0,    1,   1,  ""},   // min/max set dynamically
-    {"SHAPE",  RowType::Shape,     0,   9,    1,   1,  ""},
+    {"SHAPE",  RowType::Shape,     0,   braids::MACRO_OSC_SHAPE_LAST - 1, 1, 1, ""},
     {"TIMBRE", RowType::Timbre,    0,   127,  1,   13, ""},
     {"COLOR",  RowType::Color,     0,   127,  1,   13, ""},
+    {"FM FB",  RowType::FmFeedback, 0,  127,  1,   13, ""},
     {"CUTOFF", RowType::Cutoff,    0,   127,  1,   13, ""},
     {"RESO",   RowType::Resonance, 0,   127,  1,   13, ""},
     {"ATTACK", RowType::Attack,    0,   500,  5,   50, "ms"},
     {"DECAY",  RowType::Decay,     10,  2000, 20,  200, "ms"},
-    {"VOICES", RowType::Voices,    1,   16,   1,   2,  ""},
+    {"VOICES", RowType::Voices,    1,   128,  1,   8,  ""},
+    {"STEAL",  RowType::Steal,     0,   3,    1,   1,  ""},
+    {"POOL",   RowType::Pool,      1,   128,  1,   8,  ""},
+    {"RATE",   RowType::Rate,      0,   1,    1,   1,  ""},
     {"LFO1",   RowType::Lfo1,      0,   0,    1,   1,  ""},   // Multi-field row
     {"LFO2",   RowType::Lfo2,      0,   0,    1,   1,  ""},   // Multi-field row
     {"ENV1",   RowType::Env1,      0,   0,    1,   1,  ""},   // Multi-field row
     {"ENV2",   RowType::Env2,      0,   0,    1,   1,  ""},   // Multi-field row
+    {"ETRIG",  RowType::EnvTrig,   0,   2,    1,   1,  ""},
+    {"ECURVE", RowType::EnvCurve,  0,   2,    1,   1,  ""},
+    {"VEL",    RowType::VelMod,    0,   0,    1,   1,  ""},   // Multi-field row
+    {"AENV",   RowType::EnvMod,    0,   0,    1,   1,  ""},   // Multi-field row
+    {"PRESS",  RowType::PressMod,  0,   0,    1,   1,  ""},   // Multi-field row
+    {"SLIDE",  RowType::SlideMod,  0,   0,    1,   1,  ""},   // Multi-field row
+    {"MPE",    RowType::Mpe,       0,   1,    1,   1,  ""},
 };
 
 namespace {
@@ -32,7 +43,7 @@ namespace {
 
     // Layout
     constexpr int kWindowWidth = 320;
-    constexpr int kWindowHeight = 382;  // 13 rows now
+    constexpr int kWindowHeight = 668;  // 24 rows now
     constexpr int kTitleHeight = 32;
     constexpr int kRowHeight = 26;
     constexpr int kRowMargin = 2;
@@ -49,7 +60,10 @@ BraidsVSTEditor::BraidsVSTEditor(BraidsVSTProcessor& p)
 {
     setSize(kWindowWidth, kWindowHeight);
     setWantsKeyboardFocus(true);
-    startTimerHz(30);  // Refresh UI at 30fps for modified indicator
+    for (int i = 0; i < kNumRows; ++i) {
+        rowViews_[i] = describeRow(i);  // What the first full paint shows
+    }
+    startTimerHz(kActiveRefreshHz);  // Picks up host automation, preset changes and modulation
 }
 
 BraidsVSTEditor::~BraidsVSTEditor()
@@ -59,7 +73,110 @@ BraidsVSTEditor::~BraidsVSTEditor()
 
 void BraidsVSTEditor::timerCallback()
 {
-    repaint();  // Refresh to show modified state and preset changes
+    // The traces only move when a snapshot differs from the one before it;
+    // a steady value leaves the history flat
+    auto same = [](const BraidsVSTProcessor::ModulationSnapshot& a,
+                   const BraidsVSTProcessor::ModulationSnapshot& b) {
+        return a.timbre == b.timbre && a.color == b.color &&
+               a.cutoff == b.cutoff && a.resonance == b.resonance;
+    };
+    bool modulationMoved = false;
+    bool received = false;
+    BraidsVSTProcessor::ModulationSnapshot snapshot;
+    while (processor_.popModulationSnapshot(snapshot)) {
+        const auto& last = modHistory_[(modHistoryPos_ + kModHistoryLength - 1) % kModHistoryLength];
+        if (modHistoryCount_ == 0 || !same(snapshot, last)) {
+            modulationMoved = true;
+        }
+        modHistory_[modHistoryPos_] = snapshot;
+        modHistoryPos_ = (modHistoryPos_ + 1) % kModHistoryLength;
+        modHistoryCount_ = std::min(modHistoryCount_ + 1, kModHistoryLength);
+        received = true;
+    }
+    // Earlier changes still scroll through the history until it is flat
+    if (received && !modulationMoved) {
+        const auto& newest = modHistory_[(modHistoryPos_ + kModHistoryLength - 1) % kModHistoryLength];
+        for (int i = 0; i < modHistoryCount_ && !modulationMoved; ++i) {
+            modulationMoved = !same(modHistory_[i], newest);
+        }
+    }
+
+    if (repaintDirtyRows(modulationMoved)) {
+        wakeTimer();
+    } else if (++idleTicks_ == kIdleTicksBeforeBackoff) {
+        startTimerHz(kIdleRefreshHz);  // Nothing is animating
+    }
+}
+
+void BraidsVSTEditor::wakeTimer()
+{
+    idleTicks_ = 0;
+    if (getTimerInterval() != 1000 / kActiveRefreshHz) {
+        startTimerHz(kActiveRefreshHz);
+    }
+}
+
+juce::Rectangle<int> BraidsVSTEditor::rowBounds(int row) const
+{
+    return { 0, kTitleHeight + row * kRowHeight, getWidth(), kRowHeight };
+}
+
+BraidsVSTEditor::RowView BraidsVSTEditor::describeRow(int row) const
+{
+    // Everything paint() draws for the row
+    RowView view;
+    if (row == selectedRow_) {
+        view.selectedField = isModRow(row) ? selectedField_ : 0;
+    }
+    if (isModRow(row)) {
+        view.label = kRowConfigs[row].label;
+        for (int f = 0; f < getNumFieldsForRow(row); ++f) {
+            view.value += formatModFieldValue(row, f) + "|";
+        }
+        view.barWidth = 0;
+    } else {
+        view.label = getDynamicLabel(row);
+        view.value = formatValue(row);
+        view.barWidth = static_cast<int>(normalizedValue(row) * (getWidth() - 2 * kPadding));
+        view.overlay = hasModulationOverlay(row);
+    }
+    return view;
+}
+
+bool BraidsVSTEditor::repaintDirtyRows(bool modulationMoved)
+{
+    bool dirty = false;
+    for (int i = 0; i < kNumRows; ++i) {
+        RowView view = describeRow(i);
+        bool traceMoved = modulationMoved && (view.overlay || rowViews_[i].overlay);
+        if (traceMoved || view != rowViews_[i]) {
+            rowViews_[i] = view;
+            repaint(rowBounds(i));
+            dirty = true;
+        }
+    }
+    return dirty;
+}
+
+void BraidsVSTEditor::refreshRows()
+{
+    repaintDirtyRows(false);
+    wakeTimer();
+}
+
+bool BraidsVSTEditor::isInterestedInFileDrag(const juce::StringArray& files)
+{
+    return files.size() == 1;
+}
+
+void BraidsVSTEditor::filesDropped(const juce::StringArray& files, int, int)
+{
+    if (files.size() != 1 || !processor_.loadWavetable(juce::File(files[0]))) {
+        return;
+    }
+    *processor_.getShapeParam() = static_cast<int>(braids::MACRO_OSC_SHAPE_WAVETABLE);
+    processor_.getPresetManager().markModified();
+    refreshRows();
 }
 
 int BraidsVSTEditor::getDisplayValue(int row) const
@@ -74,6 +191,8 @@ int BraidsVSTEditor::getDisplayValue(int row) const
             return static_cast<int>(processor_.getTimbreParam()->get() * 127.0f + 0.5f);
         case RowType::Color:
             return static_cast<int>(processor_.getColorParam()->get() * 127.0f + 0.5f);
+        case RowType::FmFeedback:
+            return static_cast<int>(processor_.getFmFeedbackParam()->get() * 127.0f + 0.5f);
         case RowType::Cutoff:
             return static_cast<int>(processor_.getCutoffParam()->get() * 127.0f + 0.5f);
         case RowType::Resonance:
@@ -83,12 +202,29 @@ int BraidsVSTEditor::getDisplayValue(int row) const
         case RowType::Decay:
             return static_cast<int>(processor_.getDecayParam()->get() * 1990.0f + 10.0f + 0.5f);
         case RowType::Voices:
-            return processor_.getPolyphonyParam()->get();
+            // What is actually playable: automation can ask for more than the pool
+            return std::min(processor_.getPolyphonyParam()->get(), processor_.getVoicePoolSize());
+        case RowType::Steal:
+            return processor_.getStealModeParam()->getIndex();
+        case RowType::EnvTrig:
+            return processor_.getEnvModeParam()->getIndex();
+        case RowType::EnvCurve:
+            return processor_.getEnvCurveParam()->getIndex();
+        case RowType::Pool:
+            return processor_.getVoicePoolSize();
+        case RowType::Rate:
+            return processor_.getRenderAtHostRate() ? 1 : 0;
+        case RowType::Mpe:
+            return processor_.getMpeParam()->get() ? 1 : 0;
         // Mod rows have multiple fields, handled by getModFieldValue instead
         case RowType::Lfo1:
         case RowType::Lfo2:
         case RowType::Env1:
         case RowType::Env2:
+        case RowType::VelMod:
+        case RowType::EnvMod:
+        case RowType::PressMod:
+        case RowType::SlideMod:
             return 0;
     }
     return 0;
@@ -108,7 +244,7 @@ void BraidsVSTEditor::setDisplayValue(int row, int value)
             break;
         }
         case RowType::Shape:
-            value = juce::jlimit(0, 9, value);
+            value = juce::jlimit(0, braids::MACRO_OSC_SHAPE_LAST - 1, value);
             *processor_.getShapeParam() = value;
             processor_.getPresetManager().markModified();
             break;
@@ -122,6 +258,11 @@ void BraidsVSTEditor::setDisplayValue(int row, int value)
             *processor_.getColorParam() = value / 127.0f;
             processor_.getPresetManager().markModified();
             break;
+        case RowType::FmFeedback:
+            value = juce::jlimit(0, 127, value);
+            *processor_.getFmFeedbackParam() = value / 127.0f;
+            processor_.getPresetManager().markModified();
+            break;
         case RowType::Cutoff:
             value = juce::jlimit(0, 127, value);
             *processor_.getCutoffParam() = value / 127.0f;
@@ -143,18 +284,55 @@ void BraidsVSTEditor::setDisplayValue(int row, int value)
             processor_.getPresetManager().markModified();
             break;
         case RowType::Voices:
-            value = juce::jlimit(1, 16, value);
+            // Up to the pool: growing it reallocates and cuts off every note,
+            // which is left to the POOL row
+            value = juce::jlimit(1, processor_.getVoicePoolSize(), value);
             *processor_.getPolyphonyParam() = value;
             processor_.getPresetManager().markModified();
             break;
+        case RowType::Steal:
+            value = juce::jlimit(0, 3, value);
+            *processor_.getStealModeParam() = value;
+            processor_.getPresetManager().markModified();
+            break;
+        case RowType::EnvTrig:
+            value = juce::jlimit(0, 2, value);
+            *processor_.getEnvModeParam() = value;
+            processor_.getPresetManager().markModified();
+            break;
+        case RowType::EnvCurve:
+            value = juce::jlimit(0, 2, value);
+            *processor_.getEnvCurveParam() = value;
+            processor_.getPresetManager().markModified();
+            break;
+        case RowType::Pool:
+            // Pool size is an instance setting, not part of the preset
+            value = juce::jlimit(1, 128, value);
+            processor_.setVoicePoolSize(value);
+            if (processor_.getPolyphonyParam()->get() > value) {
+                *processor_.getPolyphonyParam() = value;
+            }
+            break;
+        case RowType::Rate:
+            // Render rate is an instance setting, not part of the preset
+            processor_.setRenderAtHostRate(juce::jlimit(0, 1, value) != 0);
+            break;
+        case RowType::Mpe:
+            // Controller setup, not part of the preset
+            *processor_.getMpeParam() = juce::jlimit(0, 1, value) != 0;
+            break;
         // Mod rows have multiple fields, handled by setModFieldValue instead
         case RowType::Lfo1:
         case RowType::Lfo2:
         case RowType::Env1:
         case RowType::Env2:
+        case RowType::VelMod:
+        case RowType::EnvMod:
+        case RowType::PressMod:
+        case RowType::SlideMod:
             break;
     }
-    repaint();
+    refreshRows();
 }
 
 juce::String BraidsVSTEditor::formatValue(int row) const
@@ -168,14 +346,30 @@ juce::String BraidsVSTEditor::formatValue(int row) const
         int value = getDisplayValue(row);
         return shapeNames_[value];
     }
+    if (cfg.type == RowType::Steal) {
+        int value = getDisplayValue(row);
+        return stealModeNames_[value];
+    }
+    if (cfg.type == RowType::EnvTrig) {
+        return envModeNames_[getDisplayValue(row)];
+    }
+    if (cfg.type == RowType::EnvCurve) {
+        return envCurveNames_[getDisplayValue(row)];
+    }
+    if (cfg.type == RowType::Rate) {
+        return getDisplayValue(row) != 0 ? "HOST" : "96K";
+    }
+    if (cfg.type == RowType::Mpe) {
+        return getDisplayValue(row) != 0 ? "ON" : "OFF";
+    }
 
     int value = getDisplayValue(row);
     juce::String str;
 
-    if (cfg.type == RowType::Timbre || cfg.type == RowType::Color ||
+    if (cfg.type == RowType::Timbre || cfg.type == RowType::Color || cfg.type == RowType::FmFeedback ||
         cfg.type == RowType::Cutoff || cfg.type == RowType::Resonance) {
         str = juce::String(value).paddedLeft('0', 3);
-    } else if (cfg.type == RowType::Voices) {
+    } else if (cfg.type == RowType::Voices || cfg.type == RowType::Pool) {
         str = juce::String(value).paddedLeft('0', 2);
     } else {
         str = juce::String(value) + cfg.suffix;
@@ -220,16 +414,25 @@ void BraidsVSTEditor::paint(juce::Graphics& g)
 {
     g.fillAll(kBgColor);
 
+    // Mostly called for a few dirty rows, so skip everything outside the clip
+    const auto clip = g.getClipBounds();
+
     // Title
-    g.setColour(kTitleColor);
-    g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 16.0f, juce::Font::bold));
-    g.drawText("BRAIDS VST", 0, 4, getWidth(), kTitleHeight - 4, juce::Justification::centred);
+    if (clip.getY() < kTitleHeight) {
+        g.setColour(kTitleColor);
+        g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 16.0f, juce::Font::bold));
+        g.drawText("BRAIDS VST", 0, 4, getWidth(), kTitleHeight - 4, juce::Justification::centred);
+    }
 
     // Rows
     g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 14.0f, juce::Font::plain));
 
     int y = kTitleHeight;
     for (int i = 0; i < kNumRows; ++i) {
+        if (!clip.intersects(rowBounds(i))) {
+            y += kRowHeight;
+            continue;
+        }
         bool selected = (i == selectedRow_);
 
         // Row background
@@ -283,7 +486,7 @@ bool BraidsVSTEditor::keyPressed(const juce::KeyPress& key)
     // Shift+S to save preset
     if (shift && key.getKeyCode() == 'S') {
         processor_.getPresetManager().saveCurrentAsNewPreset();
-        repaint();
+        refreshRows();
         return true;
     }
 
@@ -296,7 +499,7 @@ bool BraidsVSTEditor::keyPressed(const juce::KeyPress& key)
             } else {
                 selectedField_ = (selectedField_ + 1) % numFields;
             }
-            repaint();
+            refreshRows();
             return true;
         }
     }
@@ -304,13 +507,13 @@ bool BraidsVSTEditor::keyPressed(const juce::KeyPress& key)
     if (key.getKeyCode() == juce::KeyPress::upKey) {
         selectedRow_ = (selectedRow_ - 1 + kNumRows) % kNumRows;
         selectedField_ = 0;  // Reset field selection when changing rows
-        repaint();
+        refreshRows();
         return true;
     }
     if (key.getKeyCode() == juce::KeyPress::downKey) {
         selectedRow_ = (selectedRow_ + 1) % kNumRows;
         selectedField_ = 0;  // Reset field selection when changing rows
-        repaint();
+        refreshRows();
         return true;
     }
     if (key.getKeyCode() == juce::KeyPress::leftKey) {
@@ -352,7 +555,7 @@ void BraidsVSTEditor::mouseDown(const juce::MouseEvent& event)
         selectedRow_ = row;
         dragStartValue_ = getDisplayValue(row);
         dragStartX_ = event.x;
-        repaint();
+        refreshRows();
     }
 }
 
@@ -397,7 +600,7 @@ juce::String BraidsVSTEditor::getDynamicLabel(int row) const
     // For Timbre and Color, return shape-specific labels
     if (cfg.type == RowType::Timbre || cfg.type == RowType::Color) {
         int shapeIndex = processor_.getShapeParam()->getIndex();
-        if (shapeIndex >= 0 && shapeIndex < 10) {
+        if (shapeIndex >= 0 && shapeIndex < braids::MACRO_OSC_SHAPE_LAST) {
             if (cfg.type == RowType::Timbre) {
                 return timbreLabels_[shapeIndex];
             } else {
@@ -418,7 +621,9 @@ bool BraidsVSTEditor::isModRow(int row) const
 {
     const auto& cfg = kRowConfigs[row];
     return cfg.type == RowType::Lfo1 || cfg.type == RowType::Lfo2 ||
-           cfg.type == RowType::Env1 || cfg.type == RowType::Env2;
+           cfg.type == RowType::Env1 || cfg.type == RowType::Env2 ||
+           cfg.type == RowType::VelMod || cfg.type == RowType::EnvMod ||
+           cfg.type == RowType::PressMod || cfg.type == RowType::SlideMod;
 }
 
 int BraidsVSTEditor::getNumFieldsForRow(int row) const
@@ -426,10 +631,15 @@ int BraidsVSTEditor::getNumFieldsForRow(int row) const
     const auto& cfg = kRowConfigs[row];
     // LFO: Rate, Shape, Dest, Amount (4 fields)
     // ENV: Attack, Decay, Dest, Amount (4 fields)
+    // Per-voice VEL/AENV/PRESS/SLIDE: Dest, Amount (2 fields)
     if (cfg.type == RowType::Lfo1 || cfg.type == RowType::Lfo2 ||
         cfg.type == RowType::Env1 || cfg.type == RowType::Env2) {
         return 4;
     }
+    if (cfg.type == RowType::VelMod || cfg.type == RowType::EnvMod ||
+        cfg.type == RowType::PressMod || cfg.type == RowType::SlideMod) {
+        return 2;
+    }
     return 1;  // Single field for non-mod rows
 }
 
@@ -465,6 +675,26 @@ int BraidsVSTEditor::getModFieldValue(int row, int field) const
             case 2: return processor_.getEnv2DestParam()->getIndex();
             case 3: return processor_.getEnv2AmountParam()->get();
         }
+    } else if (cfg.type == RowType::VelMod) {
+        switch (field) {
+            case 0: return processor_.getVelDestParam()->getIndex();
+            case 1: return processor_.getVelAmountParam()->get();
+        }
+    } else if (cfg.type == RowType::EnvMod) {
+        switch (field) {
+            case 0: return processor_.getAenvDestParam()->getIndex();
+            case 1: return processor_.getAenvAmountParam()->get();
+        }
+    } else if (cfg.type == RowType::PressMod) {
+        switch (field) {
+            case 0: return processor_.getPressDestParam()->getIndex();
+            case 1: return processor_.getPressAmountParam()->get();
+        }
+    } else if (cfg.type == RowType::SlideMod) {
+        switch (field) {
+            case 0: return processor_.getSlideDestParam()->getIndex();
+            case 1: return processor_.getSlideAmountParam()->get();
+        }
     }
     return 0;
 }
@@ -480,7 +710,7 @@ void BraidsVSTEditor::setModFieldValue(int row, int field, int value)
                 *processor_.getLfo1RateParam() = value;
                 break;
             case 1:  // Shape
-                value = juce::jlimit(0, static_cast<int>(braids::LfoShape::NumShapes) - 1, value);
+                value = juce::jlimit(0, processor_.getLfo1ShapeParam()->choices.size() - 1, value);
                 *processor_.getLfo1ShapeParam() = value;
                 break;
             case 2:  // Dest
@@ -499,7 +729,7 @@ void BraidsVSTEditor::setModFieldValue(int row, int field, int value)
                 *processor_.getLfo2RateParam() = value;
                 break;
             case 1:
-                value = juce::jlimit(0, static_cast<int>(braids::LfoShape::NumShapes) - 1, value);
+                value = juce::jlimit(0, processor_.getLfo2ShapeParam()->choices.size() - 1, value);
                 *processor_.getLfo2ShapeParam() = value;
                 break;
             case 2:
@@ -549,10 +779,54 @@ void BraidsVSTEditor::setModFieldValue(int row, int field, int value)
                 *processor_.getEnv2AmountParam() = value;
                 break;
         }
+    } else if (cfg.type == RowType::VelMod) {
+        switch (field) {
+            case 0:  // Dest
+                value = juce::jlimit(0, static_cast<int>(VoiceModDestination::NumDestinations) - 1, value);
+                *processor_.getVelDestParam() = value;
+                break;
+            case 1:  // Amount
+                value = juce::jlimit(-64, 63, value);
+                *processor_.getVelAmountParam() = value;
+                break;
+        }
+    } else if (cfg.type == RowType::EnvMod) {
+        switch (field) {
+            case 0:
+                value = juce::jlimit(0, static_cast<int>(VoiceModDestination::NumDestinations) - 1, value);
+                *processor_.getAenvDestParam() = value;
+                break;
+            case 1:
+                value = juce::jlimit(-64, 63, value);
+                *processor_.getAenvAmountParam() = value;
+                break;
+        }
+    } else if (cfg.type == RowType::PressMod) {
+        switch (field) {
+            case 0:
+                value = juce::jlimit(0, static_cast<int>(VoiceModDestination::NumDestinations) - 1, value);
+                *processor_.getPressDestParam() = value;
+                break;
+            case 1:
+                value = juce::jlimit(-64, 63, value);
+                *processor_.getPressAmountParam() = value;
+                break;
+        }
+    } else if (cfg.type == RowType::SlideMod) {
+        switch (field) {
+            case 0:
+                value = juce::jlimit(0, static_cast<int>(VoiceModDestination::NumDestinations) - 1, value);
+                *processor_.getSlideDestParam() = value;
+                break;
+            case 1:
+                value = juce::jlimit(-64, 63, value);
+                *processor_.getSlideAmountParam() = value;
+                break;
+        }
     }
 
     processor_.getPresetManager().markModified();
-    repaint();
+    refreshRows();
 }
 
 juce::String BraidsVSTEditor::getModDestinationName(int destIdx) const
@@ -561,10 +835,10 @@ juce::String BraidsVSTEditor::getModDestinationName(int destIdx) const
     int shapeIndex = processor_.getShapeParam()->getIndex();
 
     // Use dynamic names for Timbre and Color based on current shape
-    if (dest == braids::ModDestination::Timbre && shapeIndex >= 0 && shapeIndex < 10) {
+    if (dest == braids::ModDestination::Timbre && shapeIndex >= 0 && shapeIndex < braids::MACRO_OSC_SHAPE_LAST) {
         return timbreLabels_[shapeIndex];
     }
-    if (dest == braids::ModDestination::Color && shapeIndex >= 0 && shapeIndex < 10) {
+    if (dest == braids::ModDestination::Color && shapeIndex >= 0 && shapeIndex < braids::MACRO_OSC_SHAPE_LAST) {
         return colorLabels_[shapeIndex];
     }
 
@@ -614,6 +888,18 @@ juce::String BraidsVSTEditor::formatModFieldValue(int row, int field) const
                 return (amt >= 0 ? "+" : "") + juce::String(amt);
             }
         }
+    } else if (cfg.type == RowType::VelMod || cfg.type == RowType::EnvMod ||
+               cfg.type == RowType::PressMod || cfg.type == RowType::SlideMod) {
+        switch (field) {
+            case 0: {  // Dest (per-voice destinations share the global ordering)
+                int idx = getModFieldValue(row, field);
+                return getModDestinationName(idx);
+            }
+            case 1: {  // Amount
+                int amt = getModFieldValue(row, field);
+                return (amt >= 0 ? "+" : "") + juce::String(amt);
+            }
+        }
     }
     return "???";
 }
@@ -657,41 +943,89 @@ void BraidsVSTEditor::paintModRow(juce::Graphics& g, int row, const juce::Rectan
     }
 }
 
-void BraidsVSTEditor::paintModulationOverlay(juce::Graphics& g, int row, const juce::Rectangle<int>& rowRect)
+float BraidsVSTEditor::snapshotValue(const BraidsVSTProcessor::ModulationSnapshot& snapshot, RowType type)
 {
-    const auto& cfg = kRowConfigs[row];
+    switch (type) {
+        case RowType::Timbre: return snapshot.timbre;
+        case RowType::Color: return snapshot.color;
+        case RowType::Cutoff: return snapshot.cutoff;
+        case RowType::Resonance: return snapshot.resonance;
+        default: return 0.0f;
+    }
+}
+
+float BraidsVSTEditor::modulationBaseValue(RowType type) const
+{
+    switch (type) {
+        case RowType::Timbre: return processor_.getTimbreParam()->get();
+        case RowType::Color: return processor_.getColorParam()->get();
+        case RowType::Cutoff: return processor_.getCutoffParam()->get();
+        case RowType::Resonance: return processor_.getResonanceParam()->get();
+        default: return 0.0f;
+    }
+}
 
-    float baseValue = 0.0f;
-    float modulatedValue = 0.0f;
+bool BraidsVSTEditor::hasModulationOverlay(int row) const
+{
+    const auto type = kRowConfigs[row].type;
+    if (type != RowType::Timbre && type != RowType::Color &&
+        type != RowType::Cutoff && type != RowType::Resonance) {
+        return false;
+    }
 
-    if (cfg.type == RowType::Timbre) {
-        baseValue = processor_.getTimbreParam()->get();
-        modulatedValue = processor_.getModulatedTimbre();
-    } else if (cfg.type == RowType::Color) {
-        baseValue = processor_.getColorParam()->get();
-        modulatedValue = processor_.getModulatedColor();
-    } else if (cfg.type == RowType::Cutoff) {
-        baseValue = processor_.getCutoffParam()->get();
-        modulatedValue = processor_.getModulatedCutoff();
-    } else if (cfg.type == RowType::Resonance) {
-        baseValue = processor_.getResonanceParam()->get();
-        modulatedValue = processor_.getModulatedResonance();
+    // Only drawn if the value moved away from the base over the last second
+    const float baseValue = modulationBaseValue(type);
+    for (int i = 0; i < modHistoryCount_; ++i) {
+        if (std::abs(snapshotValue(modHistory_[i], type) - baseValue) >= 0.001f) {
+            return true;
+        }
     }
+    return false;
+}
 
-    // Only draw if there's a visible difference
-    float diff = modulatedValue - baseValue;
-    if (std::abs(diff) < 0.001f) return;
+void BraidsVSTEditor::paintModulationOverlay(juce::Graphics& g, int row, const juce::Rectangle<int>& rowRect)
+{
+    if (!hasModulationOverlay(row)) return;
 
-    // Draw the modulation range as a semi-transparent overlay
-    int baseX = rowRect.getX() + static_cast<int>(baseValue * rowRect.getWidth());
-    int modX = rowRect.getX() + static_cast<int>(modulatedValue * rowRect.getWidth());
+    const auto& cfg = kRowConfigs[row];
+    const float baseValue = modulationBaseValue(cfg.type);
 
+    // Oldest snapshot first; the newest is the current modulated value
+    const int oldest = (modHistoryPos_ - modHistoryCount_ + kModHistoryLength) % kModHistoryLength;
+    auto historyValue = [&](int i) {
+        return snapshotValue(modHistory_[(oldest + i) % kModHistoryLength], cfg.type);
+    };
+    const float modulatedValue = historyValue(modHistoryCount_ - 1);
+
+    const float width = static_cast<float>(rowRect.getWidth());
+    auto xFor = [&](float value) { return rowRect.getX() + static_cast<int>(value * width); };
+
+    // Draw the modulation range as a semi-transparent overlay
+    int baseX = xFor(baseValue);
+    int modX = xFor(modulatedValue);
     int leftX = std::min(baseX, modX);
     int rightX = std::max(baseX, modX);
 
     g.setColour(kModOverlayColor);
     g.fillRect(leftX, rowRect.getY(), rightX - leftX, rowRect.getHeight());
 
+    // Scope trace of the last second, oldest at the top of the row
+    if (modHistoryCount_ > 1) {
+        juce::Path trace;
+        const float top = static_cast<float>(rowRect.getY());
+        const float step = static_cast<float>(rowRect.getHeight()) / static_cast<float>(modHistoryCount_ - 1);
+        for (int i = 0; i < modHistoryCount_; ++i) {
+            juce::Point<float> point(rowRect.getX() + historyValue(i) * width, top + step * i);
+            if (i == 0) {
+                trace.startNewSubPath(point);
+            } else {
+                trace.lineTo(point);
+            }
+        }
+        g.setColour(juce::Colours::white.withAlpha(0.35f));
+        g.strokePath(trace, juce::PathStrokeType(1.0f));
+    }
+
     // Draw a vertical line at the modulated position
     g.setColour(juce::Colours::white.withAlpha(0.7f));
     g.drawVerticalLine(modX, static_cast<float>(rowRect.getY()),
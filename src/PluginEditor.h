@@ -5,7 +5,8 @@
 #include "dsp/modulation_matrix.h"
 
 class BraidsVSTEditor : public juce::AudioProcessorEditor,
-                        public juce::Timer
+                        public juce::Timer,
+                        public juce::FileDragAndDropTarget
 {
 public:
     explicit BraidsVSTEditor(BraidsVSTProcessor&);
@@ -21,10 +22,14 @@ public:
     // Timer callback for UI refresh
     void timerCallback() override;
 
+    // Dropping a bank file loads it and selects the wavetable shape
+    bool isInterestedInFileDrag(const juce::StringArray& files) override;
+    void filesDropped(const juce::StringArray& files, int x, int y) override;
+
 private:
     // Row types: Preset is special, Mod rows have multiple fields
-    enum class RowType { Preset, Shape, Timbre, Color, Cutoff, Resonance, Attack, Decay, Voices, Lfo1, Lfo2, Env1, Env2 };
-    static constexpr int kNumRows = 13;
+    enum class RowType { Preset, Shape, Timbre, Color, FmFeedback, Cutoff, Resonance, Attack, Decay, Voices, Steal, Pool, Rate, Lfo1, Lfo2, Env1, Env2, EnvTrig, EnvCurve, VelMod, EnvMod, PressMod, SlideMod, Mpe };
+    static constexpr int kNumRows = 24;
 
     struct RowConfig {
         const char* label;
@@ -58,21 +63,85 @@ private:
     juce::String formatModFieldValue(int row, int field) const;
     juce::String getModDestinationName(int destIdx) const;
 
+    // Modulated value of a row in a snapshot (Timbre, Color, Cutoff, Resonance)
+    static float snapshotValue(const BraidsVSTProcessor::ModulationSnapshot& snapshot, RowType type);
+    float modulationBaseValue(RowType type) const;
+    bool hasModulationOverlay(int row) const;
+
+    // Dirty tracking: what each row showed when last repainted. Rows are
+    // repainted only when this changes, or when their modulation trace moves
+    struct RowView {
+        juce::String label;
+        juce::String value;   // Mod rows: every field
+        int barWidth = -1;
+        int selectedField = -1;  // -1 when the row isn't selected
+        bool overlay = false;
+
+        bool operator==(const RowView& other) const {
+            return label == other.label && value == other.value && barWidth == other.barWidth &&
+                   selectedField == other.selectedField && overlay == other.overlay;
+        }
+        bool operator!=(const RowView& other) const { return !(*this == other); }
+    };
+    RowView describeRow(int row) const;
+    juce::Rectangle<int> rowBounds(int row) const;
+    // Repaints the rows that changed; true if there were any
+    bool repaintDirtyRows(bool modulationMoved);
+    // After an edit or navigation: repaint what changed and wake the timer
+    void refreshRows();
+    void wakeTimer();
+
     BraidsVSTProcessor& processor_;
     int selectedRow_ = 0;
     int selectedField_ = 0;  // For mod rows with multiple fields
     int dragStartValue_ = 0;
     int dragStartX_ = 0;
 
+    // The last second of modulation snapshots, a ring with the oldest at
+    // modHistoryPos_ once full. Filled from the processor's queue each tick
+    static constexpr int kModHistoryLength = BraidsVSTProcessor::kModulationSnapshotRateHz;
+    BraidsVSTProcessor::ModulationSnapshot modHistory_[kModHistoryLength];
+    int modHistoryPos_ = 0;
+    int modHistoryCount_ = 0;
+
+    RowView rowViews_[kNumRows];
+
+    // The timer runs at kActiveRefreshHz while anything changes and backs off
+    // to kIdleRefreshHz after kIdleTicksBeforeBackoff quiet ticks
+    static constexpr int kActiveRefreshHz = 30;
+    static constexpr int kIdleRefreshHz = 5;
+    static constexpr int kIdleTicksBeforeBackoff = 30;
+    int idleTicks_ = 0;
+
     // Shape names for display
     const juce::StringArray shapeNames_ = {
         "SAW", "MORPH", "SAW/SQ", "SIN/TRI", "BUZZ",
-        "SQ+SUB", "SAW+SUB", "SQ SYNC", "SAW SYNC", "FM"
+        "SQ+SUB", "SAW+SUB", "SQ SYNC", "SAW SYNC", "FM", "FM4",
+        "SAW x3", "SQ x3", "TRI x3", "SIN x3", "RING x3", "SWARM",
+        "COMB", "TOY", "VOSIM", "HARMNCS", "PLUCK", "BELL", "DRUM",
+        "KICK", "SNARE", "CYMBAL", "FILT NS", "TWIN PK", "CLK NS",
+        "GRAINS", "PARTCLS", "WAVE", "FB FM", "CHAOS", "ZLPF", "ZPKF",
+        "ZBPF", "ZHPF", "DIGI", "BOWED", "BLOWN", "FLUTED", "?"
+    };
+
+    // Voice steal policy names for display
+    const juce::StringArray stealModeNames_ = {
+        "SAME", "OLDEST", "QUIET", "RELEASED"
+    };
+
+    // Mod envelope trigger mode names for display
+    const juce::StringArray envModeNames_ = {
+        "LEGATO", "RETRIG", "VOICE"
+    };
+
+    // Mod envelope decay curve names for display
+    const juce::StringArray envCurveNames_ = {
+        "LIN", "EXP", "LOG"
     };
 
     // Dynamic labels for Timbre/Color based on current shape
     // Format: {timbreLabel, colorLabel} for each shape
-    const char* timbreLabels_[10] = {
+    const char* timbreLabels_[braids::MACRO_OSC_SHAPE_LAST] = {
         "SHAPE",    // SAW - waveshaping amount
         "MORPH",    // MORPH - triangle->saw->square->PWM
         "SAW VAR",  // SAW/SQ - variable saw shape
@@ -82,10 +151,44 @@ private:
         "SAW VAR",  // SAW+SUB - variable saw shape
         "RATIO",    // SQ SYNC - slave pitch ratio
         "RATIO",    // SAW SYNC - slave pitch ratio
-        "MOD IDX",  // FM - modulation index
+        "MOD IDX",  // FM - modulation index (feedback has its own FM FB row)
+        "DEPTH",    // FM4 - modulation depth, operator 4 feedback follows it
+        "INTRVL1",  // SAW x3 - second oscillator interval
+        "INTRVL1",  // SQ x3
+        "INTRVL1",  // TRI x3
+        "INTRVL1",  // SIN x3
+        "FREQ 2",   // RING x3 - second sine pitch
+        "SPREAD",   // SWARM - detune spread
+        "DELAY",    // COMB - comb pitch
+        "RATE",     // TOY - sample rate reduction
+        "FORMNT1",  // VOSIM - first formant
+        "CENTER",   // HARMNCS - centre harmonic
+        "BRIGHT",   // PLUCK - pluck brightness
+        "DECAY",    // BELL - decay time
+        "DECAY",    // DRUM - decay time
+        "DECAY",    // KICK - decay time
+        "NOISE",    // SNARE - noise against body
+        "CUTOFF",   // CYMBAL - high-pass cutoff
+        "RESO",     // FILT NS - resonance
+        "RESO",     // TWIN PK - resonance
+        "CHANGE",   // CLK NS - step change probability
+        "DENSITY",  // GRAINS - grain density
+        "DENSITY",  // PARTCLS - particle density
+        "POSITN",   // WAVE - position in the bank
+        "MOD IDX",  // FB FM - modulation index
+        "MOD IDX",  // CHAOS - modulation index
+        "FREQ",     // ZLPF - resonance frequency
+        "FREQ",     // ZPKF
+        "FREQ",     // ZBPF
+        "FREQ",     // ZHPF
+        "RATE",     // DIGI - symbol rate
+        "PRESS",    // BOWED - bow pressure
+        "BREATH",   // BLOWN - breath pressure
+        "JET",      // FLUTED - jet length
+        "SPEED",    // ? - Morse speed
     };
 
-    const char* colorLabels_[10] = {
+    const char* colorLabels_[braids::MACRO_OSC_SHAPE_LAST] = {
         "BRIGHT",   // SAW - brightness/DC offset
         "DRIVE",    // MORPH - lowpass filter + overdrive
         "SAW/SQ",   // SAW/SQ - crossfade saw to square
@@ -95,7 +198,41 @@ private:
         "SUB MIX",  // SAW+SUB - sub oscillator mix
         "SHAPE",    // SQ SYNC - waveshaping amount
         "SHAPE",    // SAW SYNC - waveshaping amount
-        "FEEDBK",   // FM - feedback
+        "RATIO",    // FM - modulator ratio (quantized)
+        "ALGO",     // FM4 - algorithm
+        "INTRVL2",  // SAW x3 - third oscillator interval
+        "INTRVL2",  // SQ x3
+        "INTRVL2",  // TRI x3
+        "INTRVL2",  // SIN x3
+        "FREQ 3",   // RING x3 - third sine pitch
+        "HI-PASS",  // SWARM - high-pass cutoff
+        "FEEDBK",   // COMB - feedback, negative below the middle
+        "MANGLE",   // TOY - bit mangling
+        "FORMNT2",  // VOSIM - second formant
+        "WIDTH",    // HARMNCS - width of the band
+        "SUSTAIN",  // PLUCK - string sustain
+        "BRIGHT",   // BELL - level of the upper modes
+        "BRIGHT",   // DRUM - level of the upper modes
+        "SWEEP",    // KICK - pitch sweep depth
+        "DECAY",    // SNARE - decay time
+        "NOISE",    // CYMBAL - noise mix
+        "MODE",     // FILT NS - low-pass, band-pass, high-pass
+        "PEAK 2",   // TWIN PK - second peak
+        "BITS",     // CLK NS - quantization
+        "SCATTER",  // GRAINS - pitch scatter
+        "SCATTER",  // PARTCLS - tuning scatter
+        "BRIGHT",   // WAVE - brightness (drops harmonics below the middle)
+        "FEEDBK",   // FB FM - feedback into the modulator's phase
+        "FEEDBK",   // CHAOS - feedback into the modulator's pitch
+        "RESO",     // ZLPF - resonance against the fundamental
+        "RESO",     // ZPKF
+        "RESO",     // ZBPF
+        "RESO",     // ZHPF
+        "DATA",     // DIGI - the byte sent
+        "BRIGHT",   // BOWED - string brightness
+        "STIFF",    // BLOWN - reed stiffness
+        "NOISE",    // FLUTED - breath noise
+        "TONE",     // ? - sine to square
     };
 
     // Get dynamic label for a row
@@ -5,8 +5,26 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "dsp/moog_filter.h"
+#include <cstring>
 
 namespace {
+    // Drawn LFO shapes are saved as space-separated values
+    juce::String floatsToString(const std::vector<float>& values)
+    {
+        juce::StringArray parts;
+        for (float value : values)
+            parts.add(juce::String(value, 4));
+        return parts.joinIntoString(" ");
+    }
+
+    std::vector<float> stringToFloats(const juce::String& text)
+    {
+        std::vector<float> values;
+        for (const auto& part : juce::StringArray::fromTokens(text, " ", ""))
+            values.push_back(part.getFloatValue());
+        return values;
+    }
+
     const juce::StringArray shapeNames = {
         "Saw",              // CSAW
         "Morph",            // MORPH
@@ -17,15 +35,67 @@ namespace {
         "Saw+Sub",          // SAW_SUB
         "Square Sync",      // SQUARE_SYNC
         "Saw Sync",         // SAW_SYNC
-        "FM"                // FM
+        "FM",               // FM
+        "FM 4-Op",          // FM4
+        "Triple Saw",       // TRIPLE_SAW
+        "Triple Square",    // TRIPLE_SQUARE
+        "Triple Triangle",  // TRIPLE_TRIANGLE
+        "Triple Sine",      // TRIPLE_SINE
+        "Triple Ring Mod",  // TRIPLE_RING_MOD
+        "Saw Swarm",        // SAW_SWARM
+        "Saw Comb",         // SAW_COMB
+        "Toy",              // TOY
+        "VOSIM",            // VOSIM
+        "Harmonics",        // HARMONICS
+        "Plucked",          // PLUCKED
+        "Bell",             // STRUCK_BELL
+        "Drum",             // STRUCK_DRUM
+        "Kick",             // KICK
+        "Snare",            // SNARE
+        "Cymbal",           // CYMBAL
+        "Filtered Noise",   // FILTERED_NOISE
+        "Twin Peaks",       // TWIN_PEAKS_NOISE
+        "Clocked Noise",    // CLOCKED_NOISE
+        "Granular Cloud",   // GRANULAR_CLOUD
+        "Particles",        // PARTICLE_NOISE
+        "Wavetable",        // WAVETABLE
+        "Feedback FM",      // FEEDBACK_FM
+        "Chaotic FM",       // CHAOTIC_FEEDBACK_FM
+        "Z Low-pass",       // ZLPF
+        "Z Peak",           // ZPKF
+        "Z Band-pass",      // ZBPF
+        "Z High-pass",      // ZHPF
+        "Digital Mod",      // DIGITAL_MODULATION
+        "Bowed",            // BOWED
+        "Blown",            // BLOWN
+        "Fluted",           // FLUTED
+        "Question Mark"     // QUESTION_MARK
+    };
+
+    const juce::StringArray stealModeNames = {
+        "Same Note", "Oldest", "Quietest", "Released"
     };
 
     const juce::StringArray lfoRateNames = {
-        "1/16", "1/16T", "1/8", "1/8T", "1/4", "1/4T", "1/2", "1", "2", "4"
+        "1/16", "1/16T", "1/8", "1/8T", "1/4", "1/4T", "1/2", "1", "2", "4",
+        "0.1 Hz", "0.25 Hz", "0.5 Hz", "1 Hz", "2 Hz", "5 Hz", "10 Hz", "20 Hz"
     };
 
+    // LfoShape::User is left out until the editor can draw it
     const juce::StringArray lfoShapeNames = {
-        "TRI", "SAW", "SQR", "S&H"
+        "TRI", "SAW", "SQR", "S&H", "SINE", "SMOOTH", "EXP"
+    };
+
+    const juce::StringArray envModeNames = {
+        "Legato", "Retrigger", "Per Voice"
+    };
+
+    const juce::StringArray envCurveNames = {
+        "Linear", "Exponential", "Logarithmic"
+    };
+
+    const juce::StringArray voiceModDestNames = {
+        "TIMBRE", "COLOR", "CUTOFF"
     };
 
     const juce::StringArray modDestNames = {
@@ -39,8 +109,10 @@ BraidsVSTProcessor::BraidsVSTProcessor()
     , presetManager_(*this)
 {
     // Create main synth parameters
+    // Shape version 2: the list grew from 10 shapes, so host automation
+    // recorded against version 1 maps to other shapes
     addParameter(shapeParam_ = new juce::AudioParameterChoice(
-        juce::ParameterID("shape", 1),
+        juce::ParameterID("shape", 2),
         "Shape",
         shapeNames,
         9  // Default to FM
@@ -76,10 +148,19 @@ BraidsVSTProcessor::BraidsVSTProcessor()
         0.095f  // ~200ms default: (200-10)/1990 = 0.095
     ));
 
+    // Version 2: the range grew from 1-16 to 1-128, so host automation
+    // recorded against version 1 maps to other voice counts
     addParameter(polyphonyParam_ = new juce::AudioParameterInt(
-        juce::ParameterID("polyphony", 1),
+        juce::ParameterID("polyphony", 2),
         "Polyphony",
-        1, 16, 8  // min, max, default
+        1, static_cast<int>(VoiceAllocator::kMaxVoices), 8  // min, max, default
+    ));
+
+    addParameter(stealModeParam_ = new juce::AudioParameterChoice(
+        juce::ParameterID("steal_mode", 1),
+        "Voice Steal",
+        stealModeNames,
+        0  // Default to same-note reuse
     ));
 
     // Filter parameters
@@ -209,8 +290,98 @@ BraidsVSTProcessor::BraidsVSTProcessor()
         -64, 63, 0  // Bipolar, default off
     ));
 
-    voiceAllocator_.Init(44100.0, 8);
+    // When ENV1/ENV2 fire; per voice, each note also gets its own pair
+    addParameter(envModeParam_ = new juce::AudioParameterChoice(
+        juce::ParameterID("env_mode", 1),
+        "ENV Trigger",
+        envModeNames,
+        0  // Legato
+    ));
+
+    // Decay curve of ENV1/ENV2
+    addParameter(envCurveParam_ = new juce::AudioParameterChoice(
+        juce::ParameterID("env_curve", 1),
+        "ENV Curve",
+        envCurveNames,
+        1  // Exponential
+    ));
+
+    // Per-voice modulation (velocity and amp envelope of each voice)
+    addParameter(velDestParam_ = new juce::AudioParameterChoice(
+        juce::ParameterID("vel_dest", 1),
+        "Velocity Dest",
+        voiceModDestNames,
+        0  // Default to TIMBRE
+    ));
+
+    addParameter(velAmountParam_ = new juce::AudioParameterInt(
+        juce::ParameterID("vel_amount", 1),
+        "Velocity Amount",
+        -64, 63, 0  // Bipolar, default off
+    ));
+
+    addParameter(aenvDestParam_ = new juce::AudioParameterChoice(
+        juce::ParameterID("aenv_dest", 1),
+        "Amp Env Dest",
+        voiceModDestNames,
+        1  // Default to COLOR
+    ));
+
+    addParameter(aenvAmountParam_ = new juce::AudioParameterInt(
+        juce::ParameterID("aenv_amount", 1),
+        "Amp Env Amount",
+        -64, 63, 0  // Bipolar, default off
+    ));
+
+    addParameter(pressDestParam_ = new juce::AudioParameterChoice(
+        juce::ParameterID("press_dest", 1),
+        "Pressure Dest",
+        voiceModDestNames,
+        1  // Default to COLOR
+    ));
+
+    addParameter(pressAmountParam_ = new juce::AudioParameterInt(
+        juce::ParameterID("press_amount", 1),
+        "Pressure Amount",
+        -64, 63, 0  // Off until chosen, so plain aftertouch and CC74 change nothing
+    ));
+
+    addParameter(slideDestParam_ = new juce::AudioParameterChoice(
+        juce::ParameterID("slide_dest", 1),
+        "Slide Dest",
+        voiceModDestNames,
+        0  // Default to TIMBRE
+    ));
+
+    addParameter(slideAmountParam_ = new juce::AudioParameterInt(
+        juce::ParameterID("slide_amount", 1),
+        "Slide Amount",
+        -64, 63, 0  // Off until chosen, so plain aftertouch and CC74 change nothing
+    ));
+
+    // MPE: notes on member channels get their own bend, pressure and slide
+    addParameter(mpeParam_ = new juce::AudioParameterBool(
+        juce::ParameterID("mpe", 1),
+        "MPE",
+        false
+    ));
+
+    // FM modulator self-feedback, off so older patches sound as they did.
+    // Added last so hosts that address parameters by index keep their map
+    addParameter(fmFeedbackParam_ = new juce::AudioParameterFloat(
+        juce::ParameterID("fm_feedback", 1),
+        "FM Feedback",
+        juce::NormalisableRange<float>(0.0f, 1.0f),
+        0.0f
+    ));
+
+    // Each new instance gets its own seed; a saved state brings its seed back
+    randomSeed_ = static_cast<uint32_t>(juce::Random::getSystemRandom().nextInt());
+    voiceAllocator_.Seed(randomSeed_);
+    voiceAllocator_.Init(44100.0, 8, voicePoolSize_, renderAtHostRate_);
+    resetMidiState();
     modMatrix_.Init();
+    modMatrix_.Seed(randomSeed_);
     filter_.Init(44100.0f);
 
     // Initialize preset manager after parameters are created
@@ -222,15 +393,94 @@ BraidsVSTProcessor::~BraidsVSTProcessor() = default;
 void BraidsVSTProcessor::prepareToPlay(double sampleRate, int /*samplesPerBlock*/)
 {
     hostSampleRate_ = sampleRate;
-    voiceAllocator_.Init(sampleRate, polyphonyParam_->get());
+    voiceAllocator_.Init(sampleRate, polyphonyParam_->get(), voicePoolSize_, renderAtHostRate_);
+    resetMidiState();
     modMatrix_.Init();
+    modMatrix_.Seed(randomSeed_);
     filter_.Init(static_cast<float>(sampleRate));
 }
 
+void BraidsVSTProcessor::setLfoUserShape(int lfo, const std::vector<float>& points)
+{
+    if (points.size() < 2) {
+        return;
+    }
+    lfoUserShapes_[lfo & 1] = points;
+
+    // The table is read by the audio thread
+    suspendProcessing(true);
+    auto& target = (lfo & 1) ? modMatrix_.GetLfo2() : modMatrix_.GetLfo1();
+    target.SetUserShape(points.data(), points.size());
+    suspendProcessing(false);
+}
+
+void BraidsVSTProcessor::setRandomSeed(uint32_t seed)
+{
+    if (seed == randomSeed_) {
+        return;
+    }
+    randomSeed_ = seed;
+
+    // Generators are audio thread state
+    suspendProcessing(true);
+    voiceAllocator_.Seed(seed);
+    modMatrix_.Seed(seed);
+    suspendProcessing(false);
+}
+
 void BraidsVSTProcessor::releaseResources()
 {
 }
 
+void BraidsVSTProcessor::setVoicePoolSize(int size)
+{
+    size = juce::jlimit(1, static_cast<int>(VoiceAllocator::kMaxVoices), size);
+    if (size == voicePoolSize_) {
+        return;
+    }
+    voicePoolSize_ = size;
+
+    // Reallocating the pool must not race the audio callback
+    suspendProcessing(true);
+    voiceAllocator_.Init(hostSampleRate_, polyphonyParam_->get(), voicePoolSize_, renderAtHostRate_);
+    resetMidiState();
+    suspendProcessing(false);
+}
+
+void BraidsVSTProcessor::setRenderAtHostRate(bool hostRate)
+{
+    if (hostRate == renderAtHostRate_) {
+        return;
+    }
+    renderAtHostRate_ = hostRate;
+
+    // Voices re-init their envelopes and resamplers for the new render rate
+    suspendProcessing(true);
+    voiceAllocator_.Init(hostSampleRate_, polyphonyParam_->get(), voicePoolSize_, renderAtHostRate_);
+    resetMidiState();
+    suspendProcessing(false);
+}
+
+bool BraidsVSTProcessor::loadWavetable(const juce::File& file)
+{
+    auto bank = braids::WavetableBank::Load(file.getFullPathName().toStdString());
+    if (!bank) {
+        return false;
+    }
+
+    // The voices must not be reading the old bank when it goes
+    suspendProcessing(true);
+    voiceAllocator_.set_wavetable(bank.get());
+    wavetable_.swap(bank);
+    suspendProcessing(false);
+    return true;
+}
+
+juce::File BraidsVSTProcessor::getWavetableFile() const
+{
+    return wavetable_ ? juce::File(juce::String(wavetable_->path())) : juce::File();
+}
+
 void BraidsVSTProcessor::updateModulationParams()
 {
     // Update LFO1
@@ -245,55 +495,169 @@ void BraidsVSTProcessor::updateModulationParams()
     modMatrix_.SetDestination(braids::ModSource::Lfo2, static_cast<braids::ModDestination>(lfo2DestParam_->getIndex()));
     modMatrix_.SetAmount(braids::ModSource::Lfo2, static_cast<int8_t>(lfo2AmountParam_->get()));
 
-    // Update ENV1
-    uint16_t env1Attack = static_cast<uint16_t>(env1AttackParam_->get() * 500.0f);
-    uint16_t env1Decay = static_cast<uint16_t>(10.0f + env1DecayParam_->get() * 1990.0f);
-    modMatrix_.GetEnv1().SetAttack(env1Attack);
-    modMatrix_.GetEnv1().SetDecay(env1Decay);
-    modMatrix_.SetDestination(braids::ModSource::Env1, static_cast<braids::ModDestination>(env1DestParam_->getIndex()));
-    modMatrix_.SetAmount(braids::ModSource::Env1, static_cast<int8_t>(env1AmountParam_->get()));
-
-    // Update ENV2
-    uint16_t env2Attack = static_cast<uint16_t>(env2AttackParam_->get() * 500.0f);
-    uint16_t env2Decay = static_cast<uint16_t>(10.0f + env2DecayParam_->get() * 1990.0f);
-    modMatrix_.GetEnv2().SetAttack(env2Attack);
-    modMatrix_.GetEnv2().SetDecay(env2Decay);
-    modMatrix_.SetDestination(braids::ModSource::Env2, static_cast<braids::ModDestination>(env2DestParam_->getIndex()));
-    modMatrix_.SetAmount(braids::ModSource::Env2, static_cast<int8_t>(env2AmountParam_->get()));
+    // Per voice, ENV1/ENV2 aimed at timbre, colour or cutoff follow each
+    // voice's own envelope instead of the global one. The LFO and
+    // resonance destinations are global and stay on the matrix
+    const bool perVoice = static_cast<braids::ModEnvelopeMode>(envModeParam_->getIndex())
+        == braids::ModEnvelopeMode::PerVoice;
+    const auto curve = static_cast<braids::ModEnvelopeCurve>(envCurveParam_->getIndex());
+    auto& voiceMod = voiceAllocator_.modulation();
+    auto updateEnvelope = [&](int k, juce::AudioParameterFloat* attackParam,
+                              juce::AudioParameterFloat* decayParam,
+                              juce::AudioParameterChoice* destParam,
+                              juce::AudioParameterInt* amountParam) {
+        const braids::ModSource source = k == 0 ? braids::ModSource::Env1 : braids::ModSource::Env2;
+        const VoiceModSource voiceSource = k == 0 ? VoiceModSource::ModEnv1 : VoiceModSource::ModEnv2;
+        uint16_t attack = static_cast<uint16_t>(attackParam->get() * 500.0f);
+        uint16_t decay = static_cast<uint16_t>(10.0f + decayParam->get() * 1990.0f);
+        int dest = destParam->getIndex();
+        int8_t amount = static_cast<int8_t>(amountParam->get());
+        bool voiceDest = perVoice && dest < static_cast<int>(VoiceModDestination::NumDestinations);
+
+        braids::ModEnvelope& envelope = k == 0 ? modMatrix_.GetEnv1() : modMatrix_.GetEnv2();
+        envelope.SetAttack(attack);
+        envelope.SetDecay(decay);
+        envelope.SetCurve(curve);
+        modMatrix_.SetDestination(source, static_cast<braids::ModDestination>(dest));
+        modMatrix_.SetAmount(source, voiceDest ? 0 : amount);
+
+        voiceAllocator_.modEnvelopes(k).SetAttack(attack);
+        voiceAllocator_.modEnvelopes(k).SetDecay(decay);
+        voiceAllocator_.modEnvelopes(k).SetCurve(curve);
+        if (voiceDest) {
+            voiceMod.SetDestination(voiceSource, static_cast<VoiceModDestination>(dest));
+        }
+        voiceMod.SetAmount(voiceSource, voiceDest ? amount : 0);
+    };
+    updateEnvelope(0, env1AttackParam_, env1DecayParam_, env1DestParam_, env1AmountParam_);
+    updateEnvelope(1, env2AttackParam_, env2DecayParam_, env2DestParam_, env2AmountParam_);
+
+    // Per-voice routing
+    voiceMod.SetDestination(VoiceModSource::Velocity, static_cast<VoiceModDestination>(velDestParam_->getIndex()));
+    voiceMod.SetAmount(VoiceModSource::Velocity, static_cast<int8_t>(velAmountParam_->get()));
+    voiceMod.SetDestination(VoiceModSource::Envelope, static_cast<VoiceModDestination>(aenvDestParam_->getIndex()));
+    voiceMod.SetAmount(VoiceModSource::Envelope, static_cast<int8_t>(aenvAmountParam_->get()));
+    voiceMod.SetDestination(VoiceModSource::Pressure, static_cast<VoiceModDestination>(pressDestParam_->getIndex()));
+    voiceMod.SetAmount(VoiceModSource::Pressure, static_cast<int8_t>(pressAmountParam_->get()));
+    voiceMod.SetDestination(VoiceModSource::Slide, static_cast<VoiceModDestination>(slideDestParam_->getIndex()));
+    voiceMod.SetAmount(VoiceModSource::Slide, static_cast<int8_t>(slideAmountParam_->get()));
+}
+
+void BraidsVSTProcessor::resetMidiState()
+{
+    mpeEnabled_ = mpeParam_->get();
+    voiceAllocator_.setMpeZones(mpeEnabled_ ? mpeLowerMembers_ : 0,
+                                mpeEnabled_ ? mpeUpperMembers_ : 0);
+    voiceAllocator_.resetExpression();
+
+    // MPE defaults: +/-48 semitones on member channels, +/-2 elsewhere
+    for (int ch = 0; ch < kNumMidiChannels; ++ch) {
+        bool member = voiceAllocator_.mpeMaster(ch) != ch;
+        pitchBendRange_[ch] = member ? 48.0f : 2.0f;
+        rpn_[ch] = kNullRpn;
+    }
+}
+
+void BraidsVSTProcessor::handleRpn(int channel, int rpn, int value)
+{
+    if (rpn == 0) {
+        // Pitch bend sensitivity. Under MPE, setting it on any member channel
+        // sets it for the whole zone
+        int master = voiceAllocator_.mpeMaster(channel);
+        for (int ch = 0; ch < kNumMidiChannels; ++ch) {
+            bool sameZone = master != channel && voiceAllocator_.mpeMaster(ch) == master && ch != master;
+            if (ch == channel || sameZone) {
+                pitchBendRange_[ch] = static_cast<float>(value);
+            }
+        }
+    } else if (rpn == 6 && (channel == 0 || channel == kNumMidiChannels - 1)) {
+        // MPE Configuration Message: member channel count for the zone whose
+        // master sent it
+        if (channel == 0) {
+            mpeLowerMembers_ = value;
+            mpeLowerShared_.store(value);
+        } else {
+            mpeUpperMembers_ = value;
+            mpeUpperShared_.store(value);
+        }
+        if (mpeEnabled_) {
+            resetMidiState();
+        }
+    }
 }
 
 void BraidsVSTProcessor::handleMidiMessage(const juce::MidiMessage& msg)
 {
+    const int channel = msg.getChannel() - 1;
+
     if (msg.isNoteOn())
     {
-        // Check if this is the first note (for envelope triggering)
-        int prevActiveCount = activeVoiceCount_;
+        // The allocator's count is the one source of truth for silence
+        const bool wasSilent = voiceAllocator_.activeVoiceCount() == 0;
 
         // Convert normalized parameters to actual milliseconds, then to uint16_t
         float attackMs = attackParam_->get() * 500.0f;
         float decayMs = 10.0f + decayParam_->get() * 1990.0f;
         uint16_t attack = static_cast<uint16_t>(attackMs);
         uint16_t decay = static_cast<uint16_t>(decayMs);
-        voiceAllocator_.NoteOn(msg.getNoteNumber(), msg.getFloatVelocity(), attack, decay);
-
-        activeVoiceCount_++;
-
-        // Trigger mod envelopes on first note after silence
-        if (prevActiveCount == 0) {
+        voiceAllocator_.NoteOn(msg.getNoteNumber(), msg.getFloatVelocity(), attack, decay, channel);
+
+        // Legato fires the mod envelopes on the first note after silence.
+        // Otherwise every note does (per voice, the voice's own pair has
+        // been triggered by the allocator; these serve the global
+        // destinations)
+        auto mode = static_cast<braids::ModEnvelopeMode>(envModeParam_->getIndex());
+        if (wasSilent || mode != braids::ModEnvelopeMode::Legato) {
             modMatrix_.TriggerEnvelopes();
         }
     }
     else if (msg.isNoteOff())
     {
-        voiceAllocator_.NoteOff(msg.getNoteNumber());
-        if (activeVoiceCount_ > 0) {
-            activeVoiceCount_--;
-        }
+        voiceAllocator_.NoteOff(msg.getNoteNumber(), channel);
     }
     else if (msg.isAllNotesOff() || msg.isAllSoundOff())
     {
         voiceAllocator_.AllNotesOff();
-        activeVoiceCount_ = 0;
+    }
+    else if (msg.isPitchWheel())
+    {
+        float bend = static_cast<float>(msg.getPitchWheelValue() - 8192) / 8192.0f;
+        voiceAllocator_.setPitchBend(channel, bend * pitchBendRange_[channel]);
+    }
+    else if (msg.isChannelPressure())
+    {
+        voiceAllocator_.setPressure(channel, static_cast<float>(msg.getChannelPressureValue()) / 127.0f);
+    }
+    else if (msg.isController())
+    {
+        const int value = msg.getControllerValue();
+        switch (msg.getControllerNumber()) {
+            case 74:  // MPE slide / brightness
+                voiceAllocator_.setSlide(channel, static_cast<float>(value) / 127.0f);
+                break;
+            case 101:  // RPN MSB
+                rpn_[channel] = (value << 7) | (rpn_[channel] & 0x7f);
+                break;
+            case 100:  // RPN LSB
+                rpn_[channel] = (rpn_[channel] & (0x7f << 7)) | value;
+                break;
+            case 98:   // NRPN selected - data entry no longer targets an RPN
+            case 99:
+                rpn_[channel] = kNullRpn;
+                break;
+            case 6:    // Data entry MSB
+                if (rpn_[channel] != kNullRpn) {
+                    handleRpn(channel, rpn_[channel], value);
+                }
+                break;
+            case 121:  // Reset all controllers
+                voiceAllocator_.setPitchBend(channel, 0.0f);
+                voiceAllocator_.setPressure(channel, 0.0f);
+                voiceAllocator_.setSlide(channel, 0.0f);
+                break;
+            default:
+                break;
+        }
     }
 }
 
@@ -326,6 +690,16 @@ void BraidsVSTProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // Switching MPE on or off, or a restored zone layout, changes how
+    // channels are interpreted
+    if (mpeLayoutChanged_.exchange(false)) {
+        mpeLowerMembers_ = mpeLowerShared_.load();
+        mpeUpperMembers_ = mpeUpperShared_.load();
+        resetMidiState();
+    } else if (mpeParam_->get() != mpeEnabled_) {
+        resetMidiState();
+    }
+
     // Handle MIDI messages
     for (const auto metadata : midiMessages)
     {
@@ -334,72 +708,84 @@ void BraidsVSTProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 
     // Update polyphony if changed
     voiceAllocator_.setPolyphony(polyphonyParam_->get());
+    voiceAllocator_.setStealPolicy(static_cast<VoiceStealPolicy>(stealModeParam_->getIndex()));
 
     // Update modulation parameters from UI
     updateModulationParams();
 
-    // Get host tempo if available, otherwise use default 120 BPM
+    // Get host tempo if available, otherwise use default 120 BPM. While the
+    // transport plays the LFOs follow the song position, otherwise they
+    // free-run from wherever they are
     double tempo = 120.0;
     if (auto* playHead = getPlayHead()) {
         if (auto position = playHead->getPosition()) {
             if (auto bpm = position->getBpm()) {
                 tempo = *bpm;
             }
+            if (position->getIsPlaying()) {
+                if (auto ppq = position->getPpqPosition()) {
+                    modMatrix_.SyncToBeat(*ppq);
+                }
+            }
         }
     }
     modMatrix_.SetTempo(tempo);
 
-    // Process modulation matrix
-    const int numSamples = buffer.getNumSamples();
-    modMatrix_.Process(static_cast<float>(hostSampleRate_), numSamples);
-
-    // Update shared parameters with modulation applied
     int shapeIndex = shapeParam_->getIndex();
     voiceAllocator_.set_shape(static_cast<braids::MacroOscillatorShape>(shapeIndex));
-
-    // Apply modulation to timbre and color
-    float modulatedTimbre = getModulatedTimbre();
-    float modulatedColor = getModulatedColor();
-
-    int16_t timbre = static_cast<int16_t>(modulatedTimbre * 32767.0f);
-    int16_t color = static_cast<int16_t>(modulatedColor * 32767.0f);
-    voiceAllocator_.set_parameters(timbre, color);
+    voiceAllocator_.set_fm_feedback(static_cast<int16_t>(fmFeedbackParam_->get() * 32767.0f));
 
     // Get output pointers
+    const int numSamples = buffer.getNumSamples();
     auto* leftChannel = buffer.getWritePointer(0);
     auto* rightChannel = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : nullptr;
-
-    // Process all voices
-    if (rightChannel) {
-        voiceAllocator_.Process(leftChannel, rightChannel, static_cast<size_t>(numSamples));
-    } else {
+    float tempRight[2048];
+    size_t total = static_cast<size_t>(numSamples);
+    if (!rightChannel) {
         // Mono output
-        float tempRight[2048];
-        size_t samples = std::min(static_cast<size_t>(numSamples), sizeof(tempRight) / sizeof(float));
-        voiceAllocator_.Process(leftChannel, tempRight, samples);
+        total = std::min(total, sizeof(tempRight) / sizeof(float));
     }
 
-    // Update and apply filter with modulation
-    float modulatedCutoff = getModulatedCutoff();
-    float modulatedResonance = getModulatedResonance();
-
-    // Convert normalized cutoff (0-1) to Hz (20-20000 using exponential scaling)
-    float cutoffHz = 20.0f * std::pow(1000.0f, modulatedCutoff);
-    filter_.SetCutoff(cutoffHz);
-    filter_.SetResonance(modulatedResonance);
-
-    // Apply filter to output (mono filter applied to both channels)
-    for (int i = 0; i < numSamples; ++i) {
-        // Mix L+R, filter, then split back (simple mono filter approach)
-        float mono = leftChannel[i];
-        if (rightChannel) {
-            mono = (leftChannel[i] + rightChannel[i]) * 0.5f;
-        }
-        float filtered = filter_.Process(mono);
-        leftChannel[i] = filtered;
-        if (rightChannel) {
-            rightChannel[i] = filtered;
+    // Modulation runs once per control tick rather than once per host
+    // block, so fast LFOs don't step at the host's block size
+    for (size_t offset = 0; offset < total; offset += VoiceAllocator::kControlBlockSize) {
+        const size_t tick = std::min(VoiceAllocator::kControlBlockSize, total - offset);
+        modMatrix_.Process(static_cast<float>(hostSampleRate_), static_cast<int>(tick));
+
+        // Apply modulation to timbre and color
+        float modulatedTimbre = getModulatedTimbre();
+        float modulatedColor = getModulatedColor();
+
+        int16_t timbre = static_cast<int16_t>(modulatedTimbre * 32767.0f);
+        int16_t color = static_cast<int16_t>(modulatedColor * 32767.0f);
+        voiceAllocator_.set_parameters(timbre, color);
+
+        float* left = leftChannel + offset;
+        voiceAllocator_.Process(left, rightChannel ? rightChannel + offset : tempRight, tick);
+
+        // Update and apply filter with modulation (global + loudest per-voice request)
+        float modulatedCutoff = juce::jlimit(0.0f, 1.0f,
+            getModulatedCutoff() + voiceAllocator_.cutoffModulation());
+        float modulatedResonance = getModulatedResonance();
+
+        samplesSinceSnapshot_ += static_cast<int>(tick);
+        if (samplesSinceSnapshot_ * kModulationSnapshotRateHz >= static_cast<int>(hostSampleRate_)) {
+            samplesSinceSnapshot_ = 0;
+            modSnapshots_.Push({ modulatedTimbre, modulatedColor, modulatedCutoff, modulatedResonance });
         }
+
+        // Convert normalized cutoff (0-1) to Hz (20-20000 using exponential scaling)
+        float cutoffHz = 20.0f * std::pow(1000.0f, modulatedCutoff);
+        filter_.SetCutoff(cutoffHz);
+        filter_.SetResonance(modulatedResonance);
+
+        // Apply filter to output. Voices are mono (the allocator copies left
+        // to right), so filter the left channel and copy it across below
+        filter_.Process(left, tick);
+    }
+
+    if (rightChannel) {
+        std::memcpy(rightChannel, leftChannel, static_cast<size_t>(numSamples) * sizeof(float));
     }
 }
 
@@ -416,23 +802,32 @@ void BraidsVSTProcessor::getStateInformation(juce::MemoryBlock& destData)
     state.setProperty("shape", shapeParam_->getIndex(), nullptr);
     state.setProperty("timbre", timbreParam_->get(), nullptr);
     state.setProperty("color", colorParam_->get(), nullptr);
+    state.setProperty("fm_feedback", fmFeedbackParam_->get(), nullptr);
     state.setProperty("attack", attackParam_->get(), nullptr);
     state.setProperty("decay", decayParam_->get(), nullptr);
     state.setProperty("polyphony", polyphonyParam_->get(), nullptr);
+    state.setProperty("steal_mode", stealModeParam_->getIndex(), nullptr);
+    state.setProperty("voice_pool", voicePoolSize_, nullptr);
+    state.setProperty("host_rate_render", renderAtHostRate_, nullptr);
     state.setProperty("cutoff", cutoffParam_->get(), nullptr);
     state.setProperty("resonance", resonanceParam_->get(), nullptr);
+    if (wavetable_)
+        state.setProperty("wavetable", juce::String(wavetable_->path()), nullptr);
+    state.setProperty("seed", static_cast<juce::int64>(randomSeed_), nullptr);
 
     // LFO1
     state.setProperty("lfo1_rate", lfo1RateParam_->getIndex(), nullptr);
     state.setProperty("lfo1_shape", lfo1ShapeParam_->getIndex(), nullptr);
     state.setProperty("lfo1_dest", lfo1DestParam_->getIndex(), nullptr);
     state.setProperty("lfo1_amount", lfo1AmountParam_->get(), nullptr);
+    state.setProperty("lfo1_user", floatsToString(lfoUserShapes_[0]), nullptr);
 
     // LFO2
     state.setProperty("lfo2_rate", lfo2RateParam_->getIndex(), nullptr);
     state.setProperty("lfo2_shape", lfo2ShapeParam_->getIndex(), nullptr);
     state.setProperty("lfo2_dest", lfo2DestParam_->getIndex(), nullptr);
     state.setProperty("lfo2_amount", lfo2AmountParam_->get(), nullptr);
+    state.setProperty("lfo2_user", floatsToString(lfoUserShapes_[1]), nullptr);
 
     // ENV1
     state.setProperty("env1_attack", env1AttackParam_->get(), nullptr);
@@ -445,6 +840,23 @@ void BraidsVSTProcessor::getStateInformation(juce::MemoryBlock& destData)
     state.setProperty("env2_decay", env2DecayParam_->get(), nullptr);
     state.setProperty("env2_dest", env2DestParam_->getIndex(), nullptr);
     state.setProperty("env2_amount", env2AmountParam_->get(), nullptr);
+    state.setProperty("env_mode", envModeParam_->getIndex(), nullptr);
+    state.setProperty("env_curve", envCurveParam_->getIndex(), nullptr);
+
+    // Per-voice modulation
+    state.setProperty("vel_dest", velDestParam_->getIndex(), nullptr);
+    state.setProperty("vel_amount", velAmountParam_->get(), nullptr);
+    state.setProperty("aenv_dest", aenvDestParam_->getIndex(), nullptr);
+    state.setProperty("aenv_amount", aenvAmountParam_->get(), nullptr);
+    state.setProperty("press_dest", pressDestParam_->getIndex(), nullptr);
+    state.setProperty("press_amount", pressAmountParam_->get(), nullptr);
+    state.setProperty("slide_dest", slideDestParam_->getIndex(), nullptr);
+    state.setProperty("slide_amount", slideAmountParam_->get(), nullptr);
+
+    // MPE
+    state.setProperty("mpe", mpeParam_->get(), nullptr);
+    state.setProperty("mpe_lower", mpeLowerShared_.load(), nullptr);
+    state.setProperty("mpe_upper", mpeUpperShared_.load(), nullptr);
 
     juce::MemoryOutputStream stream(destData, false);
     state.writeToStream(stream);
@@ -462,16 +874,28 @@ void BraidsVSTProcessor::setStateInformation(const void* data, int sizeInBytes)
             *timbreParam_ = static_cast<float>(state.getProperty("timbre"));
         if (state.hasProperty("color"))
             *colorParam_ = static_cast<float>(state.getProperty("color"));
+        if (state.hasProperty("fm_feedback"))
+            *fmFeedbackParam_ = static_cast<float>(state.getProperty("fm_feedback"));
         if (state.hasProperty("attack"))
             *attackParam_ = static_cast<float>(state.getProperty("attack"));
         if (state.hasProperty("decay"))
             *decayParam_ = static_cast<float>(state.getProperty("decay"));
         if (state.hasProperty("polyphony"))
             *polyphonyParam_ = static_cast<int>(state.getProperty("polyphony"));
+        if (state.hasProperty("steal_mode"))
+            *stealModeParam_ = static_cast<int>(state.getProperty("steal_mode"));
+        if (state.hasProperty("voice_pool"))
+            setVoicePoolSize(static_cast<int>(state.getProperty("voice_pool")));
+        if (state.hasProperty("host_rate_render"))
+            setRenderAtHostRate(static_cast<bool>(state.getProperty("host_rate_render")));
         if (state.hasProperty("cutoff"))
             *cutoffParam_ = static_cast<float>(state.getProperty("cutoff"));
         if (state.hasProperty("resonance"))
             *resonanceParam_ = static_cast<float>(state.getProperty("resonance"));
+        if (state.hasProperty("wavetable"))
+            loadWavetable(juce::File(state.getProperty("wavetable").toString()));
+        if (state.hasProperty("seed"))
+            setRandomSeed(static_cast<uint32_t>(static_cast<juce::int64>(state.getProperty("seed"))));
 
         // LFO1
         if (state.hasProperty("lfo1_rate"))
@@ -482,6 +906,8 @@ void BraidsVSTProcessor::setStateInformation(const void* data, int sizeInBytes)
             *lfo1DestParam_ = static_cast<int>(state.getProperty("lfo1_dest"));
         if (state.hasProperty("lfo1_amount"))
             *lfo1AmountParam_ = static_cast<int>(state.getProperty("lfo1_amount"));
+        if (state.hasProperty("lfo1_user"))
+            setLfoUserShape(0, stringToFloats(state.getProperty("lfo1_user").toString()));
 
         // LFO2
         if (state.hasProperty("lfo2_rate"))
@@ -492,6 +918,8 @@ void BraidsVSTProcessor::setStateInformation(const void* data, int sizeInBytes)
             *lfo2DestParam_ = static_cast<int>(state.getProperty("lfo2_dest"));
         if (state.hasProperty("lfo2_amount"))
             *lfo2AmountParam_ = static_cast<int>(state.getProperty("lfo2_amount"));
+        if (state.hasProperty("lfo2_user"))
+            setLfoUserShape(1, stringToFloats(state.getProperty("lfo2_user").toString()));
 
         // ENV1
         if (state.hasProperty("env1_attack"))
@@ -512,6 +940,37 @@ void BraidsVSTProcessor::setStateInformation(const void* data, int sizeInBytes)
             *env2DestParam_ = static_cast<int>(state.getProperty("env2_dest"));
         if (state.hasProperty("env2_amount"))
             *env2AmountParam_ = static_cast<int>(state.getProperty("env2_amount"));
+        if (state.hasProperty("env_mode"))
+            *envModeParam_ = static_cast<int>(state.getProperty("env_mode"));
+        if (state.hasProperty("env_curve"))
+            *envCurveParam_ = static_cast<int>(state.getProperty("env_curve"));
+
+        // Per-voice modulation
+        if (state.hasProperty("vel_dest"))
+            *velDestParam_ = static_cast<int>(state.getProperty("vel_dest"));
+        if (state.hasProperty("vel_amount"))
+            *velAmountParam_ = static_cast<int>(state.getProperty("vel_amount"));
+        if (state.hasProperty("aenv_dest"))
+            *aenvDestParam_ = static_cast<int>(state.getProperty("aenv_dest"));
+        if (state.hasProperty("aenv_amount"))
+            *aenvAmountParam_ = static_cast<int>(state.getProperty("aenv_amount"));
+        if (state.hasProperty("press_dest"))
+            *pressDestParam_ = static_cast<int>(state.getProperty("press_dest"));
+        if (state.hasProperty("press_amount"))
+            *pressAmountParam_ = static_cast<int>(state.getProperty("press_amount"));
+        if (state.hasProperty("slide_dest"))
+            *slideDestParam_ = static_cast<int>(state.getProperty("slide_dest"));
+        if (state.hasProperty("slide_amount"))
+            *slideAmountParam_ = static_cast<int>(state.getProperty("slide_amount"));
+
+        // MPE (zone layout is picked up on the next block)
+        if (state.hasProperty("mpe_lower"))
+            mpeLowerShared_.store(static_cast<int>(state.getProperty("mpe_lower")));
+        if (state.hasProperty("mpe_upper"))
+            mpeUpperShared_.store(static_cast<int>(state.getProperty("mpe_upper")));
+        if (state.hasProperty("mpe"))
+            *mpeParam_ = static_cast<bool>(state.getProperty("mpe"));
+        mpeLayoutChanged_ = true;
     }
 }
 
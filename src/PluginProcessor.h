@@ -4,6 +4,8 @@
 #include "dsp/voice_allocator.h"
 #include "dsp/modulation_matrix.h"
 #include "dsp/moog_filter.h"
+#include "dsp/spsc_queue.h"
+#include "dsp/braids/wavetable_bank.h"
 #include "PresetManager.h"
 
 class BraidsVSTProcessor : public juce::AudioProcessor
@@ -38,9 +40,29 @@ public:
     juce::AudioParameterChoice* getShapeParam() { return shapeParam_; }
     juce::AudioParameterFloat* getTimbreParam() { return timbreParam_; }
     juce::AudioParameterFloat* getColorParam() { return colorParam_; }
+    juce::AudioParameterFloat* getFmFeedbackParam() { return fmFeedbackParam_; }
     juce::AudioParameterFloat* getAttackParam() { return attackParam_; }
     juce::AudioParameterFloat* getDecayParam() { return decayParam_; }
     juce::AudioParameterInt* getPolyphonyParam() { return polyphonyParam_; }
+    juce::AudioParameterChoice* getStealModeParam() { return stealModeParam_; }
+
+    // Voice pool size - reallocates the pool, call from the message thread only
+    void setVoicePoolSize(int size);
+    int getVoicePoolSize() const { return voicePoolSize_; }
+
+    // Render voices at the host rate instead of 96 kHz - message thread only
+    void setRenderAtHostRate(bool hostRate);
+    bool getRenderAtHostRate() const { return renderAtHostRate_; }
+
+    // Bank for the wavetable shape. Maps the file and builds its mips here,
+    // so call from the message thread only. False if it isn't a bank
+    bool loadWavetable(const juce::File& file);
+    juce::File getWavetableFile() const;
+
+    // Seed for every random source (S&H, noise shapes), saved with the
+    // state so a bounce renders the same each time - message thread only
+    void setRandomSeed(uint32_t seed);
+    uint32_t getRandomSeed() const { return randomSeed_; }
 
     // Filter params
     juce::AudioParameterFloat* getCutoffParam() { return cutoffParam_; }
@@ -58,6 +80,11 @@ public:
     juce::AudioParameterChoice* getLfo2DestParam() { return lfo2DestParam_; }
     juce::AudioParameterInt* getLfo2AmountParam() { return lfo2AmountParam_; }
 
+    // Drawn shape for LFO 0 or 1 on the USER setting: at least two points,
+    // -1 to +1, spread evenly over a cycle - message thread only
+    void setLfoUserShape(int lfo, const std::vector<float>& points);
+    const std::vector<float>& getLfoUserShape(int lfo) const { return lfoUserShapes_[lfo & 1]; }
+
     // ENV1 params
     juce::AudioParameterFloat* getEnv1AttackParam() { return env1AttackParam_; }
     juce::AudioParameterFloat* getEnv1DecayParam() { return env1DecayParam_; }
@@ -69,15 +96,34 @@ public:
     juce::AudioParameterFloat* getEnv2DecayParam() { return env2DecayParam_; }
     juce::AudioParameterChoice* getEnv2DestParam() { return env2DestParam_; }
     juce::AudioParameterInt* getEnv2AmountParam() { return env2AmountParam_; }
-
-    // Modulation matrix access for UI visualization
-    const braids::ModulationMatrix& getModMatrix() const { return modMatrix_; }
-
-    // Get current modulated values (for UI visualization)
-    float getModulatedTimbre() const;
-    float getModulatedColor() const;
-    float getModulatedCutoff() const;
-    float getModulatedResonance() const;
+    juce::AudioParameterChoice* getEnvModeParam() { return envModeParam_; }
+    juce::AudioParameterChoice* getEnvCurveParam() { return envCurveParam_; }
+
+    // Per-voice modulation params
+    juce::AudioParameterChoice* getVelDestParam() { return velDestParam_; }
+    juce::AudioParameterInt* getVelAmountParam() { return velAmountParam_; }
+    juce::AudioParameterChoice* getAenvDestParam() { return aenvDestParam_; }
+    juce::AudioParameterInt* getAenvAmountParam() { return aenvAmountParam_; }
+    juce::AudioParameterChoice* getPressDestParam() { return pressDestParam_; }
+    juce::AudioParameterInt* getPressAmountParam() { return pressAmountParam_; }
+    juce::AudioParameterChoice* getSlideDestParam() { return slideDestParam_; }
+    juce::AudioParameterInt* getSlideAmountParam() { return slideAmountParam_; }
+    juce::AudioParameterBool* getMpeParam() { return mpeParam_; }
+
+    // Modulated values as the audio thread applied them (0-1), for UI
+    // visualization. The cutoff includes the per-voice offset
+    struct ModulationSnapshot {
+        float timbre = 0.0f;
+        float color = 0.0f;
+        float cutoff = 0.0f;
+        float resonance = 0.0f;
+    };
+    static constexpr int kModulationSnapshotRateHz = 120;
+
+    // Message thread only: takes the oldest snapshot not yet read. The audio
+    // thread pushes kModulationSnapshotRateHz a second (dropping them while
+    // the queue is full), so the UI never reads the matrix itself
+    bool popModulationSnapshot(ModulationSnapshot& snapshot) { return modSnapshots_.Pop(snapshot); }
 
     // Preset manager
     PresetManager& getPresetManager() { return presetManager_; }
@@ -85,20 +131,54 @@ public:
 private:
     void handleMidiMessage(const juce::MidiMessage& msg);
     void updateModulationParams();
+    void resetMidiState();
+    void handleRpn(int channel, int rpn, int value);
+
+    // Current modulated values (audio thread)
+    float getModulatedTimbre() const;
+    float getModulatedColor() const;
+    float getModulatedCutoff() const;
+    float getModulatedResonance() const;
 
     VoiceAllocator voiceAllocator_;
     braids::ModulationMatrix modMatrix_;
     braids::MoogFilter filter_;
     double hostSampleRate_ = 44100.0;
-    int activeVoiceCount_ = 0;  // Track active voices for envelope triggering
+    int voicePoolSize_ = static_cast<int>(VoiceAllocator::kDefaultPoolSize);
+    bool renderAtHostRate_ = false;
+    std::shared_ptr<const braids::WavetableBank> wavetable_;  // Voices hold a raw pointer
+    uint32_t randomSeed_ = 0;
+    std::vector<float> lfoUserShapes_[2] = {{-1.0f, 1.0f}, {-1.0f, 1.0f}};
+
+    // MIDI channel state (audio thread only)
+    static constexpr int kNumMidiChannels = 16;
+    static constexpr int kNullRpn = 0x3fff;
+    float pitchBendRange_[kNumMidiChannels] = {};  // Semitones
+    int rpn_[kNumMidiChannels] = {};
+    bool mpeEnabled_ = false;
+    int mpeLowerMembers_ = 15;  // Zone layout from the last MCM, used while MPE is on
+    int mpeUpperMembers_ = 0;
+
+    // The zone layout as both threads see it: the audio thread mirrors each
+    // MCM here for saving, a restored state lands here and sets
+    // mpeLayoutChanged_ for the audio thread to pick up at the next block
+    std::atomic<int> mpeLowerShared_ { 15 };
+    std::atomic<int> mpeUpperShared_ { 0 };
+    std::atomic<bool> mpeLayoutChanged_ { false };
+
+    // Audio thread to editor, about two seconds deep
+    SpscQueue<ModulationSnapshot, 256> modSnapshots_;
+    int samplesSinceSnapshot_ = 0;  // Audio thread only
 
     // Main synth parameters
     juce::AudioParameterChoice* shapeParam_ = nullptr;
     juce::AudioParameterFloat* timbreParam_ = nullptr;
     juce::AudioParameterFloat* colorParam_ = nullptr;
+    juce::AudioParameterFloat* fmFeedbackParam_ = nullptr;
     juce::AudioParameterFloat* attackParam_ = nullptr;
     juce::AudioParameterFloat* decayParam_ = nullptr;
     juce::AudioParameterInt* polyphonyParam_ = nullptr;
+    juce::AudioParameterChoice* stealModeParam_ = nullptr;
 
     // Filter parameters
     juce::AudioParameterFloat* cutoffParam_ = nullptr;
@@ -127,6 +207,19 @@ private:
     juce::AudioParameterFloat* env2DecayParam_ = nullptr;
     juce::AudioParameterChoice* env2DestParam_ = nullptr;
     juce::AudioParameterInt* env2AmountParam_ = nullptr;
+    juce::AudioParameterChoice* envModeParam_ = nullptr;
+    juce::AudioParameterChoice* envCurveParam_ = nullptr;
+
+    // Per-voice modulation parameters
+    juce::AudioParameterChoice* velDestParam_ = nullptr;
+    juce::AudioParameterInt* velAmountParam_ = nullptr;
+    juce::AudioParameterChoice* aenvDestParam_ = nullptr;
+    juce::AudioParameterInt* aenvAmountParam_ = nullptr;
+    juce::AudioParameterChoice* pressDestParam_ = nullptr;
+    juce::AudioParameterInt* pressAmountParam_ = nullptr;
+    juce::AudioParameterChoice* slideDestParam_ = nullptr;
+    juce::AudioParameterInt* slideAmountParam_ = nullptr;
+    juce::AudioParameterBool* mpeParam_ = nullptr;
 
     // Preset manager
     PresetManager presetManager_;
@@ -170,6 +170,9 @@ void PresetManager::applyPresetToProcessor(const Preset& preset)
     if (state.hasProperty("color")) {
         *processor_.getColorParam() = static_cast<float>(state.getProperty("color"));
     }
+    // Presets from before FM feedback had none
+    *processor_.getFmFeedbackParam() = state.hasProperty("fm_feedback")
+        ? static_cast<float>(state.getProperty("fm_feedback")) : 0.0f;
     if (state.hasProperty("attack")) {
         *processor_.getAttackParam() = static_cast<float>(state.getProperty("attack"));
     }
@@ -203,6 +206,7 @@ juce::ValueTree PresetManager::captureCurrentState()
     state.setProperty("shape", processor_.getShapeParam()->getIndex(), nullptr);
     state.setProperty("timbre", processor_.getTimbreParam()->get(), nullptr);
     state.setProperty("color", processor_.getColorParam()->get(), nullptr);
+    state.setProperty("fm_feedback", processor_.getFmFeedbackParam()->get(), nullptr);
     state.setProperty("attack", processor_.getAttackParam()->get(), nullptr);
     state.setProperty("decay", processor_.getDecayParam()->get(), nullptr);
     state.setProperty("polyphony", processor_.getPolyphonyParam()->get(), nullptr);
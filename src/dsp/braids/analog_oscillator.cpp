@@ -5,18 +5,99 @@
 #include "analog_oscillator.h"
 #include "resources.h"
 #include "../stmlib/dsp.h"
+#include <algorithm>
 
 namespace braids {
 
 static const uint16_t kHighestNote = 140 * 128;
 static const uint16_t kPitchTableStart = 128 * 128;
 static const uint16_t kOctave = 12 * 128;
+static const int32_t kBuzzDecay = 28000;  // Amplitude ratio between buzz harmonics
+static const size_t kLookupBlockSize = 32;  // Table lookups are batched this many at a time
+
+// PolyBLEP residuals, as in the original Braids. t is how long ago the step
+// happened, as a 16-bit fraction of a sample. The residual for the previous
+// output (ThisBlepSample) and the current one (NextBlepSample) are for a step
+// of 32768, so outputs are delayed by one sample to correct both
+static inline int32_t ThisBlepSample(uint32_t t)
+{
+    if (t > 65535) t = 65535;
+    return static_cast<int32_t>(t * t >> 18);
+}
+
+static inline int32_t NextBlepSample(uint32_t t)
+{
+    if (t > 65535) t = 65535;
+    t = 65535 - t;
+    return -static_cast<int32_t>(t * t >> 18);
+}
+
+// Band-limit a step of the given height (16-bit output units)
+static inline void AddStep(int32_t jump, uint32_t t, int32_t* this_sample, int32_t* next_sample)
+{
+    *this_sample += (jump * ThisBlepSample(t)) >> 15;
+    *next_sample += (jump * NextBlepSample(t)) >> 15;
+}
+
+// Time since a phase crossing, in the 16-bit units used by the BLEP tables
+static inline uint32_t BlepScale(uint32_t phase_increment)
+{
+    uint32_t scale = phase_increment >> 16;
+    return scale ? scale : 1;
+}
+
+// Sync buffers hold 0 for no reset, otherwise 1 + how long before the end
+// of the sample the master wrapped, in 128ths of a sample
+
+static inline uint8_t SyncOut(uint32_t phase, uint32_t phase_increment)
+{
+    uint32_t t = phase / std::max(phase_increment >> 7, 1u);
+    return static_cast<uint8_t>(1 + std::min(t, 127u));
+}
+
+// Time since the reset, in the 16-bit units used by the BLEP tables
+static inline uint32_t SyncResetTime(uint8_t sync)
+{
+    return static_cast<uint32_t>(std::min<uint8_t>(sync, 128) - 1) << 9;
+}
+
+// Phase at the end of the sample for a reset that long ago
+static inline uint32_t SyncResetPhase(uint32_t reset_time, uint32_t phase_increment)
+{
+    return static_cast<uint32_t>(static_cast<uint64_t>(phase_increment) * reset_time >> 16);
+}
+
+// Phase advanced by one sample, or restarted partway through it by sync
+static inline uint32_t NextPhase(uint32_t phase, uint32_t phase_increment, uint8_t sync)
+{
+    return sync ? SyncResetPhase(SyncResetTime(sync), phase_increment) : phase + phase_increment;
+}
+
+// Band-limits the pulse edges crossed moving from phase `from` by `advance`.
+// The move ended `offset` ago (16-bit fraction of a sample)
+static inline void AddPulseEdges(uint32_t from, uint32_t advance, uint32_t pw,
+                                 uint32_t blep_scale, uint32_t offset,
+                                 int32_t* this_sample, int32_t* next_sample)
+{
+    uint32_t to = from + advance;
+    if (to < from) {
+        if (from < pw) {
+            // Fell at pw before wrapping
+            AddStep(-65535, offset + (to - pw) / blep_scale, this_sample, next_sample);
+        }
+        AddStep(65535, offset + to / blep_scale, this_sample, next_sample);
+        if (to >= pw) {
+            AddStep(-65535, offset + (to - pw) / blep_scale, this_sample, next_sample);
+        }
+    } else if (from < pw && to >= pw) {
+        AddStep(-65535, offset + (to - pw) / blep_scale, this_sample, next_sample);
+    }
+}
 
 void AnalogOscillator::Init()
 {
     phase_ = 0;
     next_sample_ = 0;
-    high_ = false;
     shape_ = OSC_SHAPE_SAW;
     pitch_ = 0;
     parameter_ = 0;
@@ -38,8 +119,8 @@ uint32_t AnalogOscillator::ComputePhaseIncrement(int16_t midi_pitch)
         ++num_shifts;
     }
 
-    uint32_t a = lut_oscillator_increments[ref_pitch >> 4];
-    uint32_t b = lut_oscillator_increments[(ref_pitch >> 4) + 1];
+    uint32_t a = increments_[ref_pitch >> 4];
+    uint32_t b = increments_[(ref_pitch >> 4) + 1];
     uint32_t phase_increment = a +
         (static_cast<int32_t>(b - a) * (ref_pitch & 0xf) >> 4);
     phase_increment >>= num_shifts;
@@ -48,18 +129,29 @@ uint32_t AnalogOscillator::ComputePhaseIncrement(int16_t midi_pitch)
 
 void AnalogOscillator::Render(const uint8_t* sync, int16_t* buffer, size_t size)
 {
+    Render(sync, buffer, nullptr, size);
+}
+
+void AnalogOscillator::Render(const uint8_t* sync, int16_t* buffer, uint8_t* sync_out, size_t size)
+{
+    bool blep_shape = shape_ == OSC_SHAPE_SAW || shape_ == OSC_SHAPE_CSAW ||
+                      shape_ == OSC_SHAPE_SQUARE || shape_ >= OSC_SHAPE_LAST;
+    if (sync_out && !blep_shape) {
+        std::fill(sync_out, sync_out + size, static_cast<uint8_t>(0));
+    }
+
     switch (shape_) {
         case OSC_SHAPE_SAW:
-            RenderSaw(sync, buffer, size);
+            RenderSaw(sync, buffer, sync_out, size);
             break;
         case OSC_SHAPE_VARIABLE_SAW:
             RenderVariableSaw(sync, buffer, size);
             break;
         case OSC_SHAPE_CSAW:
-            RenderCSaw(sync, buffer, size);
+            RenderCSaw(sync, buffer, sync_out, size);
             break;
         case OSC_SHAPE_SQUARE:
-            RenderSquare(sync, buffer, size);
+            RenderSquare(sync, buffer, sync_out, size);
             break;
         case OSC_SHAPE_TRIANGLE:
             RenderTriangle(sync, buffer, size);
@@ -77,34 +169,65 @@ void AnalogOscillator::Render(const uint8_t* sync, int16_t* buffer, size_t size)
             RenderBuzz(sync, buffer, size);
             break;
         default:
-            RenderSaw(sync, buffer, size);
+            RenderSaw(sync, buffer, sync_out, size);
             break;
     }
+
+    // Shapes without discontinuities are not delayed; hand their last sample
+    // over so a switch to a BLEP shape continues from it
+    if (!blep_shape && size > 0) {
+        next_sample_ = buffer[size - 1];
+    }
 }
 
-void AnalogOscillator::RenderSaw(const uint8_t* sync, int16_t* buffer, size_t size)
+void AnalogOscillator::RenderSaw(const uint8_t* sync, int16_t* buffer, uint8_t* sync_out, size_t size)
 {
     uint32_t phase_increment = ComputePhaseIncrement(pitch_);
+    uint32_t blep_scale = BlepScale(phase_increment);
     uint32_t phase = phase_;
+    int32_t next_sample = next_sample_;
 
     while (size--) {
-        if (*sync++) {
-            phase = 0;
+        int32_t this_sample = next_sample;
+        next_sample = 0;
+
+        uint8_t reset = *sync++;
+        bool wrapped = false;
+        if (reset) {
+            // Run up to the reset, then drop from that level to the bottom
+            uint32_t reset_time = SyncResetTime(reset);
+            uint32_t at_reset = phase + SyncResetPhase(65535 - reset_time, phase_increment);
+            if (at_reset < phase) {
+                AddStep(-65535, reset_time + at_reset / blep_scale, &this_sample, &next_sample);
+            }
+            AddStep(-static_cast<int32_t>(at_reset >> 16), reset_time, &this_sample, &next_sample);
+            phase = SyncResetPhase(reset_time, phase_increment);
+        } else {
+            phase += phase_increment;
+            wrapped = phase < phase_increment;
+            if (wrapped) {
+                AddStep(-65535, phase / blep_scale, &this_sample, &next_sample);
+            }
+        }
+        if (sync_out) {
+            *sync_out++ = wrapped ? SyncOut(phase, phase_increment) : 0;
         }
-        phase += phase_increment;
 
         // Convert phase to saw wave: phase / 2^32 * 65536 - 32768
         // Simplified: top 16 bits minus 32768
-        int16_t sample = static_cast<int16_t>((phase >> 16) - 32768);
-        *buffer++ = sample;
+        next_sample += static_cast<int32_t>(phase >> 16) - 32768;
+        *buffer++ = static_cast<int16_t>(stmlib::Clip16(this_sample));
     }
+    next_sample_ = next_sample;
     phase_ = phase;
 }
 
-void AnalogOscillator::RenderSquare(const uint8_t* sync, int16_t* buffer, size_t size)
+void AnalogOscillator::RenderSquare(const uint8_t* sync, int16_t* buffer, uint8_t* sync_out, size_t size)
 {
     uint32_t phase_increment = ComputePhaseIncrement(pitch_);
+    uint32_t blep_scale = BlepScale(phase_increment);
     uint32_t phase = phase_;
+    int32_t next_sample = next_sample_;
 
     // PWM: parameter controls pulse width (0 = 50%, 32767 = ~100%)
     uint32_t pw = 0x80000000;
@@ -113,14 +236,35 @@ void AnalogOscillator::RenderSquare(const uint8_t* sync, int16_t* buffer, size_t
     }
 
     while (size--) {
-        if (*sync++) {
-            phase = 0;
+        int32_t this_sample = next_sample;
+        next_sample = 0;
+
+        // Edges are found from the phase alone, so shape switches and
+        // pulse width changes never leave stale state behind
+        uint8_t reset = *sync++;
+        bool wrapped = false;
+        if (reset) {
+            // Run up to the reset, then back to the high half
+            uint32_t reset_time = SyncResetTime(reset);
+            uint32_t advance = SyncResetPhase(65535 - reset_time, phase_increment);
+            AddPulseEdges(phase, advance, pw, blep_scale, reset_time, &this_sample, &next_sample);
+            if (phase + advance >= pw) {
+                AddStep(65535, reset_time, &this_sample, &next_sample);
+            }
+            phase = SyncResetPhase(reset_time, phase_increment);
+        } else {
+            AddPulseEdges(phase, phase_increment, pw, blep_scale, 0, &this_sample, &next_sample);
+            phase += phase_increment;
+            wrapped = phase < phase_increment;
+        }
+        if (sync_out) {
+            *sync_out++ = wrapped ? SyncOut(phase, phase_increment) : 0;
         }
-        phase += phase_increment;
 
-        int16_t sample = (phase < pw) ? 32767 : -32768;
-        *buffer++ = sample;
+        next_sample += (phase < pw) ? 32767 : -32768;
+        *buffer++ = static_cast<int16_t>(stmlib::Clip16(this_sample));
     }
+    next_sample_ = next_sample;
     phase_ = phase;
 }
 
@@ -130,10 +274,7 @@ void AnalogOscillator::RenderTriangle(const uint8_t* sync, int16_t* buffer, size
     uint32_t phase = phase_;
 
     while (size--) {
-        if (*sync++) {
-            phase = 0;
-        }
-        phase += phase_increment;
+        phase = NextPhase(phase, phase_increment, *sync++);
 
         // Triangle: fold the phase
         int32_t tri = phase >> 15;  // 0 to 131071
@@ -150,15 +291,19 @@ void AnalogOscillator::RenderSine(const uint8_t* sync, int16_t* buffer, size_t s
 {
     uint32_t phase_increment = ComputePhaseIncrement(pitch_);
     uint32_t phase = phase_;
+    uint32_t phases[kLookupBlockSize];
 
-    while (size--) {
-        if (*sync++) {
-            phase = 0;
+    while (size) {
+        size_t chunk = std::min(size, kLookupBlockSize);
+        for (size_t i = 0; i < chunk; ++i) {
+            phase = NextPhase(phase, phase_increment, *sync++);
+            phases[i] = phase;
         }
-        phase += phase_increment;
 
         // Use sine wavetable with interpolation
-        *buffer++ = stmlib::Interpolate824(wav_sine, phase);
+        stmlib::Interpolate824Block(wav_sine, phases, buffer, chunk);
+        buffer += chunk;
+        size -= chunk;
     }
     phase_ = phase;
 }
@@ -177,10 +322,7 @@ void AnalogOscillator::RenderVariableSaw(const uint8_t* sync, int16_t* buffer, s
     uint32_t pw_32 = static_cast<uint32_t>(pw) << 16;
 
     while (size--) {
-        if (*sync++) {
-            phase = 0;
-        }
-        phase += phase_increment;
+        phase = NextPhase(phase, phase_increment, *sync++);
 
         // Variable saw: ramp up to pw, then ramp down
         int32_t sample;
@@ -199,13 +341,54 @@ void AnalogOscillator::RenderVariableSaw(const uint8_t* sync, int16_t* buffer, s
     phase_ = phase;
 }
 
-void AnalogOscillator::RenderCSaw(const uint8_t* sync, int16_t* buffer, size_t size)
+// Interpolated lookup into a fold waveshaper mip; x is clamped to 16 bits
+static inline int16_t Waveshape(const int16_t* table, int32_t x)
+{
+    uint32_t position = static_cast<uint32_t>(std::clamp(x, -32768, 32767) + 32768);
+    uint32_t index = position >> (16 - kWsTableBits);
+    int32_t frac = static_cast<int32_t>((position << kWsTableBits) & 0xffff);
+    int32_t a = table[index];
+    int32_t b = table[index + 1];
+    return static_cast<int16_t>(a + ((b - a) * frac >> 16));
+}
+
+// Smoothest needed mip: the one averaging over about as many table steps as
+// the shaper input moves per sample. slope is in input units per sample
+static inline const int16_t* WaveshaperMip(const int16_t* const* mips, float slope)
+{
+    const float steps = slope / static_cast<float>(1 << (16 - kWsTableBits));
+    size_t level = 0;
+    while (level + 1 < kWsNumMips && static_cast<float>(2 << level) <= steps) {
+        ++level;
+    }
+    return mips[level];
+}
+
+static inline int32_t CSawSample(int32_t saw, int32_t shape_amount, int16_t dc_shift)
+{
+    // Apply waveshaping based on parameter
+    // This creates harmonics similar to the original Braids CSAW
+    if (shape_amount > 0) {
+        // Simple waveshaping: add some fold/clip character
+        int32_t shaped = saw + ((saw * shape_amount) >> 16);
+        saw = stmlib::Clip16(shaped);
+    }
+
+    // Apply DC offset and gain
+    int32_t sample = saw + dc_shift;
+    sample = (sample * 13) >> 3;  // ~1.6x gain like original
+    return stmlib::Clip16(sample);
+}
+
+void AnalogOscillator::RenderCSaw(const uint8_t* sync, int16_t* buffer, uint8_t* sync_out, size_t size)
 {
     // CSAW - Classic/Corrected Sawtooth with waveshaping
     // Parameter controls the amount of waveshaping/harmonics
     // Aux parameter controls DC offset/brightness
     uint32_t phase_increment = ComputePhaseIncrement(pitch_);
+    uint32_t blep_scale = BlepScale(phase_increment);
     uint32_t phase = phase_;
+    int32_t next_sample = next_sample_;
 
     // Waveshaping amount from parameter
     int32_t shape_amount = parameter_;
@@ -214,29 +397,43 @@ void AnalogOscillator::RenderCSaw(const uint8_t* sync, int16_t* buffer, size_t s
     // DC offset from aux_parameter
     int16_t dc_shift = static_cast<int16_t>(-(aux_parameter_ - 32767) >> 4);
 
+    // Height of the shaped edge at the end of each cycle
+    int32_t bottom = CSawSample(-32768, shape_amount, dc_shift);
+    int32_t wrap_jump = bottom - CSawSample(32767, shape_amount, dc_shift);
+
     while (size--) {
-        if (*sync++) {
-            phase = 0;
+        int32_t this_sample = next_sample;
+        next_sample = 0;
+
+        uint8_t reset = *sync++;
+        bool wrapped = false;
+        if (reset) {
+            uint32_t reset_time = SyncResetTime(reset);
+            uint32_t at_reset = phase + SyncResetPhase(65535 - reset_time, phase_increment);
+            if (at_reset < phase) {
+                AddStep(wrap_jump, reset_time + at_reset / blep_scale, &this_sample, &next_sample);
+            }
+            int32_t saw = static_cast<int32_t>(at_reset >> 16) - 32768;
+            AddStep(bottom - CSawSample(saw, shape_amount, dc_shift), reset_time,
+                    &this_sample, &next_sample);
+            phase = SyncResetPhase(reset_time, phase_increment);
+        } else {
+            phase += phase_increment;
+            wrapped = phase < phase_increment;
+            if (wrapped) {
+                AddStep(wrap_jump, phase / blep_scale, &this_sample, &next_sample);
+            }
         }
-        phase += phase_increment;
-
-        // Basic saw
-        int32_t saw = static_cast<int32_t>((phase >> 16) - 32768);
-
-        // Apply waveshaping based on parameter
-        // This creates harmonics similar to the original Braids CSAW
-        if (shape_amount > 0) {
-            // Simple waveshaping: add some fold/clip character
-            int32_t shaped = saw + ((saw * shape_amount) >> 16);
-            saw = stmlib::Clip16(shaped);
+        if (sync_out) {
+            *sync_out++ = wrapped ? SyncOut(phase, phase_increment) : 0;
         }
 
-        // Apply DC offset and gain
-        int32_t sample = saw + dc_shift;
-        sample = (sample * 13) >> 3;  // ~1.6x gain like original
-
-        *buffer++ = static_cast<int16_t>(stmlib::Clip16(sample));
+        // Basic saw
+        int32_t saw = static_cast<int32_t>(phase >> 16) - 32768;
+        next_sample += CSawSample(saw, shape_amount, dc_shift);
+        *buffer++ = static_cast<int16_t>(stmlib::Clip16(this_sample));
     }
+    next_sample_ = next_sample;
     phase_ = phase;
 }
 
@@ -251,11 +448,13 @@ void AnalogOscillator::RenderTriangleFold(const uint8_t* sync, int16_t* buffer,
     // This matches the original Braids formula
     int32_t gain = 2048 + ((parameter_ * 30720) >> 15);
 
+    // The triangle moves 2^17 units per cycle, scaled by gain / 2048
+    float slope = static_cast<float>(phase_increment) * (131072.0f / 4294967296.0f) *
+                  static_cast<float>(gain) / 2048.0f;
+    const int16_t* fold = WaveshaperMip(ws_tri_fold_mips, slope);
+
     while (size--) {
-        if (*sync++) {
-            phase = 0;
-        }
-        phase += phase_increment;
+        phase = NextPhase(phase, phase_increment, *sync++);
 
         // Generate triangle
         int32_t tri = phase >> 15;  // 0 to 131071
@@ -264,16 +463,9 @@ void AnalogOscillator::RenderTriangleFold(const uint8_t* sync, int16_t* buffer,
         }
         tri -= 32768;  // Center at 0: -32768 to 32767
 
-        // Apply gain for folding
+        // Apply gain for folding, then fold
         int32_t amplified = (tri * gain) >> 11;
-
-        // Wavefold using lookup table
-        // Map amplified value to table index (0-256)
-        int32_t index = (amplified + 32768) >> 8;
-        if (index < 0) index = 0;
-        if (index > 256) index = 256;
-
-        *buffer++ = ws_tri_fold[index];
+        *buffer++ = Waveshape(fold, amplified);
     }
     phase_ = phase;
 }
@@ -284,64 +476,101 @@ void AnalogOscillator::RenderSineFold(const uint8_t* sync, int16_t* buffer, size
     // Smoother folding character than triangle
     uint32_t phase_increment = ComputePhaseIncrement(pitch_);
     uint32_t phase = phase_;
+    uint32_t phases[kLookupBlockSize];
 
     // Gain from parameter: 2048 + (parameter * 30720 >> 15)
     int32_t gain = 2048 + ((parameter_ * 30720) >> 15);
 
-    while (size--) {
-        if (*sync++) {
-            phase = 0;
+    // Steepest slope of the amplified sine
+    float slope = static_cast<float>(phase_increment) * (2.0f * 3.14159265f * 32767.0f / 4294967296.0f) *
+                  static_cast<float>(gain) / 2048.0f;
+    const int16_t* fold = WaveshaperMip(ws_sine_fold_mips, slope);
+
+    while (size) {
+        size_t chunk = std::min(size, kLookupBlockSize);
+        for (size_t i = 0; i < chunk; ++i) {
+            phase = NextPhase(phase, phase_increment, *sync++);
+            phases[i] = phase;
         }
-        phase += phase_increment;
 
         // Generate sine
-        int16_t sine = stmlib::Interpolate824(wav_sine, phase);
-
-        // Apply gain for folding
-        int32_t amplified = (static_cast<int32_t>(sine) * gain) >> 11;
-
-        // Wavefold using lookup table
-        int32_t index = (amplified + 32768) >> 8;
-        if (index < 0) index = 0;
-        if (index > 256) index = 256;
+        stmlib::Interpolate824Block(wav_sine, phases, buffer, chunk);
 
-        *buffer++ = ws_sine_fold[index];
+        for (size_t i = 0; i < chunk; ++i) {
+            // Apply gain for folding, then fold
+            int32_t amplified = (static_cast<int32_t>(buffer[i]) * gain) >> 11;
+            buffer[i] = Waveshape(fold, amplified);
+        }
+        buffer += chunk;
+        size -= chunk;
     }
     phase_ = phase;
 }
 
 void AnalogOscillator::RenderBuzz(const uint8_t* sync, int16_t* buffer, size_t size)
 {
-    // Buzz - parameter controls harmonic density/brightness
-    // Creates a buzzy, comb-like sound
+    // Buzz - harmonics 1..N with amplitudes falling by r = kBuzzDecay / 32768,
+    // summed in closed form (DSF) instead of one sine lookup per harmonic:
+    //   sum r^(k-1) sin(kt) = (sin t - r^N sin((N+1)t) + r^(N+1) sin(Nt))
+    //                         / (1 - 2r cos t + r^2)
+    // so the cost is four lookups per sample whatever N is
     uint32_t phase_increment = ComputePhaseIncrement(pitch_);
     uint32_t phase = phase_;
 
     // Parameter affects the "buzziness" - number of harmonics
     // Higher parameter = more harmonics = brighter buzz
-    int32_t harmonics = 2 + (parameter_ >> 11);  // 2-18 harmonics
+    int32_t harmonics = 2 + (parameter_ >> 11);  // 2-16 harmonics
     if (harmonics > 16) harmonics = 16;
 
-    while (size--) {
-        if (*sync++) {
-            phase = 0;
+    // Only harmonics below Nyquist (half a cycle per sample)
+    uint32_t below_nyquist = 0x7fffffff / std::max(phase_increment, 1u);
+    harmonics = std::max(1, std::min(harmonics, static_cast<int32_t>(std::min(below_nyquist, 16u))));
+
+    const float r = kBuzzDecay / 32768.0f;
+    float r_n = 1.0f;
+    for (int32_t h = 0; h < harmonics; ++h) {
+        r_n *= r;
+    }
+    const float r_n1 = r_n * r;
+    const float one_plus_r2 = 1.0f + r * r;
+    const float two_r_cos = 2.0f * r / 32768.0f;
+    // Normalise by the sum of the amplitudes so the peak stays in range
+    const float gain = (1.0f - r) / (1.0f - r_n);
+    const uint32_t n = static_cast<uint32_t>(harmonics);
+
+    uint32_t phases[4][kLookupBlockSize];
+    int16_t sin_1[kLookupBlockSize];
+    int16_t cos_1[kLookupBlockSize];
+    int16_t sin_n[kLookupBlockSize];
+    int16_t sin_n1[kLookupBlockSize];
+
+    while (size) {
+        size_t chunk = std::min(size, kLookupBlockSize);
+
+        // Phases - serial, since sync resets the phase
+        for (size_t i = 0; i < chunk; ++i) {
+            phase = NextPhase(phase, phase_increment, *sync++);
+            phases[0][i] = phase;
+            phases[1][i] = phase + (1u << 30);
+            phases[2][i] = phase * n;
+            phases[3][i] = phase * (n + 1);
         }
-        phase += phase_increment;
-
-        // Generate buzz by summing harmonics with alternating phase
-        // This creates a comb-filter like effect
-        int32_t sum = 0;
-        uint32_t harmonic_phase = phase;
-        int32_t amplitude = 32767;
-
-        for (int32_t h = 1; h <= harmonics; ++h) {
-            int16_t harmonic = stmlib::Interpolate824(wav_sine, harmonic_phase);
-            sum += (harmonic * amplitude) >> 15;
-            harmonic_phase += phase_increment;  // Each harmonic is higher frequency
-            amplitude = (amplitude * 28000) >> 15;  // Decay amplitude for higher harmonics
+        stmlib::Interpolate824Block(wav_sine, phases[0], sin_1, chunk);
+        stmlib::Interpolate824Block(wav_sine, phases[1], cos_1, chunk);
+        stmlib::Interpolate824Block(wav_sine, phases[2], sin_n, chunk);
+        stmlib::Interpolate824Block(wav_sine, phases[3], sin_n1, chunk);
+
+        // Closed form - no state carried between samples, so this vectorises.
+        // The denominator is at least (1 - r)^2, never zero
+        for (size_t i = 0; i < chunk; ++i) {
+            float num = static_cast<float>(sin_1[i]) - r_n * sin_n1[i] + r_n1 * sin_n[i];
+            float den = one_plus_r2 - two_r_cos * cos_1[i];
+            float sample = std::clamp(num * gain / den, -32767.0f, 32767.0f);
+            buffer[i] = static_cast<int16_t>(sample);
         }
 
-        *buffer++ = static_cast<int16_t>(stmlib::Clip16(sum));
+        buffer += chunk;
+        size -= chunk;
     }
     phase_ = phase;
 }
@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include "../stmlib/stmlib.h"
+#include "resources.h"
 
 namespace braids {
 
@@ -31,16 +32,24 @@ public:
 
     void set_shape(AnalogOscillatorShape shape) { shape_ = shape; }
     void set_pitch(int16_t pitch) { pitch_ = pitch; }
+    // Phase increment table for the render rate (see OscillatorIncrements)
+    void set_increments(const uint32_t* increments) { increments_ = increments; }
     void set_parameter(int16_t parameter) { parameter_ = parameter; }
     void set_aux_parameter(int16_t aux) { aux_parameter_ = aux; }
 
+    // sync resets the phase partway through a sample: 0 for no reset,
+    // otherwise 1 + how long before the end of the sample, in 128ths
     void Render(const uint8_t* sync, int16_t* buffer, size_t size);
+    // Same, also writing where this oscillator wraps to sync_out in that
+    // format, for another to follow. Only the saw, CSaw and square shapes
+    // drive sync; the others write no resets
+    void Render(const uint8_t* sync, int16_t* buffer, uint8_t* sync_out, size_t size);
 
 private:
-    void RenderSaw(const uint8_t* sync, int16_t* buffer, size_t size);
+    void RenderSaw(const uint8_t* sync, int16_t* buffer, uint8_t* sync_out, size_t size);
     void RenderVariableSaw(const uint8_t* sync, int16_t* buffer, size_t size);
-    void RenderCSaw(const uint8_t* sync, int16_t* buffer, size_t size);
-    void RenderSquare(const uint8_t* sync, int16_t* buffer, size_t size);
+    void RenderCSaw(const uint8_t* sync, int16_t* buffer, uint8_t* sync_out, size_t size);
+    void RenderSquare(const uint8_t* sync, int16_t* buffer, uint8_t* sync_out, size_t size);
     void RenderTriangle(const uint8_t* sync, int16_t* buffer, size_t size);
     void RenderSine(const uint8_t* sync, int16_t* buffer, size_t size);
     void RenderTriangleFold(const uint8_t* sync, int16_t* buffer, size_t size);
@@ -49,14 +58,15 @@ private:
 
     uint32_t ComputePhaseIncrement(int16_t midi_pitch);
 
+    const uint32_t* increments_ = lut_oscillator_increments;
+
     AnalogOscillatorShape shape_ = OSC_SHAPE_SAW;
     int16_t pitch_ = 0;
     int16_t parameter_ = 0;      // Primary parameter (timbre)
     int16_t aux_parameter_ = 0;  // Secondary parameter (color)
 
     uint32_t phase_ = 0;
-    int32_t next_sample_ = 0;
-    bool high_ = false;
+    int32_t next_sample_ = 0;  // BLEP shapes output one sample late
 
     DISALLOW_COPY_AND_ASSIGN(AnalogOscillator);
 };
@@ -0,0 +1,974 @@
+// Digital oscillator models after those of Mutable Instruments Braids,
+// written for BraidsVST rather than ported
+// BraidsVST: GPL v3
+
+#include "digital_oscillator.h"
+#include "../stmlib/dsp.h"
+#include <algorithm>
+
+namespace braids {
+
+static const uint16_t kHighestNote = 140 * 128;
+static const uint16_t kPitchTableStart = 128 * 128;
+static const uint16_t kOctave = 12 * 128;
+static const size_t kLookupBlockSize = 32;  // Table lookups are batched this many at a time
+static const int32_t kSvfMaxCoefficient = 24576;  // Keeps the SVF stable at any damping
+static const size_t kDelayLineMask = kDelayLineSize - 1;
+static const size_t kJetLineMask = kJetLineSize - 1;
+
+// Frequency ratios, 4.12 fixed point
+static const uint16_t kBellRatios[kNumPartials] = {
+    2048, 4096, 4846, 6169, 8192, 10297, 10903, 12333, 17064, 22254, 27837
+};
+static const uint16_t kDrumRatios[kNumPartials] = {
+    4096, 6525, 8745, 9400, 10867, 11948, 12923, 14336, 14737, 14950, 16630
+};
+static const uint16_t kCymbalRatios[kNumSwarmVoices] = {  // TR-808
+    4096, 5927, 6623, 7891, 10251, 10910
+};
+
+// Starting level (Q15) and decay rate multiplier (4.4) of each mode
+static const int16_t kPartialLevels[kNumPartials] = {
+    16384, 32767, 24576, 20480, 16384, 12288, 10240, 8192, 6144, 4096, 3072
+};
+static const uint8_t kPartialDecays[kNumPartials] = {
+    8, 12, 16, 20, 24, 28, 32, 40, 48, 56, 64
+};
+
+// A question mark in Morse code (..--..), one unit per character: dots are
+// one unit on, dashes three, with a unit between them and seven after
+static const char kMorseQuestionMark[] = "1010111011101010000000";
+static const size_t kMorseUnits = sizeof(kMorseQuestionMark) - 1;
+
+static inline int16_t Sine(uint32_t phase)
+{
+    return stmlib::Interpolate824(wav_sine, phase);
+}
+
+// Reads a delay line written at write, delay samples back (16.16)
+static inline int32_t ReadDelay(const int16_t* line, size_t mask, size_t write, uint32_t delay)
+{
+    size_t integral = delay >> 16;
+    int32_t fractional = delay & 0xffff;
+    int32_t a = line[(write - integral) & mask];
+    int32_t b = line[(write - integral - 1) & mask];
+    return a + ((b - a) * fractional >> 16);
+}
+
+// Resonance 0..32767 to damping, 2.0 (65535) down to about 1/16
+static inline int32_t SvfDamping(int32_t resonance)
+{
+    return 65535 - (resonance * 63487 >> 15);
+}
+
+static inline void SvfProcess(Svf* svf, int32_t in, int32_t f, int32_t damp,
+                              int32_t* lp, int32_t* bp, int32_t* hp)
+{
+    int32_t notch = in - (svf->bp * damp >> 15);
+    svf->lp += f * svf->bp >> 15;
+    CLIP(svf->lp);
+    int32_t high = notch - svf->lp;
+    CLIP(high);
+    svf->bp += f * high >> 15;
+    CLIP(svf->bp);
+    *lp = svf->lp;
+    *bp = svf->bp;
+    *hp = high;
+}
+
+// Scales a phase increment by a 4.12 ratio
+static inline uint32_t ScaleIncrement(uint32_t increment, uint16_t ratio)
+{
+    return static_cast<uint32_t>(static_cast<uint64_t>(increment) * ratio >> 12);
+}
+
+// x^n, both Q16
+static inline uint32_t PowQ16(uint32_t x, size_t n)
+{
+    uint32_t result = 65536;
+    while (n) {
+        if (n & 1) {
+            result = static_cast<uint32_t>(static_cast<uint64_t>(result) * x >> 16);
+        }
+        x = static_cast<uint32_t>(static_cast<uint64_t>(x) * x >> 16);
+        n >>= 1;
+    }
+    return result;
+}
+
+void DigitalOscillator::Init()
+{
+    shape_ = OSC_SHAPE_TRIPLE_RING_MOD;
+    pitch_ = 0;
+    parameter_[0] = 0;
+    parameter_[1] = 0;
+    strike_ = true;
+    phase_ = 0;
+    std::fill(phases_, phases_ + kNumHarmonics, 0u);
+    std::fill(amplitudes_, amplitudes_ + kNumHarmonics, 0);
+    std::fill(grain_increments_, grain_increments_ + kNumGrains, 0u);
+    std::fill(windows_, windows_ + kNumGrains, 0u);
+    std::fill(window_increments_, window_increments_ + kNumGrains, 0u);
+    svf_[0] = {0, 0};
+    svf_[1] = {0, 0};
+    filter_state_ = 0;
+    envelope_ = 0;
+    pitch_envelope_ = 0;
+    held_sample_ = 0;
+    hold_counter_ = 0;
+    std::fill(sequence_, sequence_ + kClockedNoiseSteps, static_cast<int16_t>(0));
+    step_ = 0;
+    std::fill(delay_line_, delay_line_ + kDelayLineSize, static_cast<int16_t>(0));
+    delay_write_ = 0;
+    dc_state_[0] = 0;
+    dc_state_[1] = 0;
+    std::fill(jet_line_, jet_line_ + kJetLineSize, static_cast<int16_t>(0));
+    jet_write_ = 0;
+}
+
+uint32_t DigitalOscillator::ComputePhaseIncrement(int32_t midi_pitch)
+{
+    midi_pitch = std::clamp<int32_t>(midi_pitch, 0, kHighestNote);
+    if (midi_pitch >= kPitchTableStart) {
+        midi_pitch = kPitchTableStart - 1;
+    }
+
+    int32_t ref_pitch = midi_pitch;
+    ref_pitch -= kPitchTableStart;
+
+    size_t num_shifts = 0;
+    while (ref_pitch < 0) {
+        ref_pitch += kOctave;
+        ++num_shifts;
+    }
+
+    uint32_t a = increments_[ref_pitch >> 4];
+    uint32_t b = increments_[(ref_pitch >> 4) + 1];
+    uint32_t phase_increment = a +
+        (static_cast<int32_t>(b - a) * (ref_pitch & 0xf) >> 4);
+    phase_increment >>= num_shifts;
+    return phase_increment;
+}
+
+uint32_t DigitalOscillator::ComputeDelay(int32_t midi_pitch)
+{
+    uint32_t increment = std::max<uint32_t>(ComputePhaseIncrement(midi_pitch), 1);
+    uint64_t delay = (static_cast<uint64_t>(1) << 48) / increment;
+    return static_cast<uint32_t>(std::clamp<uint64_t>(
+        delay, 1 << 16, static_cast<uint64_t>(kDelayLineSize - 2) << 16));
+}
+
+int32_t DigitalOscillator::SvfCoefficient(int32_t cutoff_pitch)
+{
+    // 2 * pi * cutoff / sample rate in Q15, which the phase increment
+    // already holds for whatever rate the increments are for
+    uint32_t increment = ComputePhaseIncrement(cutoff_pitch);
+    int32_t f = static_cast<int32_t>(static_cast<uint64_t>(increment) * 205887 >> 32);
+    return std::min(f, kSvfMaxCoefficient);
+}
+
+void DigitalOscillator::Render(const uint8_t*, int16_t* buffer, size_t size)
+{
+    switch (shape_) {
+        case OSC_SHAPE_TRIPLE_RING_MOD:
+            RenderTripleRingMod(buffer, size);
+            break;
+        case OSC_SHAPE_SAW_SWARM:
+            RenderSawSwarm(buffer, size);
+            break;
+        case OSC_SHAPE_COMB_FILTER:
+            RenderComb(buffer, size);
+            break;
+        case OSC_SHAPE_TOY:
+            RenderToy(buffer, size);
+            break;
+        case OSC_SHAPE_VOSIM:
+            RenderVosim(buffer, size);
+            break;
+        case OSC_SHAPE_HARMONICS:
+            RenderHarmonics(buffer, size);
+            break;
+        case OSC_SHAPE_PLUCKED:
+            RenderPlucked(buffer, size);
+            break;
+        case OSC_SHAPE_STRUCK_BELL:
+        case OSC_SHAPE_STRUCK_DRUM:
+            RenderStruck(buffer, size);
+            break;
+        case OSC_SHAPE_KICK:
+            RenderKick(buffer, size);
+            break;
+        case OSC_SHAPE_SNARE:
+            RenderSnare(buffer, size);
+            break;
+        case OSC_SHAPE_CYMBAL:
+            RenderCymbal(buffer, size);
+            break;
+        case OSC_SHAPE_FILTERED_NOISE:
+            RenderFilteredNoise(buffer, size);
+            break;
+        case OSC_SHAPE_TWIN_PEAKS_NOISE:
+            RenderTwinPeaksNoise(buffer, size);
+            break;
+        case OSC_SHAPE_CLOCKED_NOISE:
+            RenderClockedNoise(buffer, size);
+            break;
+        case OSC_SHAPE_GRANULAR_CLOUD:
+            RenderGranularCloud(buffer, size);
+            break;
+        case OSC_SHAPE_FEEDBACK_FM:
+            RenderFeedbackFm(buffer, size);
+            break;
+        case OSC_SHAPE_CHAOTIC_FEEDBACK_FM:
+            RenderChaoticFeedbackFm(buffer, size);
+            break;
+        case OSC_SHAPE_ZLPF:
+        case OSC_SHAPE_ZPKF:
+        case OSC_SHAPE_ZBPF:
+        case OSC_SHAPE_ZHPF:
+            RenderZFilter(buffer, size);
+            break;
+        case OSC_SHAPE_DIGITAL_MODULATION:
+            RenderDigitalModulation(buffer, size);
+            break;
+        case OSC_SHAPE_BOWED:
+            RenderBowed(buffer, size);
+            break;
+        case OSC_SHAPE_BLOWN:
+            RenderBlown(buffer, size);
+            break;
+        case OSC_SHAPE_FLUTED:
+            RenderFluted(buffer, size);
+            break;
+        case OSC_SHAPE_QUESTION_MARK:
+            RenderQuestionMark(buffer, size);
+            break;
+        case OSC_SHAPE_PARTICLE_NOISE:
+        default:
+            RenderParticleNoise(buffer, size);
+            break;
+    }
+    strike_ = false;
+}
+
+void DigitalOscillator::RenderTripleRingMod(int16_t* buffer, size_t size)
+{
+    // Three sines multiplied together
+    // Timbre, Color: pitch of the second and third, +/- 16 semitones
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    uint32_t increment_1 = ComputePhaseIncrement(pitch_ + ((parameter_[0] - 16384) >> 3));
+    uint32_t increment_2 = ComputePhaseIncrement(pitch_ + ((parameter_[1] - 16384) >> 3));
+
+    uint32_t phases[3][kLookupBlockSize];
+    int16_t sines[3][kLookupBlockSize];
+    while (size) {
+        size_t chunk = std::min(size, kLookupBlockSize);
+        for (size_t i = 0; i < chunk; ++i) {
+            phase_ += increment;
+            phases_[0] += increment_1;
+            phases_[1] += increment_2;
+            phases[0][i] = phase_;
+            phases[1][i] = phases_[0];
+            phases[2][i] = phases_[1];
+        }
+        for (size_t j = 0; j < 3; ++j) {
+            stmlib::Interpolate824Block(wav_sine, phases[j], sines[j], chunk);
+        }
+        for (size_t i = 0; i < chunk; ++i) {
+            int32_t product = sines[0][i] * sines[1][i] >> 15;
+            product = product * sines[2][i] >> 14;
+            buffer[i] = static_cast<int16_t>(stmlib::Clip16(product));
+        }
+        buffer += chunk;
+        size -= chunk;
+    }
+}
+
+void DigitalOscillator::RenderSawSwarm(int16_t* buffer, size_t size)
+{
+    // Six detuned saws, high-passed
+    // Timbre: detune spread, Color: high-pass cutoff
+    if (strike_) {
+        for (size_t i = 0; i < kNumSwarmVoices; ++i) {
+            phases_[i] = static_cast<uint32_t>(i) * 0x2aaaaaaa;
+        }
+    }
+
+    int32_t spread = parameter_[0] >> 8;
+    uint32_t increments[kNumSwarmVoices];
+    for (size_t i = 0; i < kNumSwarmVoices; ++i) {
+        int32_t detune = (static_cast<int32_t>(2 * i) - 5) * spread >> 1;
+        increments[i] = ComputePhaseIncrement(pitch_ + detune);
+    }
+    int32_t hp_coefficient = std::min<int32_t>(ScaleToRate(parameter_[1] >> 2), 32767);
+
+    for (size_t n = 0; n < size; ++n) {
+        int32_t sum = 0;
+        for (size_t i = 0; i < kNumSwarmVoices; ++i) {
+            phases_[i] += increments[i];
+            sum += static_cast<int32_t>(phases_[i] >> 16) - 32768;
+        }
+        sum >>= 2;
+        filter_state_ += (sum - filter_state_) * hp_coefficient >> 15;
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16(sum - filter_state_));
+    }
+}
+
+void DigitalOscillator::RenderComb(int16_t* buffer, size_t size)
+{
+    // Saw through a comb filter
+    // Timbre: comb pitch around the note, Color: feedback (negative below
+    // the middle)
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    uint32_t delay = ComputeDelay(pitch_ + ((parameter_[0] - 16384) >> 2));
+    int32_t feedback = std::clamp<int32_t>((parameter_[1] - 16384) * 2, -31000, 31000);
+    size_t delay_integral = delay >> 16;
+    int32_t delay_fractional = delay & 0xffff;
+
+    for (size_t n = 0; n < size; ++n) {
+        phase_ += increment;
+        int32_t input = static_cast<int32_t>(phase_ >> 17) - 16384;
+        int32_t a = delay_line_[(delay_write_ - delay_integral) & kDelayLineMask];
+        int32_t b = delay_line_[(delay_write_ - delay_integral - 1) & kDelayLineMask];
+        int32_t delayed = a + ((b - a) * delay_fractional >> 16);
+        int32_t output = stmlib::Clip16(input + (delayed * feedback >> 15));
+        delay_line_[delay_write_] = static_cast<int16_t>(output);
+        delay_write_ = (delay_write_ + 1) & kDelayLineMask;
+        buffer[n] = static_cast<int16_t>(output);
+    }
+}
+
+void DigitalOscillator::RenderToy(int16_t* buffer, size_t size)
+{
+    // Lo-fi 8-bit saw
+    // Timbre: sample rate reduction, Color: bit mangling
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    // Held for 1 to 32 samples at 96 kHz, counted in 16.16 at this rate
+    uint32_t decimation = ((parameter_[0] >> 10) + 1) << 16;
+    uint8_t mangle = static_cast<uint8_t>(parameter_[1] >> 7);
+
+    for (size_t n = 0; n < size; ++n) {
+        phase_ += increment;
+        hold_counter_ += static_cast<uint32_t>(time_scale_);
+        if (hold_counter_ >= decimation) {
+            hold_counter_ %= decimation;
+            uint8_t x = static_cast<uint8_t>(phase_ >> 24);
+            x ^= (x >> 1) & mangle;
+            held_sample_ = (static_cast<int32_t>(x) << 8) - 32768;
+        }
+        buffer[n] = static_cast<int16_t>(held_sample_);
+    }
+}
+
+void DigitalOscillator::RenderVosim(int16_t* buffer, size_t size)
+{
+    // Two sine formants restarted every period and faded out across it
+    // Timbre, Color: formant frequencies, 1 to 3.7 octaves above the note
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    uint32_t formant_1 = ComputePhaseIncrement(pitch_ + kOctave + (parameter_[0] >> 3));
+    uint32_t formant_2 = ComputePhaseIncrement(pitch_ + kOctave + (parameter_[1] >> 3));
+
+    for (size_t n = 0; n < size; ++n) {
+        phase_ += increment;
+        if (phase_ < increment) {
+            phases_[0] = 0;
+            phases_[1] = 0;
+        }
+        phases_[0] += formant_1;
+        phases_[1] += formant_2;
+        int32_t window = 65535 - static_cast<int32_t>(phase_ >> 16);
+        int32_t formants = Sine(phases_[0]) + (Sine(phases_[1]) >> 1);
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16(formants * window >> 16));
+    }
+}
+
+void DigitalOscillator::RenderHarmonics(int16_t* buffer, size_t size)
+{
+    // Additive: a band of harmonics, skipping those above Nyquist
+    // Timbre: centre harmonic, Color: width of the band
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    int32_t centre = parameter_[0] * static_cast<int32_t>(kNumHarmonics - 1) >> 7;  // 8.8
+    int32_t width = 256 + (parameter_[1] * 6 >> 7);
+
+    int32_t levels[kNumHarmonics];
+    int32_t total = 0;
+    for (size_t h = 0; h < kNumHarmonics; ++h) {
+        int32_t distance = std::abs((static_cast<int32_t>(h) << 8) - centre);
+        bool audible = static_cast<uint64_t>(increment) * (h + 1) < 0x80000000u;
+        levels[h] = audible ? std::max<int32_t>(width - distance, 0) : 0;
+        total += levels[h];
+    }
+    for (size_t h = 0; h < kNumHarmonics; ++h) {
+        levels[h] = total ? levels[h] * 32767 / total : 0;
+    }
+
+    uint32_t phases[kLookupBlockSize];
+    int16_t sines[kLookupBlockSize];
+    int32_t mix[kLookupBlockSize];
+    while (size) {
+        size_t chunk = std::min(size, kLookupBlockSize);
+        uint32_t start = phase_;
+        std::fill(mix, mix + chunk, 0);
+        for (size_t h = 0; h < kNumHarmonics; ++h) {
+            if (levels[h] == 0) {
+                continue;
+            }
+            uint32_t harmonic_increment = increment * static_cast<uint32_t>(h + 1);
+            uint32_t phase = start * static_cast<uint32_t>(h + 1);
+            for (size_t i = 0; i < chunk; ++i) {
+                phase += harmonic_increment;
+                phases[i] = phase;
+            }
+            stmlib::Interpolate824Block(wav_sine, phases, sines, chunk);
+            for (size_t i = 0; i < chunk; ++i) {
+                mix[i] += sines[i] * levels[h] >> 15;
+            }
+        }
+        for (size_t i = 0; i < chunk; ++i) {
+            buffer[i] = static_cast<int16_t>(stmlib::Clip16(mix[i]));
+        }
+        phase_ = start + increment * static_cast<uint32_t>(chunk);
+        buffer += chunk;
+        size -= chunk;
+    }
+}
+
+void DigitalOscillator::RenderPlucked(int16_t* buffer, size_t size)
+{
+    // Karplus-Strong string, plucked on strike
+    // Timbre: brightness of the pluck, Color: sustain
+    // The averaging filter delays by half a sample, taken off the loop
+    uint32_t delay = ComputeDelay(pitch_) - 32768;
+    size_t delay_integral = delay >> 16;
+    int32_t delay_fractional = delay & 0xffff;
+
+    if (strike_) {
+        int32_t brightness = std::min<int32_t>(ScaleToRate(1024 + parameter_[0]), 32767);
+        int32_t lp = 0;
+        for (size_t i = 0; i <= delay_integral + 1; ++i) {
+            lp += (random_.GetSample() - lp) * brightness >> 15;
+            delay_line_[(delay_write_ - 1 - i) & kDelayLineMask] = static_cast<int16_t>(lp);
+        }
+        filter_state_ = 0;
+    }
+    // Taken once per trip round the loop, that is once per period whatever
+    // the rate, so the sustain needs no scaling
+    int32_t loss = 32767 - ((32767 - parameter_[1]) >> 7) - 40;
+
+    for (size_t n = 0; n < size; ++n) {
+        int32_t a = delay_line_[(delay_write_ - delay_integral) & kDelayLineMask];
+        int32_t b = delay_line_[(delay_write_ - delay_integral - 1) & kDelayLineMask];
+        int32_t delayed = a + ((b - a) * delay_fractional >> 16);
+        int32_t averaged = (delayed + filter_state_) >> 1;
+        filter_state_ = delayed;
+        delay_line_[delay_write_] = static_cast<int16_t>(averaged * loss >> 15);
+        delay_write_ = (delay_write_ + 1) & kDelayLineMask;
+        buffer[n] = static_cast<int16_t>(delayed);
+    }
+}
+
+void DigitalOscillator::RenderStruck(int16_t* buffer, size_t size)
+{
+    // Decaying inharmonic modes: bell or drum membrane
+    // Timbre: decay time, Color: brightness (level of the upper modes)
+    const uint16_t* ratios = shape_ == OSC_SHAPE_STRUCK_BELL ? kBellRatios : kDrumRatios;
+    if (strike_) {
+        for (size_t i = 0; i < kNumPartials; ++i) {
+            int32_t tilt = 32767 - ((32767 - parameter_[1]) * static_cast<int32_t>(i) /
+                static_cast<int32_t>(kNumPartials));
+            amplitudes_[i] = (kPartialLevels[i] * tilt >> 15) << 15;  // Q30
+            phases_[i] = 0;
+        }
+    }
+
+    // Bells ring about four times longer than drums
+    int32_t base_decay = ((32767 - parameter_[0]) >> 10) + 1;  // 1..32
+    int32_t decay_shift = shape_ == OSC_SHAPE_STRUCK_BELL ? 6 : 4;
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+
+    uint32_t phases[kLookupBlockSize];
+    int16_t sines[kLookupBlockSize];
+    int32_t mix[kLookupBlockSize];
+    while (size) {
+        size_t chunk = std::min(size, kLookupBlockSize);
+        std::fill(mix, mix + chunk, 0);
+        for (size_t p = 0; p < kNumPartials; ++p) {
+            uint32_t partial_increment = ScaleIncrement(increment, ratios[p]);
+            if (amplitudes_[p] == 0 || partial_increment >= 0x80000000u) {
+                continue;
+            }
+            for (size_t i = 0; i < chunk; ++i) {
+                phases_[p] += partial_increment;
+                phases[i] = phases_[p];
+            }
+            stmlib::Interpolate824Block(wav_sine, phases, sines, chunk);
+            // Exponential decay per block, ramped linearly across it
+            int32_t rate = std::min<int32_t>(
+                ScaleToRate(base_decay * kPartialDecays[p] >> decay_shift), 65535);
+            uint32_t block_factor = PowQ16(65535 - rate, chunk);
+            int32_t amplitude = amplitudes_[p];
+            int32_t target = static_cast<int32_t>(
+                static_cast<int64_t>(amplitude) * block_factor >> 16);
+            int32_t step = (target - amplitude) / static_cast<int32_t>(chunk);
+            for (size_t i = 0; i < chunk; ++i) {
+                amplitude += step;
+                mix[i] += sines[i] * (amplitude >> 15) >> 17;
+            }
+            amplitudes_[p] = target;
+        }
+        for (size_t i = 0; i < chunk; ++i) {
+            buffer[i] = static_cast<int16_t>(stmlib::Clip16(mix[i]));
+        }
+        buffer += chunk;
+        size -= chunk;
+    }
+}
+
+void DigitalOscillator::RenderKick(int16_t* buffer, size_t size)
+{
+    // Sine with a fast downward pitch sweep, struck
+    // Timbre: decay time, Color: depth of the sweep (up to 4x the pitch)
+    if (strike_) {
+        phase_ = 0;
+        envelope_ = 1 << 30;
+        pitch_envelope_ = 1 << 30;
+    }
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    int32_t decay = ScaleToRate(((32767 - parameter_[0]) >> 7) + 4);
+    int32_t sweep_decay = ScaleToRate(128);  // 1/512 per sample at 96 kHz
+    int32_t sweep = parameter_[1];
+
+    for (size_t n = 0; n < size; ++n) {
+        pitch_envelope_ -= (pitch_envelope_ >> 16) * sweep_decay;
+        envelope_ -= (envelope_ >> 16) * decay;
+        int32_t bend = (pitch_envelope_ >> 15) * sweep >> 15;  // Q15
+        phase_ += increment + static_cast<uint32_t>(static_cast<uint64_t>(increment) * bend >> 13);
+        buffer[n] = static_cast<int16_t>(Sine(phase_) * (envelope_ >> 15) >> 15);
+    }
+}
+
+void DigitalOscillator::RenderSnare(int16_t* buffer, size_t size)
+{
+    // Two body modes and a burst of high-passed noise, struck
+    // Timbre: noise level against the body, Color: decay time
+    if (strike_) {
+        phase_ = 0;
+        phases_[0] = 0;
+        envelope_ = 1 << 30;
+        pitch_envelope_ = 1 << 30;  // Noise envelope
+    }
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    uint32_t increment_2 = ScaleIncrement(increment, 6021);  // 1.47x
+    int32_t decay = ScaleToRate(((32767 - parameter_[1]) >> 7) + 8);
+    int32_t noise_decay = decay + (decay >> 1);
+    int32_t hp_coefficient = std::min<int32_t>(ScaleToRate(8192), 32767);
+    int32_t noise_level = parameter_[0];
+    int32_t body_level = 32767 - noise_level;
+
+    for (size_t n = 0; n < size; ++n) {
+        envelope_ -= (envelope_ >> 16) * decay;
+        pitch_envelope_ -= (pitch_envelope_ >> 16) * noise_decay;
+        phase_ += increment;
+        phases_[0] += increment_2;
+        int32_t body = (Sine(phase_) + (Sine(phases_[0]) >> 1)) * (envelope_ >> 15) >> 15;
+        int32_t noise = random_.GetSample();
+        filter_state_ += (noise - filter_state_) * hp_coefficient >> 15;
+        noise = (noise - filter_state_) * (pitch_envelope_ >> 15) >> 15;
+        int32_t mix = (body * body_level + noise * noise_level) >> 15;
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16(mix));
+    }
+}
+
+void DigitalOscillator::RenderCymbal(int16_t* buffer, size_t size)
+{
+    // Six square waves at the TR-808 ratios plus noise, high-passed
+    // Timbre: cutoff, Color: noise mix
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    uint32_t increments[kNumSwarmVoices];
+    for (size_t i = 0; i < kNumSwarmVoices; ++i) {
+        increments[i] = ScaleIncrement(increment, kCymbalRatios[i]);
+    }
+    int32_t f = SvfCoefficient(pitch_ + kOctave + (parameter_[0] >> 3));
+    int32_t damp = SvfDamping(8192);
+    int32_t noise_level = parameter_[1];
+    int32_t tone_level = 32767 - noise_level;
+
+    for (size_t n = 0; n < size; ++n) {
+        int32_t squares = 0;
+        for (size_t i = 0; i < kNumSwarmVoices; ++i) {
+            phases_[i] += increments[i];
+            squares += (phases_[i] >> 31) ? 5000 : -5000;
+        }
+        int32_t noise = random_.GetSample();
+        int32_t input = (squares * tone_level + noise * noise_level) >> 15;
+        int32_t lp, bp, hp;
+        SvfProcess(&svf_[0], input, f, damp, &lp, &bp, &hp);
+        buffer[n] = static_cast<int16_t>(hp);
+    }
+}
+
+void DigitalOscillator::RenderFilteredNoise(int16_t* buffer, size_t size)
+{
+    // Noise through a resonant filter at the note
+    // Timbre: resonance, Color: low-pass, band-pass, high-pass
+    int32_t f = SvfCoefficient(pitch_);
+    int32_t damp = SvfDamping(parameter_[0]);
+    int32_t mode = parameter_[1];
+    int32_t balance = mode < 16384 ? mode << 1 : (mode - 16384) << 1;
+    // Band-pass is quieter: gain it up by the damping
+    int32_t bp_gain = std::max<int32_t>(damp >> 1, 4096);
+
+    for (size_t n = 0; n < size; ++n) {
+        int32_t noise = random_.GetSample() >> 1;
+        int32_t lp, bp, hp;
+        SvfProcess(&svf_[0], noise, f, damp, &lp, &bp, &hp);
+        bp = bp * bp_gain >> 15;
+        int32_t a = mode < 16384 ? lp : bp;
+        int32_t b = mode < 16384 ? bp : hp;
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16(a + ((b - a) * balance >> 15)));
+    }
+}
+
+void DigitalOscillator::RenderTwinPeaksNoise(int16_t* buffer, size_t size)
+{
+    // Noise through two resonant band-passes
+    // Timbre: resonance, Color: second peak, up to 32 semitones above
+    int32_t f_1 = SvfCoefficient(pitch_);
+    int32_t f_2 = SvfCoefficient(pitch_ + (parameter_[1] >> 3));
+    int32_t damp = SvfDamping(16384 + (parameter_[0] >> 1));
+
+    for (size_t n = 0; n < size; ++n) {
+        // Scale the input by the damping so the peaks stay level
+        int32_t noise = random_.GetSample() * damp >> 16;
+        int32_t lp, bp_1, bp_2, hp;
+        SvfProcess(&svf_[0], noise, f_1, damp, &lp, &bp_1, &hp);
+        SvfProcess(&svf_[1], noise, f_2, damp, &lp, &bp_2, &hp);
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16(bp_1 + bp_2));
+    }
+}
+
+void DigitalOscillator::RenderClockedNoise(int16_t* buffer, size_t size)
+{
+    // Sample-and-hold noise clocked at the note, looping 16 steps
+    // Timbre: how often a step is replaced by a new value (none: a frozen
+    // loop), Color: quantization, 16 bits down to 1
+    if (strike_) {
+        for (size_t i = 0; i < kClockedNoiseSteps; ++i) {
+            sequence_[i] = random_.GetSample();
+        }
+    }
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    int32_t bits = 1 + ((32767 - parameter_[1]) >> 11);
+    int32_t mask = ~((1 << (16 - bits)) - 1);
+    uint32_t change = static_cast<uint32_t>(parameter_[0]) << 17;
+
+    for (size_t n = 0; n < size; ++n) {
+        phase_ += increment;
+        if (phase_ < increment) {
+            step_ = (step_ + 1) % kClockedNoiseSteps;
+            if (random_.GetWord() < change) {
+                sequence_[step_] = random_.GetSample();
+            }
+            held_sample_ = sequence_[step_] & mask;
+        }
+        buffer[n] = static_cast<int16_t>(held_sample_);
+    }
+}
+
+void DigitalOscillator::RenderGranularCloud(int16_t* buffer, size_t size)
+{
+    // Four sine grains with a raised window, started at random
+    // Timbre: density, Color: pitch scatter, up to 32 semitones
+    // Chances per sample, so fewer samples need higher odds
+    uint32_t density = static_cast<uint32_t>(ScaleToRate(parameter_[0] << 2));
+    int32_t scatter = parameter_[1] >> 3;
+    uint32_t window_increment = static_cast<uint32_t>(std::min<uint64_t>(
+        static_cast<uint64_t>(0xffffffffu / 960) * static_cast<uint32_t>(time_scale_) >> 16,
+        0xffffffffu));
+
+    for (size_t n = 0; n < size; ++n) {
+        int32_t mix = 0;
+        for (size_t g = 0; g < kNumGrains; ++g) {
+            if (window_increments_[g] == 0) {
+                if ((random_.GetWord() >> 16) < density) {
+                    int32_t offset = random_.GetSample() * scatter >> 15;
+                    grain_increments_[g] = ComputePhaseIncrement(pitch_ + offset);
+                    // 10, 20, 40 or 80 ms
+                    window_increments_[g] = window_increment >> (random_.GetWord() >> 30);
+                    windows_[g] = 0;
+                    phases_[g] = 0;
+                }
+                continue;
+            }
+            uint32_t window = windows_[g];
+            windows_[g] += window_increments_[g];
+            if (windows_[g] < window) {
+                window_increments_[g] = 0;
+                continue;
+            }
+            phases_[g] += grain_increments_[g];
+            int32_t envelope = Sine(window >> 1);  // First half of the sine: 0, 1, 0
+            mix += Sine(phases_[g]) * envelope >> 15;
+        }
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16(mix >> 1));
+    }
+}
+
+void DigitalOscillator::RenderParticleNoise(int16_t* buffer, size_t size)
+{
+    // Random impulses ringing two band-passes, retuned at each impulse
+    // Timbre: density, Color: tuning scatter, up to 32 semitones
+    uint32_t density = static_cast<uint32_t>(ScaleToRate(parameter_[0] >> 2));
+    int32_t scatter = parameter_[1] >> 3;
+    int32_t damp = SvfDamping(30000);
+    if (strike_) {
+        amplitudes_[0] = SvfCoefficient(pitch_);
+        amplitudes_[1] = SvfCoefficient(pitch_);
+    }
+
+    for (size_t n = 0; n < size; ++n) {
+        int32_t impulse = 0;
+        if ((random_.GetWord() >> 16) < density) {
+            impulse = random_.GetSample();
+            amplitudes_[0] = SvfCoefficient(pitch_ + (random_.GetSample() * scatter >> 15));
+            amplitudes_[1] = SvfCoefficient(pitch_ + (random_.GetSample() * scatter >> 15));
+        }
+        int32_t lp, bp_1, bp_2, hp;
+        SvfProcess(&svf_[0], impulse, amplitudes_[0], damp, &lp, &bp_1, &hp);
+        SvfProcess(&svf_[1], impulse, amplitudes_[1], damp, &lp, &bp_2, &hp);
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16(bp_1 + bp_2));
+    }
+}
+
+void DigitalOscillator::RenderFeedbackFm(int16_t* buffer, size_t size)
+{
+    // Two sines at the note, the output fed back into the modulator's phase.
+    // The feedback is the average of the last two samples, which keeps it
+    // from breaking into a buzz at two samples a period
+    // Timbre: modulation index, Color: feedback amount
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    int32_t index = parameter_[0];
+    int32_t feedback = parameter_[1];
+    int32_t dc_coefficient = ScaleToRate(64);
+
+    for (size_t n = 0; n < size; ++n) {
+        phase_ += increment;
+        int32_t shift = (held_sample_ + filter_state_) * feedback >> 16;
+        int32_t modulator = Sine(phase_ + (static_cast<uint32_t>(shift) << 14));
+        int32_t depth = modulator * index >> 15;
+        filter_state_ = held_sample_;
+        held_sample_ = Sine(phase_ + (static_cast<uint32_t>(depth) << 16));
+        // The feedback skews the wave: take off the offset it leaves
+        dc_state_[0] += (held_sample_ - dc_state_[0]) * dc_coefficient >> 15;
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16(held_sample_ - dc_state_[0]));
+    }
+}
+
+void DigitalOscillator::RenderChaoticFeedbackFm(int16_t* buffer, size_t size)
+{
+    // Two sines, the modulator's output fed back into its own pitch: it
+    // wobbles, then splits into a tangle of sidebands and finally noise as
+    // the feedback rises
+    // Timbre: modulation index, Color: feedback amount
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    int32_t index = parameter_[0];
+    int32_t feedback = parameter_[1];
+
+    for (size_t n = 0; n < size; ++n) {
+        phase_ += increment;
+        // Up to five times the note, and down to a quarter of it so the
+        // modulator never stalls
+        int32_t bend = std::max<int32_t>(held_sample_ * feedback >> 15, -6144);
+        phases_[0] += increment + static_cast<uint32_t>(
+            static_cast<int64_t>(increment) * bend >> 13);
+        held_sample_ = Sine(phases_[0]);
+        int32_t depth = held_sample_ * index >> 15;
+        buffer[n] = Sine(phase_ + (static_cast<uint32_t>(depth) << 16));
+    }
+}
+
+void DigitalOscillator::RenderZFilter(int16_t* buffer, size_t size)
+{
+    // Phase distortion resonance: a sine above the note restarted every
+    // period and shaped by a window, a saw (low-pass), triangle (peak),
+    // sine (band-pass) or pulse (high-pass)
+    // Timbre: resonance frequency, a semitone to five octaves above, Color:
+    // resonance mixed against a sine at the note
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    uint32_t resonance = ComputePhaseIncrement(pitch_ + (parameter_[0] >> 2) + 128);
+    int32_t mix = parameter_[1];
+
+    for (size_t n = 0; n < size; ++n) {
+        phase_ += increment;
+        if (phase_ < increment) {
+            phases_[0] = 0;
+        }
+        phases_[0] += resonance;
+        int32_t position = static_cast<int32_t>(phase_ >> 16);
+        int32_t window;
+        switch (shape_) {
+            case OSC_SHAPE_ZLPF:
+                window = 65535 - position;
+                break;
+            case OSC_SHAPE_ZPKF:
+                window = position < 32768 ? position << 1 : (65535 - position) << 1;
+                break;
+            case OSC_SHAPE_ZBPF:
+                window = Sine(phase_ >> 1) << 1;  // First half of the sine
+                break;
+            default:
+                window = position < 32768 ? 65535 : 0;
+                break;
+        }
+        int32_t resonant = Sine(phases_[0]) * window >> 16;
+        int32_t fundamental = Sine(phase_);
+        buffer[n] = static_cast<int16_t>(fundamental + ((resonant - fundamental) * mix >> 15));
+    }
+}
+
+void DigitalOscillator::RenderDigitalModulation(int16_t* buffer, size_t size)
+{
+    // A carrier at the note, phase-shift keyed by a byte sent over and
+    // over, two bits a symbol: each shifts the phase by a quarter turn
+    // Timbre: symbol rate, 2 octaves below the note to 2 above, Color: the
+    // byte
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    uint32_t symbol_increment = ComputePhaseIncrement(
+        pitch_ - 2 * kOctave + (parameter_[0] * 3 >> 4));
+    uint32_t data = static_cast<uint32_t>(parameter_[1]) >> 7;
+
+    for (size_t n = 0; n < size; ++n) {
+        phase_ += increment;
+        phases_[0] += symbol_increment;
+        if (phases_[0] < symbol_increment) {
+            step_ = (step_ + 1) & 3;
+        }
+        uint32_t symbol = (data >> (step_ << 1)) & 3;
+        buffer[n] = Sine(phase_ + (symbol << 30));
+    }
+}
+
+void DigitalOscillator::RenderBowed(int16_t* buffer, size_t size)
+{
+    // String waveguide driven by a bow: the string sticks to the bow while
+    // their speeds are close and slips away when they are not. Half a
+    // period each way, inverted at the ends
+    // Timbre: bow pressure, Color: brightness of the string
+    uint32_t delay = ComputeDelay(pitch_ + kOctave);
+    int32_t pressure = 8192 + (parameter_[0] >> 3);
+    int32_t brightness = std::min<int32_t>(ScaleToRate(8192 + (parameter_[1] >> 1)), 32767);
+    int32_t dc_coefficient = ScaleToRate(64);
+
+    for (size_t n = 0; n < size; ++n) {
+        int32_t delayed = ReadDelay(delay_line_, kDelayLineMask, delay_write_, delay);
+        filter_state_ += (delayed - filter_state_) * brightness >> 15;
+        int32_t string = -(filter_state_ * 32440 >> 15);
+        // Bow speed with a little rosin noise
+        int32_t bow = 8192 + (random_.GetSample() >> 6);
+        int32_t slip = stmlib::Clip16((bow - string) * pressure >> 12);
+        int32_t friction = std::max<int32_t>(32767 - (slip * slip >> 15), 0);
+        int32_t output = stmlib::Clip16(string + ((bow - string) * friction >> 15));
+        delay_line_[delay_write_] = static_cast<int16_t>(output);
+        delay_write_ = (delay_write_ + 1) & kDelayLineMask;
+        dc_state_[0] += (output - dc_state_[0]) * dc_coefficient >> 15;
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16((output - dc_state_[0]) << 1));
+    }
+}
+
+void DigitalOscillator::RenderBlown(int16_t* buffer, size_t size)
+{
+    // Clarinet: a bore waveguide, half a period each way, closed by a reed
+    // that lets breath through as the pressure across it falls
+    // Timbre: breath pressure, Color: reed stiffness
+    // The bore runs at half scale: the pressures add up to more than 1
+    uint32_t delay = ComputeDelay(pitch_ + kOctave);
+    int32_t breath_pressure = 9500 + (parameter_[0] * 3 >> 5);
+    int32_t stiffness = 9011 + (parameter_[1] >> 3);
+    int32_t brightness = std::min<int32_t>(ScaleToRate(16384), 32767);
+    int32_t dc_coefficient = ScaleToRate(64);
+
+    for (size_t n = 0; n < size; ++n) {
+        int32_t breath = breath_pressure + (random_.GetSample() * breath_pressure >> 19);
+        int32_t delayed = ReadDelay(delay_line_, kDelayLineMask, delay_write_, delay);
+        filter_state_ += (delayed - filter_state_) * brightness >> 15;
+        int32_t reflected = -(filter_state_ * 31130 >> 15);
+        int32_t difference = reflected - breath;
+        int32_t reed = std::clamp<int32_t>(22938 - (difference * stiffness >> 14), -32767, 32767);
+        int32_t output = stmlib::Clip16(breath + (difference * reed >> 15));
+        delay_line_[delay_write_] = static_cast<int16_t>(output);
+        delay_write_ = (delay_write_ + 1) & kDelayLineMask;
+        dc_state_[0] += (output - dc_state_[0]) * dc_coefficient >> 15;
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16((output - dc_state_[0]) << 1));
+    }
+}
+
+void DigitalOscillator::RenderFluted(int16_t* buffer, size_t size)
+{
+    // Flute: a jet of breath across a bore, the jet's own delay and its
+    // x^3 - x bend deciding how it drives the bore. The bore is a fifth
+    // below the note and overblown up to it, so below about 70 Hz it no
+    // longer fits the delay line and the lowest notes go out of tune
+    // Timbre: jet length, a quarter to a third of the bore, Color: breath
+    // noise
+    uint32_t delay = ComputeDelay(pitch_ - 7 * 128);
+    uint32_t jet_delay = std::min<uint32_t>(
+        static_cast<uint32_t>(static_cast<uint64_t>(delay) * (8192 + (parameter_[0] * 3604 >> 15)) >> 15),
+        static_cast<uint32_t>(kJetLineSize - 2) << 16);
+    jet_delay = std::max<uint32_t>(jet_delay, 1 << 16);
+    int32_t noise_level = parameter_[1] >> 2;
+    int32_t brightness = std::min<int32_t>(ScaleToRate(10584), 32767);
+    int32_t dc_coefficient = ScaleToRate(64);
+
+    // The bore and jet run at a quarter scale: the breath alone is above 1
+    for (size_t n = 0; n < size; ++n) {
+        int32_t breath = 9011;
+        breath += (random_.GetSample() * noise_level >> 15) * breath >> 15;
+        int32_t delayed = ReadDelay(delay_line_, kDelayLineMask, delay_write_, delay);
+        filter_state_ += (delayed - filter_state_) * brightness >> 15;
+        dc_state_[0] += (filter_state_ - dc_state_[0]) * dc_coefficient >> 15;
+        int32_t reflected = dc_state_[0] - filter_state_;
+
+        jet_line_[jet_write_] = static_cast<int16_t>(stmlib::Clip16(breath - (reflected >> 1)));
+        jet_write_ = (jet_write_ + 1) & kJetLineMask;
+        int32_t jet = ReadDelay(jet_line_, kJetLineMask, jet_write_, jet_delay);
+        jet = std::clamp<int32_t>((((jet * jet >> 13) * jet) >> 13) - jet, -8192, 8192);
+
+        int32_t output = stmlib::Clip16(jet + (reflected >> 1));
+        delay_line_[delay_write_] = static_cast<int16_t>(output);
+        delay_write_ = (delay_write_ + 1) & kDelayLineMask;
+        dc_state_[1] += (output - dc_state_[1]) * dc_coefficient >> 15;
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16((output - dc_state_[1]) << 1));
+    }
+}
+
+void DigitalOscillator::RenderQuestionMark(int16_t* buffer, size_t size)
+{
+    // A question mark in Morse code, beeped at the note
+    // Timbre: speed, units of 120 ms down to 20 ms, Color: tone, from a sine
+    // to a square
+    uint32_t increment = ComputePhaseIncrement(pitch_);
+    // Unit length in samples at 96 kHz, counted in 16.16 at this rate
+    uint32_t unit = static_cast<uint32_t>(1920 + ((32767 - parameter_[0]) * 9600 >> 15)) << 16;
+    int32_t gain = 1 + (parameter_[1] >> 11);
+    int32_t attack = std::min<int32_t>(ScaleToRate(256), 32767);
+    if (strike_) {
+        step_ = 0;
+        hold_counter_ = 0;
+        envelope_ = 0;
+    }
+
+    for (size_t n = 0; n < size; ++n) {
+        hold_counter_ += static_cast<uint32_t>(time_scale_);
+        if (hold_counter_ >= unit) {
+            hold_counter_ %= unit;
+            step_ = (step_ + 1) % kMorseUnits;
+        }
+        int32_t target = kMorseQuestionMark[step_] == '1' ? 32767 : 0;
+        envelope_ += (target - envelope_) * attack >> 15;
+        phase_ += increment;
+        int32_t tone = stmlib::Clip16(Sine(phase_) * gain);
+        buffer[n] = static_cast<int16_t>(tone * envelope_ >> 15);
+    }
+}
+
+} // namespace braids
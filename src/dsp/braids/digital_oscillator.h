@@ -0,0 +1,155 @@
+// Digital oscillator models after those of Mutable Instruments Braids,
+// written for BraidsVST rather than ported
+// BraidsVST: GPL v3
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "../stmlib/stmlib.h"
+#include "../stmlib/random.h"
+#include "resources.h"
+
+namespace braids {
+
+enum DigitalOscillatorShape {
+    OSC_SHAPE_TRIPLE_RING_MOD,
+    OSC_SHAPE_SAW_SWARM,
+    OSC_SHAPE_COMB_FILTER,
+    OSC_SHAPE_TOY,
+    OSC_SHAPE_VOSIM,
+    OSC_SHAPE_HARMONICS,
+    OSC_SHAPE_PLUCKED,
+    OSC_SHAPE_STRUCK_BELL,
+    OSC_SHAPE_STRUCK_DRUM,
+    OSC_SHAPE_KICK,
+    OSC_SHAPE_SNARE,
+    OSC_SHAPE_CYMBAL,
+    OSC_SHAPE_FILTERED_NOISE,
+    OSC_SHAPE_TWIN_PEAKS_NOISE,
+    OSC_SHAPE_CLOCKED_NOISE,
+    OSC_SHAPE_GRANULAR_CLOUD,
+    OSC_SHAPE_PARTICLE_NOISE,
+    OSC_SHAPE_FEEDBACK_FM,
+    OSC_SHAPE_CHAOTIC_FEEDBACK_FM,
+    OSC_SHAPE_ZLPF,
+    OSC_SHAPE_ZPKF,
+    OSC_SHAPE_ZBPF,
+    OSC_SHAPE_ZHPF,
+    OSC_SHAPE_DIGITAL_MODULATION,
+    OSC_SHAPE_BOWED,
+    OSC_SHAPE_BLOWN,
+    OSC_SHAPE_FLUTED,
+    OSC_SHAPE_QUESTION_MARK,
+    OSC_SHAPE_DIGITAL_LAST
+};
+
+static const size_t kNumPartials = 11;   // Struck bell / drum modes
+static const size_t kNumHarmonics = 12;  // Additive harmonics
+static const size_t kNumSwarmVoices = 6;
+static const size_t kNumGrains = 4;
+static const size_t kClockedNoiseSteps = 16;
+static const size_t kDelayLineSize = 2048;  // Comb and string: down to ~47 Hz at 96 kHz
+static const size_t kJetLineSize = 1024;    // Flute jet: at most half the bore
+
+// Chamberlin state variable filter, Q15 coefficients
+struct Svf {
+    int32_t lp;
+    int32_t bp;
+};
+
+class DigitalOscillator {
+public:
+    DigitalOscillator() = default;
+    ~DigitalOscillator() = default;
+
+    // Also strikes the percussive shapes: the next Render starts a new hit
+    void Init();
+
+    // Noise and the random parts of the shapes. Init leaves it alone
+    void Seed(uint32_t seed) { random_.Seed(seed); }
+
+    void set_shape(DigitalOscillatorShape shape) { shape_ = shape; }
+    void set_pitch(int16_t pitch) { pitch_ = pitch; }
+    void set_increments(const uint32_t* increments) { increments_ = increments; }
+    // Rate Render runs at. Decays, grain lengths and one-pole filters are
+    // tuned at 96 kHz and scaled to keep their timing at other rates
+    void set_sample_rate(float sample_rate) {
+        time_scale_ = static_cast<int32_t>(65536.0f * 96000.0f / sample_rate + 0.5f);
+    }
+    void set_parameters(int16_t param1, int16_t param2) {
+        parameter_[0] = param1;
+        parameter_[1] = param2;
+    }
+
+    void Render(const uint8_t* sync, int16_t* buffer, size_t size);
+
+private:
+    void RenderTripleRingMod(int16_t* buffer, size_t size);
+    void RenderSawSwarm(int16_t* buffer, size_t size);
+    void RenderComb(int16_t* buffer, size_t size);
+    void RenderToy(int16_t* buffer, size_t size);
+    void RenderVosim(int16_t* buffer, size_t size);
+    void RenderHarmonics(int16_t* buffer, size_t size);
+    void RenderPlucked(int16_t* buffer, size_t size);
+    void RenderStruck(int16_t* buffer, size_t size);
+    void RenderKick(int16_t* buffer, size_t size);
+    void RenderSnare(int16_t* buffer, size_t size);
+    void RenderCymbal(int16_t* buffer, size_t size);
+    void RenderFilteredNoise(int16_t* buffer, size_t size);
+    void RenderTwinPeaksNoise(int16_t* buffer, size_t size);
+    void RenderClockedNoise(int16_t* buffer, size_t size);
+    void RenderGranularCloud(int16_t* buffer, size_t size);
+    void RenderParticleNoise(int16_t* buffer, size_t size);
+    void RenderFeedbackFm(int16_t* buffer, size_t size);
+    void RenderChaoticFeedbackFm(int16_t* buffer, size_t size);
+    void RenderZFilter(int16_t* buffer, size_t size);
+    void RenderDigitalModulation(int16_t* buffer, size_t size);
+    void RenderBowed(int16_t* buffer, size_t size);
+    void RenderBlown(int16_t* buffer, size_t size);
+    void RenderFluted(int16_t* buffer, size_t size);
+    void RenderQuestionMark(int16_t* buffer, size_t size);
+
+    // Both clamp the pitch to the playable range
+    uint32_t ComputePhaseIncrement(int32_t midi_pitch);
+    // One period at this pitch in samples, 16.16, capped to the delay line
+    uint32_t ComputeDelay(int32_t midi_pitch);
+    // SVF coefficient for a cutoff given as a pitch
+    int32_t SvfCoefficient(int32_t cutoff_pitch);
+    // A per-sample rate or coefficient tuned at 96 kHz, for this rate
+    int32_t ScaleToRate(int32_t value) const {
+        return static_cast<int32_t>(static_cast<int64_t>(value) * time_scale_ >> 16);
+    }
+
+    DigitalOscillatorShape shape_ = OSC_SHAPE_TRIPLE_RING_MOD;
+    int16_t pitch_ = 0;
+    int16_t parameter_[2] = {0, 0};
+    const uint32_t* increments_ = lut_oscillator_increments;
+    int32_t time_scale_ = 65536;  // 96 kHz over the render rate, 16.16
+    stmlib::Random random_;
+
+    bool strike_ = true;
+    uint32_t phase_ = 0;
+    uint32_t phases_[kNumHarmonics] = {};     // Secondary oscillators, modes, grains
+    int32_t amplitudes_[kNumHarmonics] = {};  // Mode levels (Q30), filter coefficients
+    uint32_t grain_increments_[kNumGrains] = {};
+    uint32_t windows_[kNumGrains] = {};       // Grain window phases
+    uint32_t window_increments_[kNumGrains] = {};  // 0 when the grain is idle
+    Svf svf_[2] = {};
+    int32_t filter_state_ = 0;   // One-pole filters
+    int32_t dc_state_[2] = {};   // DC blockers of the waveguides
+    int32_t envelope_ = 0;       // Percussive envelopes, Q30
+    int32_t pitch_envelope_ = 0;
+    int32_t held_sample_ = 0;
+    uint32_t hold_counter_ = 0;
+    int16_t sequence_[kClockedNoiseSteps] = {};
+    size_t step_ = 0;
+    int16_t delay_line_[kDelayLineSize] = {};
+    size_t delay_write_ = 0;
+    int16_t jet_line_[kJetLineSize] = {};
+    size_t jet_write_ = 0;
+
+    DISALLOW_COPY_AND_ASSIGN(DigitalOscillator);
+};
+
+} // namespace braids
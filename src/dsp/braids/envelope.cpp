@@ -34,8 +34,8 @@ uint32_t Envelope::ComputeIncrement(uint16_t time_ms)
         time = 1.0f;
     }
 
-    // Calculate samples needed at 96kHz
-    float samples = time * 96.0f;
+    // Calculate samples needed at 96kHz (or the host rate, see set_sample_rate)
+    float samples = time * samples_per_ms_;
 
     // Calculate increment: 2^32 / samples
     uint32_t increment = static_cast<uint32_t>(4294967296.0f / samples);
@@ -24,6 +24,10 @@ public:
     void Trigger(uint16_t attack, uint16_t decay);
     uint16_t Render();
     bool done() const { return segment_ == ENV_SEGMENT_DEAD; }
+    uint16_t value() const { return value_; }
+
+    // Rate Render() is called at (96 kHz unless rendering at host rate)
+    void set_sample_rate(float sample_rate) { samples_per_ms_ = sample_rate / 1000.0f; }
 
     void set_attack(uint16_t attack) { attack_ = attack; }
     void set_decay(uint16_t decay) { decay_ = decay; }
@@ -37,6 +41,7 @@ private:
     uint16_t attack_ = 0;
     uint16_t decay_ = 0;
     uint16_t value_ = 0;
+    float samples_per_ms_ = 96.0f;
 
     DISALLOW_COPY_AND_ASSIGN(Envelope);
 };
@@ -0,0 +1,264 @@
+// Four-operator FM with selectable algorithms
+// BraidsVST: GPL v3
+
+#include "fm4_oscillator.h"
+#include "../stmlib/dsp.h"
+#include <algorithm>
+#include <cstring>
+
+#if STMLIB_X86
+#include <immintrin.h>
+#endif
+
+namespace braids {
+
+static const uint16_t kHighestNote = 140 * 128;
+static const uint16_t kPitchTableStart = 128 * 128;
+static const uint16_t kOctave = 12 * 128;
+static const int32_t kFeedbackDepth = 8192;  // Operator 4 feedback at full depth, Q15
+
+// Operators are numbered from 0 here; the comments use the DX numbering
+// (operator 1 is the main carrier, operator 4 has feedback). Modulation
+// edges are {from, to}, ratios are in halves of the carrier frequency
+struct Fm4Algorithm {
+    uint8_t num_edges;
+    uint8_t edges[3][2];
+    uint8_t carriers;  // Bit mask
+    uint8_t ratio[kFm4NumOperators];
+};
+
+// The eight algorithms of the 4-operator Yamaha synths
+static const Fm4Algorithm kAlgorithms[kFm4NumAlgorithms] = {
+    {3, {{3, 2}, {2, 1}, {1, 0}}, 0x1, {2, 2, 2, 2}},  // 4 > 3 > 2 > 1
+    {3, {{3, 1}, {2, 1}, {1, 0}}, 0x1, {2, 2, 4, 6}},  // (3 + 4) > 2 > 1
+    {3, {{2, 1}, {1, 0}, {3, 0}}, 0x1, {2, 4, 2, 6}},  // 3 > 2 > 1, 4 > 1
+    {3, {{3, 2}, {2, 0}, {1, 0}}, 0x1, {2, 6, 4, 2}},  // 4 > 3 > 1, 2 > 1
+    {2, {{1, 0}, {3, 2}, {0, 0}}, 0x5, {2, 2, 4, 8}},  // 2 > 1, 4 > 3
+    {3, {{3, 0}, {3, 1}, {3, 2}}, 0x7, {2, 4, 6, 2}},  // 4 > (1, 2, 3)
+    {1, {{3, 2}, {0, 0}, {0, 0}}, 0x7, {2, 4, 6, 2}},  // 4 > 3, 1, 2
+    {0, {{0, 0}, {0, 0}, {0, 0}}, 0xf, {2, 4, 6, 8}},  // 1, 2, 3, 4
+};
+
+// Products are summed in pairs of operators (0 + 1, 2 + 3) before the
+// shift, like the SIMD multiply-add below, so both give the same results
+static inline int32_t PairSum(int32_t a, int32_t ga, int32_t b, int32_t gb)
+{
+    return (a * ga + b * gb) >> 15;
+}
+
+static void RenderOperatorsScalar(Fm4State* state, const Fm4Gains& step,
+                                  int16_t* buffer, size_t size)
+{
+    Fm4Gains& gains = state->gains;
+    const int32_t* out = state->output;
+    for (size_t n = 0; n < size; ++n) {
+        for (size_t k = 0; k < kFm4NumOperators; ++k) {
+            for (size_t j = 0; j < kFm4NumOperators; ++j) {
+                gains.modulation[k][j] += step.modulation[k][j];
+            }
+            gains.carrier[k] += step.carrier[k];
+        }
+
+        int32_t modulation[kFm4NumOperators];
+        for (size_t j = 0; j < kFm4NumOperators; ++j) {
+            modulation[j] = PairSum(out[0], gains.modulation[0][j], out[1], gains.modulation[1][j]) +
+                            PairSum(out[2], gains.modulation[2][j], out[3], gains.modulation[3][j]);
+        }
+        for (size_t j = 0; j < kFm4NumOperators; ++j) {
+            state->phase[j] += state->increment[j];
+            uint32_t phase = state->phase[j] + (static_cast<uint32_t>(modulation[j]) << 17);
+            state->output[j] = stmlib::Interpolate824(wav_sine, phase);
+        }
+        int32_t sum = PairSum(out[0], gains.carrier[0], out[1], gains.carrier[1]) +
+                      PairSum(out[2], gains.carrier[2], out[3], gains.carrier[3]);
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16(sum));
+    }
+}
+
+#if STMLIB_X86
+
+// table[index] in the low half, table[index + 1] in the high half
+static inline int32_t LoadPair(const int16_t* table, int32_t index)
+{
+    int32_t pair;
+    std::memcpy(&pair, table + index, sizeof(pair));
+    return pair;
+}
+
+// Gains from operators k and k + 1 to every operator, interleaved for
+// _mm_madd_epi16: {g[k][0], g[k + 1][0], g[k][1], g[k + 1][1], ...}
+static inline __m128i LoadGainPairs(const int16_t (*modulation)[kFm4NumOperators], size_t k)
+{
+    return _mm_unpacklo_epi16(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(modulation[k])),
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(modulation[k + 1])));
+}
+
+static inline void StoreGainPairs(__m128i pairs, int16_t (*modulation)[kFm4NumOperators], size_t k)
+{
+    __m128i split = _mm_shufflelo_epi16(_mm_shufflehi_epi16(pairs, 0xd8), 0xd8);
+    split = _mm_shuffle_epi32(split, 0xd8);  // k lanes low, k + 1 lanes high
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(modulation[k]), split);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(modulation[k + 1]), _mm_unpackhi_epi64(split, split));
+}
+
+// The four operators are one 128-bit vector, so wider levels use this too.
+// The modulation sums are two 16-bit multiply-adds
+STMLIB_TARGET("sse4.1")
+static void RenderOperatorsSse41(Fm4State* state, const Fm4Gains& step,
+                                 int16_t* buffer, size_t size)
+{
+    const __m128i frac_mask = _mm_set1_epi32(0xffff);
+    __m128i gains_01 = LoadGainPairs(state->gains.modulation, 0);
+    __m128i gains_23 = LoadGainPairs(state->gains.modulation, 2);
+    __m128i step_01 = LoadGainPairs(step.modulation, 0);
+    __m128i step_23 = LoadGainPairs(step.modulation, 2);
+    __m128i carrier = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(state->gains.carrier));
+    __m128i carrier_step = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(step.carrier));
+    __m128i phase = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state->phase));
+    __m128i increment = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state->increment));
+    __m128i output = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state->output));
+    __m128i output_16 = _mm_packs_epi32(output, output);
+
+    for (size_t n = 0; n < size; ++n) {
+        gains_01 = _mm_add_epi16(gains_01, step_01);
+        gains_23 = _mm_add_epi16(gains_23, step_23);
+        carrier = _mm_add_epi16(carrier, carrier_step);
+
+        // Lane j: (out0 * g[0][j] + out1 * g[1][j]) >> 15 + (same for 2, 3)
+        __m128i pm = _mm_add_epi32(
+            _mm_srai_epi32(_mm_madd_epi16(_mm_shuffle_epi32(output_16, 0x00), gains_01), 15),
+            _mm_srai_epi32(_mm_madd_epi16(_mm_shuffle_epi32(output_16, 0x55), gains_23), 15));
+
+        phase = _mm_add_epi32(phase, increment);
+        __m128i lookup_phase = _mm_add_epi32(phase, _mm_slli_epi32(pm, 17));
+        __m128i index = _mm_srli_epi32(lookup_phase, 24);
+        __m128i frac = _mm_and_si128(_mm_srli_epi32(lookup_phase, 8), frac_mask);
+        __m128i pair = _mm_cvtsi32_si128(LoadPair(wav_sine, _mm_cvtsi128_si32(index)));
+        pair = _mm_insert_epi32(pair, LoadPair(wav_sine, _mm_extract_epi32(index, 1)), 1);
+        pair = _mm_insert_epi32(pair, LoadPair(wav_sine, _mm_extract_epi32(index, 2)), 2);
+        pair = _mm_insert_epi32(pair, LoadPair(wav_sine, _mm_extract_epi32(index, 3)), 3);
+        __m128i a = _mm_srai_epi32(_mm_slli_epi32(pair, 16), 16);
+        __m128i b = _mm_srai_epi32(pair, 16);
+        __m128i delta = _mm_srai_epi32(_mm_mullo_epi32(_mm_sub_epi32(b, a), frac), 16);
+        output = _mm_add_epi32(a, delta);
+        output = _mm_srai_epi32(_mm_slli_epi32(output, 16), 16);
+        output_16 = _mm_packs_epi32(output, output);
+
+        // {out0 * c0 + out1 * c1, out2 * c2 + out3 * c3}
+        __m128i mix = _mm_srai_epi32(_mm_madd_epi16(output_16, carrier), 15);
+        int32_t sum = _mm_cvtsi128_si32(mix) + _mm_extract_epi32(mix, 1);
+        buffer[n] = static_cast<int16_t>(stmlib::Clip16(sum));
+    }
+
+    StoreGainPairs(gains_01, state->gains.modulation, 0);
+    StoreGainPairs(gains_23, state->gains.modulation, 2);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(state->gains.carrier), carrier);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state->phase), phase);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state->output), output);
+}
+
+#endif
+
+typedef void (*RenderOperatorsFn)(Fm4State*, const Fm4Gains&, int16_t*, size_t);
+
+static RenderOperatorsFn GetRenderOperators(stmlib::SimdLevel level)
+{
+#if STMLIB_X86
+    if (level >= stmlib::SimdLevel::Sse41) {
+        return RenderOperatorsSse41;
+    }
+#else
+    (void)level;
+#endif
+    return RenderOperatorsScalar;
+}
+
+void Fm4Oscillator::Init()
+{
+    pitch_ = 0;
+    parameter_[0] = 0;
+    parameter_[1] = 0;
+    started_ = false;
+    state_ = {};
+}
+
+uint32_t Fm4Oscillator::ComputePhaseIncrement(int16_t midi_pitch)
+{
+    if (midi_pitch >= kPitchTableStart) {
+        midi_pitch = kPitchTableStart - 1;
+    }
+
+    int32_t ref_pitch = midi_pitch;
+    ref_pitch -= kPitchTableStart;
+
+    size_t num_shifts = 0;
+    while (ref_pitch < 0) {
+        ref_pitch += kOctave;
+        ++num_shifts;
+    }
+
+    uint32_t a = increments_[ref_pitch >> 4];
+    uint32_t b = increments_[(ref_pitch >> 4) + 1];
+    uint32_t phase_increment = a +
+        (static_cast<int32_t>(b - a) * (ref_pitch & 0xf) >> 4);
+    phase_increment >>= num_shifts;
+    return phase_increment;
+}
+
+void Fm4Oscillator::Render(int16_t* buffer, size_t size)
+{
+    static const stmlib::SimdLevel level = stmlib::simd_level();
+    Render(buffer, size, level);
+}
+
+void Fm4Oscillator::Render(int16_t* buffer, size_t size, stmlib::SimdLevel level)
+{
+    if (size == 0) {
+        return;
+    }
+
+    int16_t clamped_pitch = std::clamp<int16_t>(pitch_, 0, kHighestNote);
+    uint32_t increment = ComputePhaseIncrement(clamped_pitch);
+    int32_t depth = std::max<int16_t>(parameter_[0], 0);
+    const Fm4Algorithm& algorithm = kAlgorithms[std::max<int16_t>(parameter_[1], 0) >> 12];
+
+    // Targets for this block; the gains ramp to them sample by sample
+    Fm4Gains target = {};
+    for (size_t i = 0; i < algorithm.num_edges; ++i) {
+        target.modulation[algorithm.edges[i][0]][algorithm.edges[i][1]] = static_cast<int16_t>(depth);
+    }
+    target.modulation[3][3] = static_cast<int16_t>(depth * kFeedbackDepth >> 15);
+
+    int32_t num_carriers = 0;
+    for (size_t j = 0; j < kFm4NumOperators; ++j) {
+        num_carriers += (algorithm.carriers >> j) & 1;
+    }
+    for (size_t j = 0; j < kFm4NumOperators; ++j) {
+        state_.increment[j] = static_cast<uint32_t>(
+            static_cast<uint64_t>(increment) * algorithm.ratio[j] >> 1);
+        target.carrier[j] = static_cast<int16_t>(((algorithm.carriers >> j) & 1) ? 32767 / num_carriers : 0);
+    }
+
+    if (!started_) {
+        state_.gains = target;
+        started_ = true;
+    }
+
+    Fm4Gains step = {};
+    int32_t samples = static_cast<int32_t>(size);
+    for (size_t k = 0; k < kFm4NumOperators; ++k) {
+        for (size_t j = 0; j < kFm4NumOperators; ++j) {
+            step.modulation[k][j] = static_cast<int16_t>(
+                (target.modulation[k][j] - state_.gains.modulation[k][j]) / samples);
+        }
+        step.carrier[k] = static_cast<int16_t>((target.carrier[k] - state_.gains.carrier[k]) / samples);
+    }
+
+    GetRenderOperators(level)(&state_, step, buffer, size);
+
+    // Land exactly on the targets
+    state_.gains = target;
+}
+
+} // namespace braids
@@ -0,0 +1,68 @@
+// Four-operator FM with selectable algorithms
+// BraidsVST: GPL v3
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "../stmlib/stmlib.h"
+#include "../stmlib/cpu.h"
+#include "resources.h"
+
+namespace braids {
+
+static const size_t kFm4NumOperators = 4;
+static const size_t kFm4NumAlgorithms = 8;
+
+// Gains between operators: modulation[k][j] is how much operator k's output
+// moves operator j's phase, Q15 (a full-scale operator at 32767 moves it
+// one cycle). carrier[j] is operator j's share of the output, Q15
+struct Fm4Gains {
+    int16_t modulation[kFm4NumOperators][kFm4NumOperators];
+    int16_t carrier[kFm4NumOperators];
+};
+
+// Operators modulate each other through last sample's outputs, so all four
+// are computed side by side each sample: one 4-wide SIMD step on x86
+struct Fm4State {
+    uint32_t phase[kFm4NumOperators];
+    uint32_t increment[kFm4NumOperators];
+    int32_t output[kFm4NumOperators];  // Last sample of each operator
+    Fm4Gains gains;
+};
+
+class Fm4Oscillator
+{
+public:
+    Fm4Oscillator() = default;
+    ~Fm4Oscillator() = default;
+
+    void Init();
+
+    void set_pitch(int16_t pitch) { pitch_ = pitch; }
+    void set_increments(const uint32_t* increments) { increments_ = increments; }
+    // param1: modulation depth (and operator 4 feedback), param2: algorithm
+    void set_parameters(int16_t param1, int16_t param2) {
+        parameter_[0] = param1;
+        parameter_[1] = param2;
+    }
+
+    void Render(int16_t* buffer, size_t size);
+    // Same, with the operator kernel for one SIMD level (for tests). Levels
+    // above stmlib::simd_level() must not be used
+    void Render(int16_t* buffer, size_t size, stmlib::SimdLevel level);
+
+private:
+    uint32_t ComputePhaseIncrement(int16_t midi_pitch);
+
+    const uint32_t* increments_ = lut_oscillator_increments;
+    int16_t pitch_ = 0;
+    int16_t parameter_[2] = {0, 0};
+    bool started_ = false;  // Gains ramp from the last block once running
+
+    Fm4State state_ = {};
+
+    DISALLOW_COPY_AND_ASSIGN(Fm4Oscillator);
+};
+
+} // namespace braids
@@ -5,17 +5,22 @@
 #include "fm_oscillator.h"
 #include "resources.h"
 #include "../stmlib/dsp.h"
+#include <algorithm>
 
 namespace braids {
 
 static const uint16_t kHighestNote = 140 * 128;
 static const uint16_t kPitchTableStart = 128 * 128;
 static const uint16_t kOctave = 12 * 128;
+static const size_t kLookupBlockSize = 32;  // Table lookups are batched this many at a time
 
 void FmOscillator::Init()
 {
     phase_ = 0;
     modulator_phase_ = 0;
+    modulator_phase_increment_ = 0;
+    modulator_history_[0] = 0;
+    modulator_history_[1] = 0;
     pitch_ = 0;
     parameter_[0] = 0;
     parameter_[1] = 0;
@@ -38,8 +43,8 @@ uint32_t FmOscillator::ComputePhaseIncrement(int16_t midi_pitch)
         ++num_shifts;
     }
 
-    uint32_t a = lut_oscillator_increments[ref_pitch >> 4];
-    uint32_t b = lut_oscillator_increments[(ref_pitch >> 4) + 1];
+    uint32_t a = increments_[ref_pitch >> 4];
+    uint32_t b = increments_[(ref_pitch >> 4) + 1];
     uint32_t phase_increment = a +
         (static_cast<int32_t>(b - a) * (ref_pitch & 0xf) >> 4);
     phase_increment >>= num_shifts;
@@ -48,6 +53,10 @@ uint32_t FmOscillator::ComputePhaseIncrement(int16_t midi_pitch)
 
 void FmOscillator::Render(int16_t* buffer, size_t size)
 {
+    if (size == 0) {
+        return;
+    }
+
     uint32_t phase_increment = ComputePhaseIncrement(pitch_);
 
     // Clamp pitch
@@ -58,28 +67,63 @@ void FmOscillator::Render(int16_t* buffer, size_t size)
         clamped_pitch = 0;
     }
 
+    // Modulator pitch: the ratio parameter snaps to musical ratios. The
+    // increment ramps to it over the block, except right after Init
+    int32_t ratio = stmlib::Interpolate824(lut_fm_frequency_quantizer,
+        static_cast<uint32_t>(std::max<int16_t>(parameter_[1], 0)) << 16);
+    uint32_t target_increment = ComputePhaseIncrement(static_cast<int16_t>(
+        std::clamp<int32_t>(clamped_pitch + ratio, 0, 32767)));
+    if (modulator_phase_increment_ == 0) {
+        modulator_phase_increment_ = target_increment;
+    }
     uint32_t modulator_phase = modulator_phase_;
-    uint32_t modulator_phase_increment = ComputePhaseIncrement(
-        (12 << 7) + clamped_pitch + ((parameter_[1] - 16384) >> 1)) >> 1;
+    uint32_t modulator_phase_increment = modulator_phase_increment_;
+    uint32_t modulator_phase_increment_step = static_cast<uint32_t>(
+        (static_cast<int64_t>(target_increment) - modulator_phase_increment) /
+        static_cast<int64_t>(size));
 
     // Parameter interpolation
     int32_t parameter_0 = previous_parameter_[0];
     int32_t parameter_0_increment =
         (parameter_[0] - previous_parameter_[0]) / static_cast<int32_t>(size);
-
-    while (size--) {
-        parameter_0 += parameter_0_increment;
-
-        phase_ += phase_increment;
-        modulator_phase += modulator_phase_increment;
-
-        uint32_t pm = (stmlib::Interpolate824(wav_sine, modulator_phase) *
-                       parameter_0) << 2;
-        *buffer++ = stmlib::Interpolate824(wav_sine, phase_ + pm);
+    int32_t feedback_amount = feedback_ >> 1;
+
+    int32_t history_0 = modulator_history_[0];
+    int32_t history_1 = modulator_history_[1];
+
+    uint32_t phases[kLookupBlockSize];
+
+    while (size) {
+        size_t chunk = std::min(size, kLookupBlockSize);
+
+        // The modulator depends on its own last output, so it runs sample by
+        // sample; the carrier lookups are batched after it. Feedback uses the
+        // mean of the last two outputs, which keeps it from ringing at Nyquist
+        for (size_t i = 0; i < chunk; ++i) {
+            parameter_0 += parameter_0_increment;
+            modulator_phase_increment += modulator_phase_increment_step;
+            modulator_phase += modulator_phase_increment;
+            uint32_t feedback = static_cast<uint32_t>(
+                (history_0 + history_1) * feedback_amount);
+            int32_t modulator = stmlib::Interpolate824(wav_sine, modulator_phase + feedback);
+            history_1 = history_0;
+            history_0 = modulator;
+
+            phase_ += phase_increment;
+            uint32_t pm = (modulator * parameter_0) << 2;
+            phases[i] = phase_ + pm;
+        }
+        stmlib::Interpolate824Block(wav_sine, phases, buffer, chunk);
+
+        buffer += chunk;
+        size -= chunk;
     }
 
     previous_parameter_[0] = parameter_[0];
     modulator_phase_ = modulator_phase;
+    modulator_phase_increment_ = target_increment;
+    modulator_history_[0] = history_0;
+    modulator_history_[1] = history_1;
 }
 
 } // namespace braids
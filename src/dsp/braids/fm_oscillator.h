@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <cstring>
 #include "../stmlib/stmlib.h"
+#include "resources.h"
 
 namespace braids {
 
@@ -19,21 +20,31 @@ public:
     void Init();
 
     void set_pitch(int16_t pitch) { pitch_ = pitch; }
+    // Phase increment table for the render rate (see OscillatorIncrements)
+    void set_increments(const uint32_t* increments) { increments_ = increments; }
     void set_parameters(int16_t param1, int16_t param2) {
         parameter_[0] = param1;
         parameter_[1] = param2;
     }
+    // How much of the modulator feeds back into its own phase, 0 (off) to
+    // 32767. Init leaves it alone
+    void set_feedback(int16_t feedback) { feedback_ = feedback; }
 
     void Render(int16_t* buffer, size_t size);
 
 private:
     uint32_t ComputePhaseIncrement(int16_t midi_pitch);
 
+    const uint32_t* increments_ = lut_oscillator_increments;
+
     uint32_t phase_ = 0;
     uint32_t modulator_phase_ = 0;
+    uint32_t modulator_phase_increment_ = 0;  // Ramped towards the ratio each block
+    int32_t modulator_history_[2] = {0, 0};   // Last two modulator outputs, for feedback
     int16_t pitch_ = 0;
     int16_t parameter_[2] = {0, 0};
     int16_t previous_parameter_[2] = {0, 0};
+    int16_t feedback_ = 0;
 
     DISALLOW_COPY_AND_ASSIGN(FmOscillator);
 };
@@ -12,7 +12,11 @@ void MacroOscillator::Init()
 {
     analog_oscillator_[0].Init();
     analog_oscillator_[1].Init();
+    analog_oscillator_[2].Init();
     fm_oscillator_.Init();
+    fm4_oscillator_.Init();
+    digital_oscillator_.Init();
+    wavetable_oscillator_.Init();
     shape_ = MACRO_OSC_SHAPE_FM;
     pitch_ = 0;
     parameter_[0] = 0;
@@ -21,6 +25,8 @@ void MacroOscillator::Init()
 
     for (size_t i = 0; i < 128; ++i) {
         temp_buffer_[i] = 0;
+        temp_buffer_2_[i] = 0;
+        sync_buffer_[i] = 0;
     }
 }
 
@@ -57,6 +63,56 @@ void MacroOscillator::Render(const uint8_t* sync, int16_t* buffer, size_t size)
             RenderSync(sync, buffer, size);
             break;
 
+        case MACRO_OSC_SHAPE_FM4:
+            fm4_oscillator_.set_pitch(pitch_);
+            fm4_oscillator_.set_parameters(parameter_[0], parameter_[1]);
+            fm4_oscillator_.Render(buffer, size);
+            break;
+
+        case MACRO_OSC_SHAPE_TRIPLE_SAW:
+        case MACRO_OSC_SHAPE_TRIPLE_SQUARE:
+        case MACRO_OSC_SHAPE_TRIPLE_TRIANGLE:
+        case MACRO_OSC_SHAPE_TRIPLE_SINE:
+            RenderTriple(sync, buffer, size);
+            break;
+
+        case MACRO_OSC_SHAPE_TRIPLE_RING_MOD:
+        case MACRO_OSC_SHAPE_SAW_SWARM:
+        case MACRO_OSC_SHAPE_SAW_COMB:
+        case MACRO_OSC_SHAPE_TOY:
+        case MACRO_OSC_SHAPE_VOSIM:
+        case MACRO_OSC_SHAPE_HARMONICS:
+        case MACRO_OSC_SHAPE_PLUCKED:
+        case MACRO_OSC_SHAPE_STRUCK_BELL:
+        case MACRO_OSC_SHAPE_STRUCK_DRUM:
+        case MACRO_OSC_SHAPE_KICK:
+        case MACRO_OSC_SHAPE_SNARE:
+        case MACRO_OSC_SHAPE_CYMBAL:
+        case MACRO_OSC_SHAPE_FILTERED_NOISE:
+        case MACRO_OSC_SHAPE_TWIN_PEAKS_NOISE:
+        case MACRO_OSC_SHAPE_CLOCKED_NOISE:
+        case MACRO_OSC_SHAPE_GRANULAR_CLOUD:
+        case MACRO_OSC_SHAPE_PARTICLE_NOISE:
+        case MACRO_OSC_SHAPE_FEEDBACK_FM:
+        case MACRO_OSC_SHAPE_CHAOTIC_FEEDBACK_FM:
+        case MACRO_OSC_SHAPE_ZLPF:
+        case MACRO_OSC_SHAPE_ZPKF:
+        case MACRO_OSC_SHAPE_ZBPF:
+        case MACRO_OSC_SHAPE_ZHPF:
+        case MACRO_OSC_SHAPE_DIGITAL_MODULATION:
+        case MACRO_OSC_SHAPE_BOWED:
+        case MACRO_OSC_SHAPE_BLOWN:
+        case MACRO_OSC_SHAPE_FLUTED:
+        case MACRO_OSC_SHAPE_QUESTION_MARK:
+            RenderDigital(sync, buffer, size);
+            break;
+
+        case MACRO_OSC_SHAPE_WAVETABLE:
+            wavetable_oscillator_.set_pitch(pitch_);
+            wavetable_oscillator_.set_parameters(parameter_[0], parameter_[1]);
+            wavetable_oscillator_.Render(buffer, size);
+            break;
+
         case MACRO_OSC_SHAPE_FM:
         default:
             fm_oscillator_.set_pitch(pitch_);
@@ -100,7 +156,7 @@ void MacroOscillator::RenderMorph(const uint8_t* sync, int16_t* buffer, size_t s
     } else {
         // Square with PWM (66-100%)
         analog_oscillator_[0].set_shape(OSC_SHAPE_SQUARE);
-        analog_oscillator_[0].set_parameter((parameter_[0] - 21846) * 3);
+        analog_oscillator_[0].set_parameter(static_cast<int16_t>((parameter_[0] - 21846) * 3));
         analog_oscillator_[1].set_shape(OSC_SHAPE_SQUARE);
         balance = 0;  // Just use first oscillator with PWM
     }
@@ -137,11 +193,9 @@ void MacroOscillator::RenderMorph(const uint8_t* sync, int16_t* buffer, size_t s
         if (lp_state_ > 32767) lp_state_ = 32767;
         if (lp_state_ < -32768) lp_state_ = -32768;
 
-        // Apply overdrive
-        int32_t shifted = lp_state_ + 32768;
-        int32_t index = shifted >> 8;
-        if (index > 256) index = 256;
-        int16_t fuzzed = ws_violent_overdrive[index];
+        // Apply overdrive, interpolating between table entries
+        int16_t fuzzed = stmlib::Interpolate88(ws_violent_overdrive,
+                                               static_cast<uint16_t>(lp_state_ + 32768));
 
         buffer[i] = stmlib::Mix(static_cast<int16_t>(lp_state_), fuzzed, static_cast<uint16_t>(fuzz_amount));
     }
@@ -287,24 +341,11 @@ void MacroOscillator::RenderSync(const uint8_t* sync, int16_t* buffer, size_t si
     analog_oscillator_[1].set_pitch(slave_pitch);
     analog_oscillator_[1].set_shape(is_square ? OSC_SHAPE_SQUARE : OSC_SHAPE_SAW);
 
-    // Generate sync signal from master
-    uint8_t sync_buffer[128];
-    for (size_t i = 0; i < size; ++i) {
-        sync_buffer[i] = 0;
-    }
-
-    // Render master to generate sync points
-    analog_oscillator_[0].Render(sync, temp_buffer_, size);
-
-    // Simple sync detection: look for zero crossings in master
-    for (size_t i = 1; i < size; ++i) {
-        if (temp_buffer_[i-1] < 0 && temp_buffer_[i] >= 0) {
-            sync_buffer[i] = 1;
-        }
-    }
+    // The master marks where it wraps, to a fraction of a sample
+    analog_oscillator_[0].Render(sync, temp_buffer_, sync_buffer_, size);
 
     // Render slave with sync
-    analog_oscillator_[1].Render(sync_buffer, buffer, size);
+    analog_oscillator_[1].Render(sync_buffer_, buffer, size);
 
     // Apply waveshaping based on color
     if (parameter_[1] > 0) {
@@ -318,4 +359,47 @@ void MacroOscillator::RenderSync(const uint8_t* sync, int16_t* buffer, size_t si
     }
 }
 
+void MacroOscillator::RenderTriple(const uint8_t* sync, int16_t* buffer, size_t size)
+{
+    // Three oscillators of one waveform, playing a chord
+    // Timbre, Color: intervals of the second and third, -12 to +12
+    // semitones, snapped to the semitone
+    static const AnalogOscillatorShape kTripleShapes[4] = {
+        OSC_SHAPE_SAW, OSC_SHAPE_SQUARE, OSC_SHAPE_TRIANGLE, OSC_SHAPE_SINE
+    };
+    AnalogOscillatorShape shape = kTripleShapes[shape_ - MACRO_OSC_SHAPE_TRIPLE_SAW];
+
+    analog_oscillator_[0].set_pitch(pitch_);
+    for (size_t i = 0; i < 3; ++i) {
+        analog_oscillator_[i].set_shape(shape);
+    }
+    for (size_t i = 1; i < 3; ++i) {
+        int32_t semitones = (parameter_[i - 1] * 25 >> 15) - 12;
+        analog_oscillator_[i].set_pitch(static_cast<int16_t>(pitch_ + (semitones << 7)));
+    }
+
+    analog_oscillator_[0].Render(sync, buffer, size);
+    analog_oscillator_[1].Render(sync, temp_buffer_, size);
+    analog_oscillator_[2].Render(sync, temp_buffer_2_, size);
+
+    for (size_t i = 0; i < size; ++i) {
+        int32_t sum = buffer[i] + temp_buffer_[i] + temp_buffer_2_[i];
+        buffer[i] = static_cast<int16_t>(sum * 21845 >> 16);  // 1/3
+    }
+}
+
+void MacroOscillator::RenderDigital(const uint8_t* sync, int16_t* buffer, size_t size)
+{
+    // The digital shapes are in the same order as their macro shapes, which
+    // have the wavetable in between
+    int index = shape_ - MACRO_OSC_SHAPE_TRIPLE_RING_MOD;
+    if (shape_ > MACRO_OSC_SHAPE_WAVETABLE) {
+        --index;
+    }
+    digital_oscillator_.set_shape(static_cast<DigitalOscillatorShape>(index));
+    digital_oscillator_.set_pitch(pitch_);
+    digital_oscillator_.set_parameters(parameter_[0], parameter_[1]);
+    digital_oscillator_.Render(sync, buffer, size);
+}
+
 } // namespace braids
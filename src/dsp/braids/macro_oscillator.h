@@ -8,6 +8,9 @@
 #include "../stmlib/stmlib.h"
 #include "analog_oscillator.h"
 #include "fm_oscillator.h"
+#include "fm4_oscillator.h"
+#include "digital_oscillator.h"
+#include "wavetable_oscillator.h"
 
 namespace braids {
 
@@ -22,6 +25,40 @@ enum MacroOscillatorShape {
     MACRO_OSC_SHAPE_SQUARE_SYNC,    // 7 - Hard sync square
     MACRO_OSC_SHAPE_SAW_SYNC,       // 8 - Hard sync saw
     MACRO_OSC_SHAPE_FM,             // 9 - FM
+    MACRO_OSC_SHAPE_FM4,            // 10 - 4-operator FM
+    MACRO_OSC_SHAPE_TRIPLE_SAW,     // 11 - Three saws, chord intervals
+    MACRO_OSC_SHAPE_TRIPLE_SQUARE,  // 12 - Three squares
+    MACRO_OSC_SHAPE_TRIPLE_TRIANGLE,// 13 - Three triangles
+    MACRO_OSC_SHAPE_TRIPLE_SINE,    // 14 - Three sines
+    MACRO_OSC_SHAPE_TRIPLE_RING_MOD,// 15 - Three ring-modulated sines
+    MACRO_OSC_SHAPE_SAW_SWARM,      // 16 - Six detuned saws
+    MACRO_OSC_SHAPE_SAW_COMB,       // 17 - Saw through a comb filter
+    MACRO_OSC_SHAPE_TOY,            // 18 - Lo-fi 8-bit
+    MACRO_OSC_SHAPE_VOSIM,          // 19 - VOSIM formants
+    MACRO_OSC_SHAPE_HARMONICS,      // 20 - Additive harmonics
+    MACRO_OSC_SHAPE_PLUCKED,        // 21 - Plucked string
+    MACRO_OSC_SHAPE_STRUCK_BELL,    // 22 - Struck bell
+    MACRO_OSC_SHAPE_STRUCK_DRUM,    // 23 - Struck drum
+    MACRO_OSC_SHAPE_KICK,           // 24 - Kick drum
+    MACRO_OSC_SHAPE_SNARE,          // 25 - Snare drum
+    MACRO_OSC_SHAPE_CYMBAL,         // 26 - Cymbal
+    MACRO_OSC_SHAPE_FILTERED_NOISE, // 27 - Resonant filtered noise
+    MACRO_OSC_SHAPE_TWIN_PEAKS_NOISE, // 28 - Noise through two band-passes
+    MACRO_OSC_SHAPE_CLOCKED_NOISE,  // 29 - Sample-and-hold noise
+    MACRO_OSC_SHAPE_GRANULAR_CLOUD, // 30 - Sine grains
+    MACRO_OSC_SHAPE_PARTICLE_NOISE, // 31 - Ringing particles
+    MACRO_OSC_SHAPE_WAVETABLE,      // 32 - Wavetable bank loaded from disk
+    MACRO_OSC_SHAPE_FEEDBACK_FM,    // 33 - FM, output fed back into the modulator phase
+    MACRO_OSC_SHAPE_CHAOTIC_FEEDBACK_FM, // 34 - FM, output fed back into the modulator pitch
+    MACRO_OSC_SHAPE_ZLPF,           // 35 - Phase distortion resonance, saw window
+    MACRO_OSC_SHAPE_ZPKF,           // 36 - Phase distortion resonance, triangle window
+    MACRO_OSC_SHAPE_ZBPF,           // 37 - Phase distortion resonance, sine window
+    MACRO_OSC_SHAPE_ZHPF,           // 38 - Phase distortion resonance, pulse window
+    MACRO_OSC_SHAPE_DIGITAL_MODULATION, // 39 - Phase-shift keyed carrier
+    MACRO_OSC_SHAPE_BOWED,          // 40 - Bowed string waveguide
+    MACRO_OSC_SHAPE_BLOWN,          // 41 - Reed and bore waveguide
+    MACRO_OSC_SHAPE_FLUTED,         // 42 - Jet and bore waveguide
+    MACRO_OSC_SHAPE_QUESTION_MARK,  // 43 - Morse code question mark
     MACRO_OSC_SHAPE_LAST
 };
 
@@ -36,6 +73,22 @@ public:
     MacroOscillatorShape shape() const { return shape_; }
 
     void set_pitch(int16_t pitch) { pitch_ = pitch; }
+    void set_increments(const uint32_t* increments) {
+        analog_oscillator_[0].set_increments(increments);
+        analog_oscillator_[1].set_increments(increments);
+        analog_oscillator_[2].set_increments(increments);
+        fm_oscillator_.set_increments(increments);
+        fm4_oscillator_.set_increments(increments);
+        digital_oscillator_.set_increments(increments);
+        wavetable_oscillator_.set_increments(increments);
+    }
+    // Modulator self-feedback of the FM shape, 0 (off) to 32767
+    void set_fm_feedback(int16_t feedback) { fm_oscillator_.set_feedback(feedback); }
+    // Render rate, for the digital shapes' time constants
+    void set_sample_rate(float sample_rate) { digital_oscillator_.set_sample_rate(sample_rate); }
+    void set_wavetable(const WavetableBank* bank) { wavetable_oscillator_.set_bank(bank); }
+    // Seeds the noise of the digital shapes
+    void Seed(uint32_t seed) { digital_oscillator_.Seed(seed); }
     void set_parameters(int16_t p1, int16_t p2) {
         parameter_[0] = p1;
         parameter_[1] = p2;
@@ -52,17 +105,25 @@ private:
     void RenderBuzz(const uint8_t* sync, int16_t* buffer, size_t size);
     void RenderSub(const uint8_t* sync, int16_t* buffer, size_t size);
     void RenderSync(const uint8_t* sync, int16_t* buffer, size_t size);
+    void RenderTriple(const uint8_t* sync, int16_t* buffer, size_t size);
+    void RenderDigital(const uint8_t* sync, int16_t* buffer, size_t size);
 
     MacroOscillatorShape shape_ = MACRO_OSC_SHAPE_FM;
     int16_t pitch_ = 0;
     int16_t parameter_[2] = {0, 0};
 
-    // Two analog oscillators for mixing/morphing
-    AnalogOscillator analog_oscillator_[2];
+    // Analog oscillators for mixing/morphing, three for the chord shapes
+    AnalogOscillator analog_oscillator_[3];
     FmOscillator fm_oscillator_;
+    Fm4Oscillator fm4_oscillator_;
+    DigitalOscillator digital_oscillator_;
+    WavetableOscillator wavetable_oscillator_;
 
-    // Temp buffer for mixing two oscillators
+    // Temp buffers for mixing oscillators
     int16_t temp_buffer_[128];
+    int16_t temp_buffer_2_[128];
+    // Sync from master to slave, rewritten in full by every render
+    uint8_t sync_buffer_[128];
 
     // Filter state for morph shape
     int32_t lp_state_ = 0;
@@ -9,24 +9,38 @@
 
 namespace braids {
 
+// Tables are generated at compile time, see resources.cpp and
+// table_generators.h
+
 // Sine wavetable (257 entries for interpolation)
-extern const int16_t wav_sine[];
+extern const int16_t* const wav_sine;
 extern const size_t WAV_SINE_SIZE;
 
-// Oscillator phase increment lookup table
-extern const uint32_t lut_oscillator_increments[];
+// Oscillator phase increment lookup table (96kHz)
+extern const uint32_t* const lut_oscillator_increments;
 extern const size_t LUT_OSCILLATOR_INCREMENTS_SIZE;
 
-// FM frequency quantizer
-extern const int16_t lut_fm_frequency_quantizer[];
+// Phase increment table for another render rate (44.1, 48, 88.2 or 96kHz),
+// nullptr if there is none
+const uint32_t* OscillatorIncrements(double sample_rate);
+
+// FM ratio quantizer: modulator pitch offset (128 per semitone) over the
+// ratio parameter, flat around musical ratios. 128 segments plus a guard
+extern const int16_t* const lut_fm_frequency_quantizer;
 extern const size_t LUT_FM_FREQUENCY_QUANTIZER_SIZE;
 
-// Waveshaping tables (257 entries each)
-extern const int16_t ws_sine_fold[];
-extern const int16_t ws_tri_fold[];
+// Waveshaping table (257 entries)
 extern const int16_t ws_violent_overdrive[];
 
+// Fold waveshapers with mip levels (kWsTableSize + 1 entries each). Level n
+// is smoothed over 2^n table steps, see resources.cpp
+static const size_t kWsTableBits = 10;
+static const size_t kWsTableSize = 1 << kWsTableBits;
+static const size_t kWsNumMips = 8;
+extern const int16_t* const ws_sine_fold_mips[kWsNumMips];
+extern const int16_t* const ws_tri_fold_mips[kWsNumMips];
+
 // SVF filter cutoff coefficient table
-extern const int16_t lut_svf_cutoff[];
+extern const int16_t* const lut_svf_cutoff;
 
 } // namespace braids
@@ -0,0 +1,207 @@
+// Compile-time generators for the lookup tables in resources.cpp
+// BraidsVST: GPL v3
+//
+// Everything here is constexpr, so the tables are built by the compiler and
+// land in read-only data: nothing runs at startup. Sizes, precisions and
+// sample rates are template parameters, so another resolution or internal
+// rate is a one-line instantiation instead of a pasted block of numbers.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace braids {
+namespace tables {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// constexpr stand-ins for <cmath> (not constexpr before C++26), accurate to
+// double precision over the ranges used by the tables
+
+constexpr double Floor(double x)
+{
+    double truncated = static_cast<double>(static_cast<int64_t>(x));
+    return truncated > x ? truncated - 1.0 : truncated;
+}
+
+constexpr double Round(double x)
+{
+    return Floor(x + 0.5);
+}
+
+constexpr double Cos(double x)
+{
+    x -= 2.0 * kPi * Floor(x / (2.0 * kPi) + 0.5);  // -pi..pi
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 24; ++n) {
+        term *= -x * x / ((2.0 * n - 1.0) * (2.0 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double Sin(double x)
+{
+    return Cos(x - kPi / 2.0);
+}
+
+constexpr double Exp2(double x)
+{
+    double whole = Floor(x);
+    double y = (x - whole) * 0.69314718055994530942;  // ln 2
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 24; ++n) {
+        term *= y / n;
+        sum += term;
+    }
+    for (; whole > 0.0; whole -= 1.0) sum *= 2.0;
+    for (; whole < 0.0; whole += 1.0) sum *= 0.5;
+    return sum;
+}
+
+constexpr double Log2(double x)
+{
+    double whole = 0.0;
+    for (; x >= 2.0; x *= 0.5) whole += 1.0;
+    for (; x < 1.0; x *= 2.0) whole -= 1.0;
+    // ln(x) = 2 * atanh((x - 1) / (x + 1)), x in 1..2
+    double z = (x - 1.0) / (x + 1.0);
+    double power = z;
+    double sum = 0.0;
+    for (int n = 1; n < 60; n += 2) {
+        sum += power / n;
+        power *= z * z;
+    }
+    return whole + 2.0 * sum * 1.44269504088896340736;  // 1 / ln 2
+}
+
+template <typename T, size_t Size>
+struct Table {
+    T data[Size];
+    static constexpr size_t size = Size;
+};
+
+// Mip levels of a Size-segment table (Size + 1 entries each)
+template <size_t Size, size_t NumMips>
+struct MipTable {
+    int16_t data[NumMips][Size + 1];
+};
+
+// Saturating conversion to a signed integer of Bits bits
+template <int Bits = 16>
+constexpr int16_t ToFixed(double value)
+{
+    constexpr double kMax = static_cast<double>((1 << (Bits - 1)) - 1);
+    double scaled = Round(value);
+    return static_cast<int16_t>(scaled > kMax ? kMax : (scaled < -kMax ? -kMax : scaled));
+}
+
+// One sine cycle in Size segments plus a wraparound entry, full scale for
+// Bits bits: sin(2 * pi * i / Size) * (2^(Bits - 1) - 1)
+template <size_t Size, int Bits = 16>
+constexpr Table<int16_t, Size + 1> MakeSine()
+{
+    constexpr double kScale = static_cast<double>((1 << (Bits - 1)) - 1);
+    Table<int16_t, Size + 1> table = {};
+    for (size_t i = 0; i <= Size; ++i) {
+        table.data[i] = ToFixed<Bits>(Sin(2.0 * kPi * static_cast<double>(i) / Size) * kScale);
+    }
+    return table;
+}
+
+// Phase increments (2^32 per cycle) at SampleRate for the octave above note
+// 128 (pitch 128 * 128, 13289.75 Hz), in StepsPerOctave steps plus one:
+// floor(2^32 * 13289.75 * 2^(i / StepsPerOctave) / SampleRate)
+template <uint32_t SampleRate, size_t StepsPerOctave = 96>
+constexpr Table<uint32_t, StepsPerOctave + 1> MakeOscillatorIncrements()
+{
+    const double note_128 = 440.0 * Exp2(59.0 / 12.0);
+    Table<uint32_t, StepsPerOctave + 1> table = {};
+    for (size_t i = 0; i <= StepsPerOctave; ++i) {
+        double frequency = note_128 * Exp2(static_cast<double>(i) / StepsPerOctave);
+        double increment = 4294967296.0 * frequency / SampleRate;
+        table.data[i] = static_cast<uint32_t>(Floor(increment < 4294967295.0 ? increment : 4294967295.0));
+    }
+    return table;
+}
+
+// Exponential curve: Base * 2^(i / StepsPerOctave), saturated to 16 bits
+template <size_t Size, int Base, int StepsPerOctave>
+constexpr Table<int16_t, Size> MakeExponential()
+{
+    Table<int16_t, Size> table = {};
+    for (size_t i = 0; i < Size; ++i) {
+        table.data[i] = ToFixed(Base * Exp2(static_cast<double>(i) / StepsPerOctave));
+    }
+    return table;
+}
+
+// FM ratio quantizer, as in the original Braids: each ratio becomes a
+// plateau of three entries (in pitch units, 128 per semitone), then the
+// widest gap is split until there are Size entries, plus a guard entry
+template <size_t Size, size_t NumRatios>
+constexpr Table<int16_t, Size + 1> MakeRatioQuantizer(const double (&ratios)[NumRatios])
+{
+    static_assert(NumRatios * 3 <= Size, "too many ratios for the table");
+    double scale[Size] = {};
+    size_t count = 0;
+    for (size_t i = 0; i < NumRatios; ++i) {
+        double semitones = 12.0 * Log2(ratios[i]);
+        scale[count++] = semitones;
+        scale[count++] = semitones;
+        scale[count++] = semitones;
+    }
+    while (count < Size) {
+        size_t gap = 0;
+        for (size_t i = 1; i + 1 < count; ++i) {
+            if (scale[i + 1] - scale[i] > scale[gap + 1] - scale[gap]) gap = i;
+        }
+        for (size_t i = count; i > gap + 1; --i) scale[i] = scale[i - 1];
+        scale[gap + 1] = (scale[gap] + scale[gap + 2]) / 2.0;
+        ++count;
+    }
+
+    Table<int16_t, Size + 1> table = {};
+    for (size_t i = 0; i < Size; ++i) {
+        table.data[i] = ToFixed(scale[i] * 128.0);
+    }
+    table.data[Size] = table.data[Size - 1];
+    return table;
+}
+
+// Waveshaper over an input of -1..1 in Size segments. curve maps -1..1 to
+// -1..1. Mip level n is the curve averaged over 2^n table steps (trapezoid,
+// flat past the ends like a clamped input)
+template <size_t Size, size_t NumMips, typename Curve>
+constexpr MipTable<Size, NumMips> MakeWaveshaperMips(Curve curve)
+{
+    double raw[Size + 1] = {};
+    for (size_t i = 0; i <= Size; ++i) {
+        raw[i] = curve(2.0 * static_cast<double>(i) / Size - 1.0);
+    }
+
+    MipTable<Size, NumMips> mips = {};
+    for (size_t level = 0; level < NumMips; ++level) {
+        const int half = (1 << level) / 2;
+        for (int i = 0; i <= static_cast<int>(Size); ++i) {
+            double value = raw[i];
+            if (half > 0) {
+                value = 0.0;
+                for (int j = i - half; j <= i + half; ++j) {
+                    int k = j < 0 ? 0 : (j > static_cast<int>(Size) ? static_cast<int>(Size) : j);
+                    double weight = (j == i - half || j == i + half) ? 0.5 : 1.0;
+                    value += raw[k] * weight;
+                }
+                value /= 2.0 * half;
+            }
+            mips.data[level][i] = ToFixed(value * 32767.0);
+        }
+    }
+    return mips;
+}
+
+} // namespace tables
+} // namespace braids
@@ -0,0 +1,257 @@
+// Wavetable banks loaded from disk
+// BraidsVST: GPL v3
+
+#include "wavetable_bank.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace braids {
+
+namespace {
+
+// Banks alive in this process, by path, size and modification time, so a
+// file saved again under the same name loads afresh
+using RegistryKey = std::tuple<std::string, uint64_t, int64_t>;
+std::mutex registry_mutex;
+std::map<RegistryKey, std::weak_ptr<const WavetableBank>> registry;
+
+// Size and modification time (in the platform's own units) of a file
+bool StatFile(const std::string& path, uint64_t* size, int64_t* modified)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA info;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &info)) {
+        return false;
+    }
+    *size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+    *modified = static_cast<int64_t>((static_cast<uint64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) |
+                                     info.ftLastWriteTime.dwLowDateTime);
+#else
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+    *size = static_cast<uint64_t>(info.st_size);
+#ifdef __APPLE__
+    const struct timespec& time = info.st_mtimespec;
+#else
+    const struct timespec& time = info.st_mtim;
+#endif
+    *modified = static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+#endif
+    return true;
+}
+
+uint32_t ReadLe32(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint16_t ReadLe16(const uint8_t* p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+} // namespace
+
+std::shared_ptr<const WavetableBank> WavetableBank::Load(const std::string& path)
+{
+    uint64_t size = 0;
+    int64_t modified = 0;
+    if (!StatFile(path, &size, &modified)) {
+        return nullptr;
+    }
+    RegistryKey key(path, size, modified);
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        auto found = registry.find(key);
+        if (found != registry.end()) {
+            if (auto bank = found->second.lock()) {
+                return bank;
+            }
+        }
+    }
+
+    // Built outside the lock so other instances' loads don't wait on it
+    std::shared_ptr<WavetableBank> bank(new WavetableBank());
+    if (!bank->Map(path) || !bank->FindSamples()) {
+        return nullptr;
+    }
+    bank->path_ = path;
+    bank->BuildMips();
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    // Another load of the same file may have finished first: share its bank
+    if (auto existing = registry[key].lock()) {
+        return existing;
+    }
+    registry[key] = bank;
+    for (auto it = registry.begin(); it != registry.end();) {
+        it = it->second.expired() ? registry.erase(it) : std::next(it);
+    }
+    return bank;
+}
+
+WavetableBank::~WavetableBank()
+{
+    if (!mapping_) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapping_);
+#else
+    munmap(const_cast<uint8_t*>(mapping_), mapping_size_);
+#endif
+}
+
+bool WavetableBank::Map(const std::string& path)
+{
+    // The handles are closed straight away: the view outlives them
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) {
+        return false;
+    }
+    mapping_size_ = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    mapping_size_ = static_cast<size_t>(info.st_size);
+#endif
+    mapping_ = static_cast<const uint8_t*>(view);
+    return true;
+}
+
+bool WavetableBank::FindSamples()
+{
+    // Samples are read in place, so this assumes a little-endian host
+    const uint8_t* data = mapping_;
+    size_t size = mapping_size_;
+
+    if (size >= 12 && std::memcmp(mapping_, "RIFF", 4) == 0 &&
+        std::memcmp(mapping_ + 8, "WAVE", 4) == 0) {
+        data = nullptr;
+        bool pcm16_mono = false;
+        size_t offset = 12;
+        while (offset + 8 <= mapping_size_) {
+            const uint8_t* chunk = mapping_ + offset;
+            size_t chunk_size = ReadLe32(chunk + 4);
+            size_t available = mapping_size_ - offset - 8;
+            if (std::memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16 && available >= 16) {
+                pcm16_mono = ReadLe16(chunk + 8) == 1 && ReadLe16(chunk + 10) == 1 &&
+                             ReadLe16(chunk + 22) == 16;
+            } else if (std::memcmp(chunk, "data", 4) == 0) {
+                data = chunk + 8;
+                size = std::min(chunk_size, available);
+                break;
+            }
+            offset += 8 + chunk_size + (chunk_size & 1);
+        }
+        if (!data || !pcm16_mono) {
+            return false;
+        }
+    }
+
+    size_t wave_bytes = kWavetableSize * sizeof(int16_t);
+    if (reinterpret_cast<uintptr_t>(data) % alignof(int16_t) != 0 ||
+        size < wave_bytes || size % wave_bytes != 0) {
+        return false;
+    }
+    samples_ = reinterpret_cast<const int16_t*>(data);
+    num_waves_ = std::min(size / wave_bytes, kWavetableMaxWaves);
+    return true;
+}
+
+void WavetableBank::BuildMips()
+{
+    // Each wave is analysed once, then resynthesised with fewer and fewer
+    // harmonics: 64 for level 1, down to the fundamental for the last
+    static const size_t kNumHarmonics = kWavetableSize / 2;
+    const double kTwoPi = 6.283185307179586;
+    double cosine[kWavetableSize];
+    double sine[kWavetableSize];
+    for (size_t n = 0; n < kWavetableSize; ++n) {
+        cosine[n] = std::cos(kTwoPi * static_cast<double>(n) / kWavetableSize);
+        sine[n] = std::sin(kTwoPi * static_cast<double>(n) / kWavetableSize);
+    }
+
+    mips_.assign(num_waves_ * (kWavetableNumMips - 1) * kWavetableSize, 0);
+    double re[kNumHarmonics + 1];
+    double im[kNumHarmonics + 1];
+    for (size_t w = 0; w < num_waves_; ++w) {
+        const int16_t* source = wave(w, 0);
+        for (size_t k = 0; k <= kNumHarmonics; ++k) {
+            double a = 0.0;
+            double b = 0.0;
+            for (size_t n = 0; n < kWavetableSize; ++n) {
+                size_t i = (k * n) & (kWavetableSize - 1);
+                a += source[n] * cosine[i];
+                b += source[n] * sine[i];
+            }
+            double scale = (k == 0 || k == kNumHarmonics) ? 1.0 : 2.0;
+            re[k] = a * scale / kWavetableSize;
+            im[k] = b * scale / kWavetableSize;
+        }
+
+        for (size_t mip = 1; mip < kWavetableNumMips; ++mip) {
+            size_t harmonics = kNumHarmonics >> mip;
+            int16_t* destination = &mips_[(w * (kWavetableNumMips - 1) + mip - 1) * kWavetableSize];
+            for (size_t n = 0; n < kWavetableSize; ++n) {
+                double sum = re[0];
+                for (size_t k = 1; k <= harmonics; ++k) {
+                    size_t i = (k * n) & (kWavetableSize - 1);
+                    sum += re[k] * cosine[i] + im[k] * sine[i];
+                }
+                destination[n] = static_cast<int16_t>(std::clamp(std::lround(sum), -32768L, 32767L));
+            }
+        }
+    }
+}
+
+} // namespace braids
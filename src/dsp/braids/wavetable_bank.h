@@ -0,0 +1,65 @@
+// Wavetable banks loaded from disk
+// BraidsVST: GPL v3
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../stmlib/stmlib.h"
+
+namespace braids {
+
+static const size_t kWavetableSizeBits = 8;
+static const size_t kWavetableSize = 1 << kWavetableSizeBits;  // Samples per wave
+static const size_t kWavetableNumMips = 8;  // 128 harmonics down to 1
+static const size_t kWavetableMaxWaves = 256;
+
+// A bank is a file of single-cycle waves, 256 samples each, signed 16-bit
+// little-endian: either raw or the data chunk of a mono 16-bit PCM WAV.
+// The file is memory-mapped and its samples are played in place as the
+// top mip level; the band-limited levels below it are built on load
+class WavetableBank
+{
+public:
+    ~WavetableBank();
+
+    // Maps the file and builds the mips. This reads the whole file and
+    // resynthesises every wave, so call it off the audio thread. Banks are
+    // shared: while one is alive, loading the same path again in this
+    // process returns it, unless the file's size or modification time has
+    // changed since. nullptr if the file can't be mapped or isn't a bank
+    static std::shared_ptr<const WavetableBank> Load(const std::string& path);
+
+    size_t num_waves() const { return num_waves_; }
+    const std::string& path() const { return path_; }
+
+    // Mip 0 is the wave as stored, each level after it keeps half the
+    // harmonics of the one before
+    const int16_t* wave(size_t index, size_t mip) const {
+        if (mip == 0) {
+            return samples_ + index * kWavetableSize;
+        }
+        return mips_.data() + (index * (kWavetableNumMips - 1) + mip - 1) * kWavetableSize;
+    }
+
+private:
+    WavetableBank() = default;
+
+    bool Map(const std::string& path);
+    bool FindSamples();
+    void BuildMips();
+
+    const uint8_t* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    const int16_t* samples_ = nullptr;  // Inside the mapping
+    size_t num_waves_ = 0;
+    std::vector<int16_t> mips_;  // Levels 1 and below, wave by wave
+    std::string path_;
+
+    DISALLOW_COPY_AND_ASSIGN(WavetableBank);
+};
+
+} // namespace braids
@@ -0,0 +1,91 @@
+// Wavetable oscillator playing a bank loaded from disk
+// BraidsVST: GPL v3
+
+#include "wavetable_oscillator.h"
+#include <algorithm>
+
+namespace braids {
+
+static const uint16_t kHighestNote = 140 * 128;
+static const uint16_t kPitchTableStart = 128 * 128;
+static const uint16_t kOctave = 12 * 128;
+
+void WavetableOscillator::Init()
+{
+    pitch_ = 0;
+    parameter_[0] = 0;
+    parameter_[1] = 0;
+    phase_ = 0;
+}
+
+uint32_t WavetableOscillator::ComputePhaseIncrement(int16_t midi_pitch)
+{
+    if (midi_pitch >= kPitchTableStart) {
+        midi_pitch = kPitchTableStart - 1;
+    }
+
+    int32_t ref_pitch = midi_pitch;
+    ref_pitch -= kPitchTableStart;
+
+    size_t num_shifts = 0;
+    while (ref_pitch < 0) {
+        ref_pitch += kOctave;
+        ++num_shifts;
+    }
+
+    uint32_t a = increments_[ref_pitch >> 4];
+    uint32_t b = increments_[(ref_pitch >> 4) + 1];
+    uint32_t phase_increment = a +
+        (static_cast<int32_t>(b - a) * (ref_pitch & 0xf) >> 4);
+    phase_increment >>= num_shifts;
+    return phase_increment;
+}
+
+size_t WavetableOscillator::MipForIncrement(uint32_t increment)
+{
+    // The highest harmonic of a level is its count times the increment
+    size_t mip = 0;
+    uint64_t highest = static_cast<uint64_t>(increment) * (kWavetableSize / 2);
+    while (mip < kWavetableNumMips - 1 && highest > 0x80000000u) {
+        highest >>= 1;
+        ++mip;
+    }
+    return mip;
+}
+
+void WavetableOscillator::Render(int16_t* buffer, size_t size)
+{
+    int16_t clamped_pitch = std::clamp<int16_t>(pitch_, 0, kHighestNote);
+    uint32_t increment = ComputePhaseIncrement(clamped_pitch);
+
+    // Darken by up to 7 mip levels over the lower half of the colour range
+    size_t mip = MipForIncrement(increment);
+    int32_t darkness = std::max<int32_t>(16383 - parameter_[1], 0) >> 11;
+    mip = std::min<size_t>(mip + static_cast<size_t>(darkness), kWavetableNumMips - 1);
+
+    // Crossfade between the two waves either side of the position
+    const int16_t* wave_a = wav_sine;
+    const int16_t* wave_b = wav_sine;
+    int32_t balance = 0;
+    if (bank_) {
+        int32_t last = static_cast<int32_t>(bank_->num_waves()) - 1;
+        int32_t position = std::max<int16_t>(parameter_[0], 0) * last;
+        int32_t index = position >> 15;
+        balance = position & 0x7fff;
+        wave_a = bank_->wave(static_cast<size_t>(index), mip);
+        wave_b = bank_->wave(static_cast<size_t>(std::min(index + 1, last)), mip);
+    }
+
+    const uint32_t kMask = kWavetableSize - 1;
+    for (size_t i = 0; i < size; ++i) {
+        phase_ += increment;
+        uint32_t index = phase_ >> (32 - kWavetableSizeBits);
+        uint32_t next = (index + 1) & kMask;
+        int32_t fractional = (phase_ >> (17 - kWavetableSizeBits)) & 0x7fff;
+        int32_t a = wave_a[index] + ((wave_a[next] - wave_a[index]) * fractional >> 15);
+        int32_t b = wave_b[index] + ((wave_b[next] - wave_b[index]) * fractional >> 15);
+        buffer[i] = static_cast<int16_t>(a + ((b - a) * balance >> 15));
+    }
+}
+
+} // namespace braids
@@ -0,0 +1,50 @@
+// Wavetable oscillator playing a bank loaded from disk
+// BraidsVST: GPL v3
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "../stmlib/stmlib.h"
+#include "resources.h"
+#include "wavetable_bank.h"
+
+namespace braids {
+
+class WavetableOscillator
+{
+public:
+    WavetableOscillator() = default;
+    ~WavetableOscillator() = default;
+
+    void Init();
+
+    void set_pitch(int16_t pitch) { pitch_ = pitch; }
+    void set_increments(const uint32_t* increments) { increments_ = increments; }
+    // param1: position in the bank, param2: brightness (the lower half
+    // drops harmonics)
+    void set_parameters(int16_t param1, int16_t param2) {
+        parameter_[0] = param1;
+        parameter_[1] = param2;
+    }
+    // The bank must outlive its use here. Without one this plays a sine
+    void set_bank(const WavetableBank* bank) { bank_ = bank; }
+
+    void Render(int16_t* buffer, size_t size);
+
+    // Mip level whose harmonics all stay below Nyquist at this increment
+    static size_t MipForIncrement(uint32_t increment);
+
+private:
+    uint32_t ComputePhaseIncrement(int16_t midi_pitch);
+
+    const uint32_t* increments_ = lut_oscillator_increments;
+    const WavetableBank* bank_ = nullptr;
+    int16_t pitch_ = 0;
+    int16_t parameter_[2] = {0, 0};
+    uint32_t phase_ = 0;
+
+    DISALLOW_COPY_AND_ASSIGN(WavetableOscillator);
+};
+
+} // namespace braids
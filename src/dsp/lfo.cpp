@@ -2,7 +2,8 @@
 // Part of BraidsVST - GPL v3
 
 #include "lfo.h"
-#include <cstdlib>
+#include "braids/table_generators.h"
+#include <algorithm>
 
 namespace braids {
 
@@ -20,23 +21,97 @@ static const float kDivisionBeats[] = {
     16.0f,      // 4 bars
 };
 
+// Free-running rates, from Hz_0_1 on
+static const float kFreeRateHz[] = {
+    0.1f, 0.25f, 0.5f, 1.0f, 2.0f, 5.0f, 10.0f, 20.0f
+};
+
 static const char* kRateNames[] = {
-    "1/16", "1/16T", "1/8", "1/8T", "1/4", "1/4T", "1/2", "1", "2", "4"
+    "1/16", "1/16T", "1/8", "1/8T", "1/4", "1/4T", "1/2", "1", "2", "4",
+    "0.1Hz", ".25Hz", "0.5Hz", "1Hz", "2Hz", "5Hz", "10Hz", "20Hz"
 };
 
 static const char* kShapeNames[] = {
-    "TRI", "SAW", "SQR", "S&H"
+    "TRI", "SAW", "SQR", "S&H", "SINE", "SMOOTH", "EXP", "USER"
 };
 
+// One cycle of a shape in kTableSize segments plus a wraparound entry
+template <typename Shape>
+constexpr tables::Table<float, Lfo::kTableSize + 1> MakeCycle(Shape shape)
+{
+    tables::Table<float, Lfo::kTableSize + 1> table = {};
+    for (size_t i = 0; i <= Lfo::kTableSize; ++i) {
+        table.data[i] = static_cast<float>(shape(static_cast<double>(i) / Lfo::kTableSize));
+    }
+    return table;
+}
+
+static constexpr auto kSineTable = MakeCycle([](double phase) {
+    return tables::Sin(2.0 * tables::kPi * phase);
+});
+
+// 2^-6 at the end of the cycle, rescaled to land on -1
+static constexpr auto kExponentialTable = MakeCycle([](double phase) {
+    constexpr double kFloor = 1.0 / 64.0;
+    return 2.0 * (tables::Exp2(-6.0 * phase) - kFloor) / (1.0 - kFloor) - 1.0;
+});
+
+// Raised cosine from 0 to 1, the glide between two random values
+static constexpr auto kGlideTable = MakeCycle([](double phase) {
+    return 0.5 - 0.5 * tables::Cos(tables::kPi * phase);
+});
+
+static inline float Lookup(const float* table, float phase)
+{
+    float position = phase * static_cast<float>(Lfo::kTableSize);
+    int32_t index = static_cast<int32_t>(position);
+    float fractional = position - static_cast<float>(index);
+    return table[index] + (table[index + 1] - table[index]) * fractional;
+}
+
+Lfo::Lfo()
+{
+    const float ramp[] = {-1.0f, 1.0f};
+    SetUserShape(ramp, 2);
+}
+
+void Lfo::SetUserShape(const float* points, size_t count)
+{
+    if (count < 2) {
+        return;
+    }
+    // Points are spread over the whole cycle, so the last one joins back
+    // to the first
+    for (size_t i = 0; i <= kTableSize; ++i) {
+        float position = static_cast<float>(i % kTableSize) * static_cast<float>(count) / kTableSize;
+        size_t index = static_cast<size_t>(position);
+        float fractional = position - static_cast<float>(index);
+        float a = std::clamp(points[index], -1.0f, 1.0f);
+        float b = std::clamp(points[(index + 1) % count], -1.0f, 1.0f);
+        user_table_[i] = a + (b - a) * fractional;
+    }
+}
+
+void Lfo::NextRandom()
+{
+    glide_from_ = sh_value_;
+    sh_value_ = random_.GetFloat() * 2.0f - 1.0f;
+}
+
 void Lfo::Init()
 {
     phase_ = 0.0f;
     output_ = 0.0f;
     sh_value_ = 0.0f;
+    glide_from_ = 0.0f;
     sh_triggered_ = false;
     rate_division_ = LfoRateDivision::Div_1_4;
     shape_ = LfoShape::Triangle;
     tempo_bpm_ = 120.0;
+    base_increment_ = 0.0f;
+    base_increment_sample_rate_ = 0.0f;
+    rate_modulation_ = 0.0f;
+    rate_multiplier_ = 1.0f;
 }
 
 void Lfo::Reset()
@@ -45,16 +120,44 @@ void Lfo::Reset()
     sh_triggered_ = false;
 }
 
-float Lfo::ComputePhaseIncrement(float sample_rate) const
+void Lfo::SyncToBeat(double ppq_position)
+{
+    if (rate_multiplier_ != 1.0f || IsFreeRate(rate_division_)) {
+        return;
+    }
+    double cycles = ppq_position / kDivisionBeats[static_cast<int>(rate_division_)];
+    float phase = static_cast<float>(cycles - std::floor(cycles));
+    // Rounding can land exactly on the next cycle
+    phase_ = phase < 1.0f ? phase : 0.0f;
+}
+
+void Lfo::SetRateModulation(float modulation)
+{
+    if (modulation != rate_modulation_) {
+        rate_modulation_ = modulation;
+        rate_multiplier_ = std::exp2(modulation * 2.0f);
+    }
+}
+
+float Lfo::ComputePhaseIncrement(float sample_rate)
 {
-    int div_index = static_cast<int>(rate_division_);
-    float beats = kDivisionBeats[div_index];
+    if (sample_rate != base_increment_sample_rate_) {
+        int div_index = static_cast<int>(rate_division_);
+        if (IsFreeRate(rate_division_)) {
+            int free_index = div_index - static_cast<int>(LfoRateDivision::Hz_0_1);
+            base_increment_ = kFreeRateHz[free_index] / sample_rate;
+        } else {
+            float beats = kDivisionBeats[div_index];
 
-    // Convert beats to seconds: beats / (bpm / 60) = beats * 60 / bpm
-    float period_seconds = beats * 60.0f / static_cast<float>(tempo_bpm_);
+            // Convert beats to seconds: beats / (bpm / 60) = beats * 60 / bpm
+            float period_seconds = beats * 60.0f / static_cast<float>(tempo_bpm_);
 
-    // Phase increment per sample
-    return 1.0f / (period_seconds * sample_rate);
+            // Phase increment per sample
+            base_increment_ = 1.0f / (period_seconds * sample_rate);
+        }
+        base_increment_sample_rate_ = sample_rate;
+    }
+    return base_increment_ * rate_multiplier_;
 }
 
 float Lfo::ComputeWaveform(float phase) const
@@ -89,6 +192,18 @@ float Lfo::ComputeWaveform(float phase) const
             return sh_value_;
         }
 
+        case LfoShape::Sine:
+            return Lookup(kSineTable.data, phase);
+
+        case LfoShape::SmoothRandom:
+            return glide_from_ + (sh_value_ - glide_from_) * Lookup(kGlideTable.data, phase);
+
+        case LfoShape::Exponential:
+            return Lookup(kExponentialTable.data, phase);
+
+        case LfoShape::User:
+            return Lookup(user_table_, phase);
+
         default:
             return 0.0f;
     }
@@ -102,10 +217,10 @@ float Lfo::Process(float sample_rate, int num_samples)
     phase_ += increment;
 
     // Handle S&H: sample new random value at start of cycle
-    if (shape_ == LfoShape::SampleAndHold) {
+    if (shape_ == LfoShape::SampleAndHold || shape_ == LfoShape::SmoothRandom) {
         if (phase_ >= 1.0f || (old_phase > phase_)) {
             // New cycle started - sample new value
-            sh_value_ = (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * 2.0f - 1.0f;
+            NextRandom();
         }
     }
 
@@ -118,6 +233,92 @@ float Lfo::Process(float sample_rate, int num_samples)
     return output_;
 }
 
+void Lfo::ProcessBlock(float sample_rate, float* out, size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    const float increment = ComputePhaseIncrement(sample_rate);
+
+    // Phases first, then the shape, both as flat loops without branches
+    // (phase is never negative, so truncation wraps it)
+    for (size_t i = 0; i < size; ++i) {
+        float phase = phase_ + increment * static_cast<float>(i + 1);
+        out[i] = phase - static_cast<float>(static_cast<int32_t>(phase));
+    }
+
+    switch (shape_) {
+        case LfoShape::Triangle:
+            // Shifted a quarter cycle, the triangle is a fold of the phase
+            for (size_t i = 0; i < size; ++i) {
+                float shifted = out[i] + 0.25f;
+                shifted -= static_cast<float>(static_cast<int32_t>(shifted));
+                out[i] = 1.0f - 4.0f * std::fabs(shifted - 0.5f);
+            }
+            break;
+
+        case LfoShape::Saw:
+            for (size_t i = 0; i < size; ++i) {
+                out[i] = 1.0f - out[i] * 2.0f;
+            }
+            break;
+
+        case LfoShape::Square:
+            for (size_t i = 0; i < size; ++i) {
+                out[i] = out[i] < 0.5f ? 1.0f : -1.0f;
+            }
+            break;
+
+        case LfoShape::SampleAndHold: {
+            // New value whenever the phase wraps
+            float previous = phase_;
+            for (size_t i = 0; i < size; ++i) {
+                float phase = out[i];
+                if (phase < previous) {
+                    NextRandom();
+                }
+                previous = phase;
+                out[i] = sh_value_;
+            }
+            break;
+        }
+
+        case LfoShape::SmoothRandom: {
+            float previous = phase_;
+            for (size_t i = 0; i < size; ++i) {
+                float phase = out[i];
+                if (phase < previous) {
+                    NextRandom();
+                }
+                previous = phase;
+                out[i] = glide_from_ + (sh_value_ - glide_from_) * Lookup(kGlideTable.data, phase);
+            }
+            break;
+        }
+
+        case LfoShape::Sine:
+        case LfoShape::Exponential:
+        case LfoShape::User: {
+            const float* table = shape_ == LfoShape::Sine ? kSineTable.data
+                : shape_ == LfoShape::Exponential ? kExponentialTable.data : user_table_;
+            for (size_t i = 0; i < size; ++i) {
+                out[i] = Lookup(table, out[i]);
+            }
+            break;
+        }
+
+        default:
+            for (size_t i = 0; i < size; ++i) {
+                out[i] = 0.0f;
+            }
+            break;
+    }
+
+    phase_ += increment * static_cast<float>(size);
+    phase_ -= static_cast<float>(static_cast<int32_t>(phase_));
+    output_ = out[size - 1];
+}
+
 const char* Lfo::GetRateName(LfoRateDivision div)
 {
     int index = static_cast<int>(div);
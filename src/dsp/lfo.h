@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <cmath>
+#include "stmlib/random.h"
 
 namespace braids {
 
@@ -13,10 +15,14 @@ enum class LfoShape {
     Saw,
     Square,
     SampleAndHold,
+    Sine,
+    SmoothRandom,   // Glides from one random value to the next each cycle
+    Exponential,    // Falls from +1 to -1, fast then slow
+    User,           // Drawn, see SetUserShape
     NumShapes
 };
 
-// Tempo-synced rate divisions
+// Tempo-synced rate divisions, then free-running rates
 enum class LfoRateDivision {
     Div_1_16 = 0,   // 1/16 note
     Div_1_16T,      // 1/16 triplet
@@ -28,20 +34,58 @@ enum class LfoRateDivision {
     Div_1_1,        // 1 bar
     Div_2_1,        // 2 bars
     Div_4_1,        // 4 bars
+    Hz_0_1,         // 0.1 Hz, whatever the tempo
+    Hz_0_25,
+    Hz_0_5,
+    Hz_1,
+    Hz_2,
+    Hz_5,
+    Hz_10,
+    Hz_20,
     NumDivisions
 };
 
+// The smooth shapes are tables of kTableSize segments, so every shape costs
+// at most one lookup and interpolation per sample
 class Lfo {
 public:
-    Lfo() = default;
+    static constexpr size_t kTableSize = 256;
+
+    Lfo();  // The drawn shape starts as a rising ramp
     ~Lfo() = default;
 
     void Init();
     void Reset();
 
-    void SetRate(LfoRateDivision division) { rate_division_ = division; }
+    void SetRate(LfoRateDivision division) {
+        if (division != rate_division_) {
+            rate_division_ = division;
+            base_increment_sample_rate_ = 0.0f;
+        }
+    }
     void SetShape(LfoShape shape) { shape_ = shape; }
-    void SetTempo(double bpm) { tempo_bpm_ = bpm; }
+    // Points spread evenly over one cycle (-1 to +1), joined by straight
+    // lines and wrapping from the last to the first. Needs at least two.
+    // Init leaves the drawn shape alone
+    void SetUserShape(const float* points, size_t count);
+    // Seeds sample and hold. Init and Reset leave it alone
+    void Seed(uint32_t seed) { random_.Seed(seed); }
+    void SetTempo(double bpm) {
+        if (bpm != tempo_bpm_) {
+            tempo_bpm_ = bpm;
+            base_increment_sample_rate_ = 0.0f;
+        }
+    }
+
+    // Lock the phase to the host's position in quarter notes, so the LFO
+    // follows the song. Call at the start of a block while the transport
+    // plays; the block then advances from there. Ignored at a free rate or
+    // while the rate is modulated, as the LFO is no longer at a division
+    void SyncToBeat(double ppq_position);
+
+    // Rate modulation, -1 to +1, scales the rate by up to two octaves
+    // either way until changed. Call once per control tick
+    void SetRateModulation(float modulation);
 
     LfoRateDivision GetRate() const { return rate_division_; }
     LfoShape GetShape() const { return shape_; }
@@ -50,25 +94,44 @@ public:
     // num_samples: number of samples to advance (for block-based processing)
     float Process(float sample_rate, int num_samples = 1);
 
+    // Advance by size samples, writing the value at each one to out (-1 to
+    // +1). For consumers that need the LFO between control ticks
+    void ProcessBlock(float sample_rate, float* out, size_t size);
+
     // Get current output without advancing
     float GetOutput() const { return output_; }
 
     // Get rate name for display
     static const char* GetRateName(LfoRateDivision div);
     static const char* GetShapeName(LfoShape shape);
+    static bool IsFreeRate(LfoRateDivision div) {
+        return div >= LfoRateDivision::Hz_0_1 && div < LfoRateDivision::NumDivisions;
+    }
 
 private:
-    float ComputePhaseIncrement(float sample_rate) const;
+    float ComputePhaseIncrement(float sample_rate);
     float ComputeWaveform(float phase) const;
+    // Draws the next random value at a cycle start
+    void NextRandom();
 
     LfoRateDivision rate_division_ = LfoRateDivision::Div_1_4;
     LfoShape shape_ = LfoShape::Triangle;
     double tempo_bpm_ = 120.0;
 
+    // Unmodulated increment, recomputed when the rate, tempo or sample
+    // rate changes (0 means stale)
+    float base_increment_ = 0.0f;
+    float base_increment_sample_rate_ = 0.0f;
+    float rate_modulation_ = 0.0f;
+    float rate_multiplier_ = 1.0f;
+
     float phase_ = 0.0f;
     float output_ = 0.0f;
     float sh_value_ = 0.0f;  // Sample & hold current value
+    float glide_from_ = 0.0f;  // Smooth random glides from here to sh_value_
+    stmlib::Random random_;
     bool sh_triggered_ = false;
+    float user_table_[kTableSize + 1] = {};
 };
 
 } // namespace braids
@@ -2,14 +2,80 @@
 // Part of BraidsVST - GPL v3
 
 #include "mod_envelope.h"
+#include "braids/table_generators.h"
 #include <algorithm>
 
 namespace braids {
 
+// One decay from 1 to 0 in kCurveTableSize segments
+template <typename Curve>
+constexpr tables::Table<float, ModEnvelope::kCurveTableSize + 1> MakeDecay(Curve curve)
+{
+    tables::Table<float, ModEnvelope::kCurveTableSize + 1> table = {};
+    for (size_t i = 0; i <= ModEnvelope::kCurveTableSize; ++i) {
+        table.data[i] = static_cast<float>(curve(static_cast<double>(i) / ModEnvelope::kCurveTableSize));
+    }
+    return table;
+}
+
+// e^(-4 * phase), rescaled to land on 0 rather than jump there at the end
+constexpr double ExponentialDecay(double phase)
+{
+    constexpr double kLog2e = 1.44269504088896340736;
+    constexpr double kFloor = 0.01831563888873418;  // e^-4
+    return (tables::Exp2(-4.0 * kLog2e * phase) - kFloor) / (1.0 - kFloor);
+}
+
+static constexpr auto kLinearDecay = MakeDecay([](double phase) {
+    return 1.0 - phase;
+});
+
+static constexpr auto kExponentialDecay = MakeDecay([](double phase) {
+    return ExponentialDecay(phase);
+});
+
+// The exponential turned around in time and level
+static constexpr auto kLogarithmicDecay = MakeDecay([](double phase) {
+    return 1.0 - ExponentialDecay(1.0 - phase);
+});
+
+static const float* const kDecayTables[] = {
+    kLinearDecay.data,
+    kExponentialDecay.data,
+    kLogarithmicDecay.data
+};
+
+static inline const float* DecayTable(ModEnvelopeCurve curve)
+{
+    int index = static_cast<int>(curve);
+    return kDecayTables[index >= 0 && index < static_cast<int>(ModEnvelopeCurve::NumCurves) ? index : 1];
+}
+
+static inline float Lookup(const float* table, float phase)
+{
+    float position = phase * static_cast<float>(ModEnvelope::kCurveTableSize);
+    int32_t index = static_cast<int32_t>(position);
+    float fractional = position - static_cast<float>(index);
+    return table[index] + (table[index + 1] - table[index]) * fractional;
+}
+
+// Phase advance per sample for a stage of the given length
+static inline float StageIncrement(uint16_t ms, float sample_rate)
+{
+    return 1.0f / std::max((ms / 1000.0f) * sample_rate, 1.0f);
+}
+
+float ModEnvelope::DecayLevel(ModEnvelopeCurve curve, float phase)
+{
+    return Lookup(DecayTable(curve), std::clamp(phase, 0.0f, 1.0f));
+}
+
 void ModEnvelope::Init()
 {
     attack_ms_ = 10;
     decay_ms_ = 200;
+    curve_ = ModEnvelopeCurve::Exponential;
+    increment_sample_rate_ = 0.0f;
     stage_ = Stage::Idle;
     output_ = 0.0f;
     phase_ = 0.0f;
@@ -24,9 +90,10 @@ void ModEnvelope::Reset()
 
 void ModEnvelope::Trigger()
 {
+    // The attack is linear, so starting its phase at the current level
+    // carries on from there without a step
     stage_ = Stage::Attack;
-    phase_ = 0.0f;
-    // Don't reset output_ - allows retriggering mid-envelope smoothly
+    phase_ = output_;
 }
 
 float ModEnvelope::Process(float sample_rate, int num_samples)
@@ -35,15 +102,17 @@ float ModEnvelope::Process(float sample_rate, int num_samples)
         return output_;
     }
 
+    if (sample_rate != increment_sample_rate_) {
+        attack_increment_ = StageIncrement(attack_ms_, sample_rate);
+        decay_increment_ = StageIncrement(decay_ms_, sample_rate);
+        increment_sample_rate_ = sample_rate;
+    }
+
     float samples_f = static_cast<float>(num_samples);
 
     if (stage_ == Stage::Attack) {
-        // Calculate increment: go from 0 to 1 over attack_ms_ milliseconds
-        float attack_samples = (attack_ms_ / 1000.0f) * sample_rate;
-        if (attack_samples < 1.0f) attack_samples = 1.0f;
-
-        float increment = samples_f / attack_samples;
-        phase_ += increment;
+        // Linear rise from 0 to 1 over attack_ms_
+        phase_ += attack_increment_ * samples_f;
 
         if (phase_ >= 1.0f) {
             // Attack complete, move to decay
@@ -51,17 +120,12 @@ float ModEnvelope::Process(float sample_rate, int num_samples)
             phase_ = 0.0f;
             stage_ = Stage::Decay;
         } else {
-            // Linear attack (could make exponential if desired)
             output_ = phase_;
         }
     }
     else if (stage_ == Stage::Decay) {
-        // Calculate increment: go from 1 to 0 over decay_ms_ milliseconds
-        float decay_samples = (decay_ms_ / 1000.0f) * sample_rate;
-        if (decay_samples < 1.0f) decay_samples = 1.0f;
-
-        float increment = samples_f / decay_samples;
-        phase_ += increment;
+        // Fall from 1 to 0 over decay_ms_ along the selected curve
+        phase_ += decay_increment_ * samples_f;
 
         if (phase_ >= 1.0f) {
             // Decay complete
@@ -69,15 +133,69 @@ float ModEnvelope::Process(float sample_rate, int num_samples)
             phase_ = 0.0f;
             stage_ = Stage::Idle;
         } else {
-            // Exponential decay for more natural sound
-            // output = 1 - phase would be linear
-            // Using exponential: output = e^(-k*phase) where k controls curve
-            float curve = 4.0f;  // Adjust for steeper/gentler curve
-            output_ = std::exp(-curve * phase_);
+            output_ = Lookup(DecayTable(curve_), phase_);
         }
     }
 
     return output_;
 }
 
+void ModEnvelopeBank::Init()
+{
+    attack_ms_ = 10;
+    decay_ms_ = 200;
+    curve_ = ModEnvelopeCurve::Exponential;
+    increment_sample_rate_ = 0.0f;
+    std::fill(stage_, stage_ + kMaxEnvelopes, static_cast<uint8_t>(kIdle));
+    std::fill(phase_, phase_ + kMaxEnvelopes, 0.0f);
+    std::fill(output_, output_ + kMaxEnvelopes, 0.0f);
+}
+
+void ModEnvelopeBank::Trigger(size_t index)
+{
+    // As ModEnvelope: the attack rises from the current level
+    stage_[index] = kAttack;
+    phase_[index] = output_[index];
+}
+
+void ModEnvelopeBank::Reset(size_t index)
+{
+    stage_[index] = kIdle;
+    phase_[index] = 0.0f;
+    output_[index] = 0.0f;
+}
+
+void ModEnvelopeBank::Process(const uint16_t* indices, size_t count, float sample_rate,
+                              int num_samples)
+{
+    // Same curves as ModEnvelope::Process
+    if (sample_rate != increment_sample_rate_) {
+        attack_increment_ = StageIncrement(attack_ms_, sample_rate);
+        decay_increment_ = StageIncrement(decay_ms_, sample_rate);
+        increment_sample_rate_ = sample_rate;
+    }
+    float samples_f = static_cast<float>(num_samples);
+    float attack_increment = attack_increment_ * samples_f;
+    float decay_increment = decay_increment_ * samples_f;
+    const float* decay_table = DecayTable(curve_);
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t index = indices[i];
+        uint8_t stage = stage_[index];
+        if (stage == kIdle) {
+            continue;
+        }
+        float phase = phase_[index] + (stage == kAttack ? attack_increment : decay_increment);
+        if (phase >= 1.0f) {
+            // Attack hands over to decay at the top, decay ends at zero
+            output_[index] = stage == kAttack ? 1.0f : 0.0f;
+            stage_[index] = stage == kAttack ? kDecay : kIdle;
+            phase = 0.0f;
+        } else {
+            output_[index] = stage == kAttack ? phase : Lookup(decay_table, phase);
+        }
+        phase_[index] = phase;
+    }
+}
+
 } // namespace braids
@@ -3,12 +3,35 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace braids {
 
+// When ENV1 and ENV2 fire
+enum class ModEnvelopeMode {
+    Legato = 0,   // First note after silence
+    Retrigger,    // Every note
+    PerVoice,     // Every note starts its own pair, for per-voice destinations
+    NumModes
+};
+
+// Shape of the decay from 1 to 0
+enum class ModEnvelopeCurve {
+    Linear = 0,
+    Exponential,    // Falls fast, then slow
+    Logarithmic,    // Holds near the top, then falls fast
+    NumCurves
+};
+
+// Attack and decay advance by increments cached when a time or the sample
+// rate changes, and the decay curve is a table, so a tick costs a couple of
+// multiply-adds whatever the curve
+
 class ModEnvelope {
 public:
+    static constexpr size_t kCurveTableSize = 256;
+
     ModEnvelope() = default;
     ~ModEnvelope() = default;
 
@@ -16,13 +39,28 @@ public:
     void Reset();
 
     // Set times in milliseconds
-    void SetAttack(uint16_t attack_ms) { attack_ms_ = attack_ms; }
-    void SetDecay(uint16_t decay_ms) { decay_ms_ = decay_ms; }
+    void SetAttack(uint16_t attack_ms) {
+        if (attack_ms != attack_ms_) {
+            attack_ms_ = attack_ms;
+            increment_sample_rate_ = 0.0f;
+        }
+    }
+    void SetDecay(uint16_t decay_ms) {
+        if (decay_ms != decay_ms_) {
+            decay_ms_ = decay_ms;
+            increment_sample_rate_ = 0.0f;
+        }
+    }
+    void SetCurve(ModEnvelopeCurve curve) { curve_ = curve; }
 
     uint16_t GetAttack() const { return attack_ms_; }
     uint16_t GetDecay() const { return decay_ms_; }
+    ModEnvelopeCurve GetCurve() const { return curve_; }
 
-    // Trigger the envelope (call on first note)
+    // Level of a curve at a decay phase (0 to 1), as Process outputs it
+    static float DecayLevel(ModEnvelopeCurve curve, float phase);
+
+    // Start the attack from the current level, so a retrigger never steps
     void Trigger();
 
     // Process and return current value (0 to 1)
@@ -47,10 +85,71 @@ private:
 
     uint16_t attack_ms_ = 10;
     uint16_t decay_ms_ = 200;
+    ModEnvelopeCurve curve_ = ModEnvelopeCurve::Exponential;
+
+    // Phase increments per sample (0 sample rate means stale)
+    float attack_increment_ = 0.0f;
+    float decay_increment_ = 0.0f;
+    float increment_sample_rate_ = 0.0f;
 
     Stage stage_ = Stage::Idle;
     float output_ = 0.0f;
     float phase_ = 0.0f;
 };
 
+// One ModEnvelope per voice with shared times, as packed arrays indexed by
+// voice so a control tick runs them all in one loop
+class ModEnvelopeBank {
+public:
+    static constexpr size_t kMaxEnvelopes = 128;
+
+    ModEnvelopeBank() = default;
+    ~ModEnvelopeBank() = default;
+
+    void Init();
+
+    // Set times in milliseconds and the curve, for every envelope
+    void SetAttack(uint16_t attack_ms) {
+        if (attack_ms != attack_ms_) {
+            attack_ms_ = attack_ms;
+            increment_sample_rate_ = 0.0f;
+        }
+    }
+    void SetDecay(uint16_t decay_ms) {
+        if (decay_ms != decay_ms_) {
+            decay_ms_ = decay_ms;
+            increment_sample_rate_ = 0.0f;
+        }
+    }
+    void SetCurve(ModEnvelopeCurve curve) { curve_ = curve; }
+
+    // Start one envelope's attack from its current level
+    void Trigger(size_t index);
+    // Back to idle at 0, for a voice starting afresh
+    void Reset(size_t index);
+
+    // Advance the envelopes listed in indices by num_samples
+    void Process(const uint16_t* indices, size_t count, float sample_rate, int num_samples);
+
+    float output(size_t index) const { return output_[index]; }
+
+private:
+    enum Stage : uint8_t {
+        kIdle,
+        kAttack,
+        kDecay
+    };
+
+    uint16_t attack_ms_ = 10;
+    uint16_t decay_ms_ = 200;
+    ModEnvelopeCurve curve_ = ModEnvelopeCurve::Exponential;
+    float attack_increment_ = 0.0f;
+    float decay_increment_ = 0.0f;
+    float increment_sample_rate_ = 0.0f;
+
+    uint8_t stage_[kMaxEnvelopes] = {};
+    alignas(16) float phase_[kMaxEnvelopes] = {};
+    alignas(16) float output_[kMaxEnvelopes] = {};
+};
+
 } // namespace braids
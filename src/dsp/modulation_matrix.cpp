@@ -11,6 +11,13 @@ static const char* kDestinationNames[] = {
     "TIMBRE", "COLOR", "CUTOFF", "RESONAN", "LFO1 RT", "LFO1 AM", "LFO2 RT", "LFO2 AM"
 };
 
+static const ModDestination kDefaultDestinations[] = {
+    ModDestination::Timbre,  // LFO1
+    ModDestination::Color,   // LFO2
+    ModDestination::Timbre,  // ENV1
+    ModDestination::Color    // ENV2
+};
+
 void ModulationMatrix::Init()
 {
     lfo1_.Init();
@@ -18,16 +25,16 @@ void ModulationMatrix::Init()
     env1_.Init();
     env2_.Init();
 
-    // Default routing
-    destinations_[0] = ModDestination::Timbre;
-    destinations_[1] = ModDestination::Color;
-    destinations_[2] = ModDestination::Timbre;
-    destinations_[3] = ModDestination::Color;
-
-    for (int i = 0; i < 4; ++i) {
-        amounts_[i] = 0;
+    // Default routing: one slot per source, all off
+    for (size_t i = 0; i < kNumSlots; ++i) {
+        slots_[i] = ModSlot();
+    }
+    for (int i = 0; i < kNumSources; ++i) {
+        slots_[i].source = static_cast<ModSource>(i);
+        slots_[i].destination = kDefaultDestinations[i];
         source_outputs_[i] = 0;
     }
+    routing_changed_ = true;
 
     for (int i = 0; i < static_cast<int>(ModDestination::NumDestinations); ++i) {
         mod_values_[i] = 0;
@@ -48,27 +55,43 @@ void ModulationMatrix::Reset()
     }
 }
 
+void ModulationMatrix::SetSlot(size_t slot, ModSource source, ModDestination dest, int8_t amount)
+{
+    if (slot >= kNumSlots) {
+        return;
+    }
+    amount = std::clamp(amount, static_cast<int8_t>(-64), static_cast<int8_t>(63));
+    ModSlot& s = slots_[slot];
+    // Parameters are pushed every block, so only a real change recompiles
+    if (s.source != source || s.destination != dest || s.amount != amount) {
+        s.source = source;
+        s.destination = dest;
+        s.amount = amount;
+        routing_changed_ = true;
+    }
+}
+
 void ModulationMatrix::SetDestination(ModSource source, ModDestination dest)
 {
     int idx = static_cast<int>(source);
-    if (idx >= 0 && idx < 4) {
-        destinations_[idx] = dest;
+    if (idx >= 0 && idx < kNumSources) {
+        SetSlot(static_cast<size_t>(idx), slots_[idx].source, dest, slots_[idx].amount);
     }
 }
 
 void ModulationMatrix::SetAmount(ModSource source, int8_t amount)
 {
     int idx = static_cast<int>(source);
-    if (idx >= 0 && idx < 4) {
-        amounts_[idx] = std::clamp(amount, static_cast<int8_t>(-64), static_cast<int8_t>(63));
+    if (idx >= 0 && idx < kNumSources) {
+        SetSlot(static_cast<size_t>(idx), slots_[idx].source, slots_[idx].destination, amount);
     }
 }
 
 ModDestination ModulationMatrix::GetDestination(ModSource source) const
 {
     int idx = static_cast<int>(source);
-    if (idx >= 0 && idx < 4) {
-        return destinations_[idx];
+    if (idx >= 0 && idx < kNumSources) {
+        return slots_[idx].destination;
     }
     return ModDestination::Timbre;
 }
@@ -76,8 +99,8 @@ ModDestination ModulationMatrix::GetDestination(ModSource source) const
 int8_t ModulationMatrix::GetAmount(ModSource source) const
 {
     int idx = static_cast<int>(source);
-    if (idx >= 0 && idx < 4) {
-        return amounts_[idx];
+    if (idx >= 0 && idx < kNumSources) {
+        return slots_[idx].amount;
     }
     return 0;
 }
@@ -89,98 +112,165 @@ void ModulationMatrix::SetTempo(double bpm)
     lfo2_.SetTempo(bpm);
 }
 
+void ModulationMatrix::SyncToBeat(double ppq_position)
+{
+    lfo1_.SyncToBeat(ppq_position);
+    lfo2_.SyncToBeat(ppq_position);
+}
+
+void ModulationMatrix::Seed(uint32_t seed)
+{
+    lfo1_.Seed(seed);
+    lfo2_.Seed(seed ^ 0x9e3779b9u);
+}
+
 void ModulationMatrix::TriggerEnvelopes()
 {
     env1_.Trigger();
     env2_.Trigger();
 }
 
-void ModulationMatrix::Process(float sample_rate, int num_samples)
+// The LFO a source or an amount destination belongs to, -1 if none
+static int LfoOfSource(ModSource source)
 {
-    // For efficiency, we process at a reduced control rate
-    // Process once per block rather than per-sample
-    // This is fine for LFOs and envelopes which are low-frequency
+    switch (source) {
+        case ModSource::Lfo1: return 0;
+        case ModSource::Lfo2: return 1;
+        default: return -1;
+    }
+}
 
-    // Apply any LFO rate modulation before processing LFOs
-    // Check if any mod source targets LFO rates
-    float lfo1_rate_mod = 0.0f;
-    float lfo2_rate_mod = 0.0f;
+static int LfoOfAmount(ModDestination dest)
+{
+    switch (dest) {
+        case ModDestination::Lfo1Amount: return 0;
+        case ModDestination::Lfo2Amount: return 1;
+        default: return -1;
+    }
+}
 
-    // First pass: get envelope outputs (they don't depend on LFOs)
-    env1_.Process(sample_rate, num_samples);
-    env2_.Process(sample_rate, num_samples);
-    source_outputs_[2] = env1_.GetOutput();  // ENV outputs 0-1 (unipolar)
-    source_outputs_[3] = env2_.GetOutput();
+static int LfoOfRate(ModDestination dest)
+{
+    switch (dest) {
+        case ModDestination::Lfo1Rate: return 0;
+        case ModDestination::Lfo2Rate: return 1;
+        default: return -1;
+    }
+}
+
+// Rate slots run before the LFOs advance, then the slots feeding an LFO
+// amount, then everything else
+static int CompileLevel(ModDestination dest)
+{
+    if (LfoOfRate(dest) >= 0) {
+        return 0;
+    }
+    return LfoOfAmount(dest) >= 0 ? 1 : 2;
+}
 
-    // Calculate rate modulation from envelopes if routed
-    for (int i = 2; i < 4; ++i) {  // ENV1 and ENV2
-        ModDestination dest = destinations_[i];
-        float amount = amounts_[i] / 64.0f;  // Normalize to -1 to ~1
-        float output = source_outputs_[i];  // Keep unipolar 0-1
+void ModulationMatrix::Compile()
+{
+    // Slots feeding an LFO amount use their own amount as is, so the order
+    // has no cycles. An LFO doesn't modulate its own amount
+    bool fed[2] = {false, false};
+    num_ops_ = 0;
+    for (int level = 0; level < 3; ++level) {
+        if (level == 1) {
+            num_rate_ops_ = num_ops_;
+        }
+        for (size_t i = 0; i < kNumSlots; ++i) {
+            const ModSlot& slot = slots_[i];
+            if (CompileLevel(slot.destination) != level) {
+                continue;
+            }
+            int lfo = LfoOfSource(slot.source);
+            // A zero amount is off, except on an LFO's own slot while its
+            // amount is modulated: the fed term alone drives it, as in a
+            // delayed vibrato
+            bool own_slot = i == static_cast<size_t>(slot.source);
+            bool driven = level == 2 && lfo >= 0 && own_slot && fed[lfo];
+            if (slot.amount == 0 && !driven) {
+                continue;
+            }
+            int feeds = LfoOfAmount(slot.destination);
+            if (feeds == lfo) {
+                feeds = -1;
+            }
+            if (feeds >= 0) {
+                fed[feeds] = true;
+            }
+            Op& op = ops_[num_ops_++];
+            op.source = static_cast<uint8_t>(slot.source);
+            op.destination = static_cast<uint8_t>(slot.destination);
+            op.feeds = static_cast<int8_t>(feeds);
+            op.scaled_by = static_cast<int8_t>(level == 2 && lfo >= 0 && fed[lfo] ? lfo : -1);
+            op.amount = slot.amount / 64.0f;  // Normalize to -1 to ~1
+        }
+    }
+    routing_changed_ = false;
+}
 
-        if (dest == ModDestination::Lfo1Rate) {
-            lfo1_rate_mod += output * amount;
-        } else if (dest == ModDestination::Lfo2Rate) {
-            lfo2_rate_mod += output * amount;
+void ModulationMatrix::RunOps(size_t begin, size_t end, float* amount_mod)
+{
+    for (size_t i = begin; i < end; ++i) {
+        const Op& op = ops_[i];
+        float amount = op.amount;
+        if (op.scaled_by >= 0) {
+            amount += amount_mod[op.scaled_by];
+        }
+        float value = source_outputs_[op.source] * amount;
+        mod_values_[op.destination] += value;
+        if (op.feeds >= 0) {
+            amount_mod[op.feeds] += value * 0.5f;  // Scale modulation of amount
         }
     }
+}
 
-    // TODO: Apply rate modulation to LFOs (would need rate scaling method)
-    // For now, rate modulation affects the output amount instead
+float ModulationMatrix::AverageOver(Lfo& lfo, float sample_rate, int num_samples, float* scratch)
+{
+    if (num_samples <= 0) {
+        return lfo.GetOutput();
+    }
+    float sum = 0.0f;
+    for (int offset = 0; offset < num_samples; offset += kLfoChunkSize) {
+        int chunk = std::min(kLfoChunkSize, num_samples - offset);
+        lfo.ProcessBlock(sample_rate, scratch, static_cast<size_t>(chunk));
+        for (int i = 0; i < chunk; ++i) {
+            sum += scratch[i];
+        }
+    }
+    return sum / static_cast<float>(num_samples);
+}
 
-    // Process LFOs
-    lfo1_.Process(sample_rate, num_samples);
-    lfo2_.Process(sample_rate, num_samples);
-    source_outputs_[0] = lfo1_.GetOutput();  // Already -1 to 1
-    source_outputs_[1] = lfo2_.GetOutput();
+void ModulationMatrix::Process(float sample_rate, int num_samples)
+{
+    // For efficiency, we process at a reduced control rate
+    // Process once per block rather than per-sample
+    // This is fine for LFOs and envelopes which are low-frequency
+    if (routing_changed_) {
+        Compile();
+    }
 
-    // Clear modulation values
     for (int i = 0; i < static_cast<int>(ModDestination::NumDestinations); ++i) {
         mod_values_[i] = 0;
     }
 
-    // Calculate total modulation per destination
-    for (int i = 0; i < 4; ++i) {
-        ModDestination dest = destinations_[i];
-        float amount = amounts_[i] / 64.0f;  // Normalize to -1 to ~1
-
-        float output;
-        if (i < 2) {
-            // LFOs are already bipolar (-1 to 1)
-            output = source_outputs_[i];
-        } else {
-            // Envelopes are unipolar (0 to 1)
-            // Keep them unipolar - positive amount = add, negative = subtract
-            // This makes +amount push the value UP when envelope is active
-            output = source_outputs_[i];
-        }
+    // Rate slots see this tick's envelopes and the LFOs' last tick
+    env1_.Process(sample_rate, num_samples);
+    env2_.Process(sample_rate, num_samples);
+    source_outputs_[2] = env1_.GetOutput();
+    source_outputs_[3] = env2_.GetOutput();
 
-        // Check for amount modulation
-        float effective_amount = amount;
-        if (i == 0) {  // LFO1
-            // Check if anything modulates LFO1 Amount
-            for (int j = 0; j < 4; ++j) {
-                if (j != i && destinations_[j] == ModDestination::Lfo1Amount) {
-                    float mod_amt = amounts_[j] / 64.0f;
-                    float mod_out = (j < 2) ? source_outputs_[j] : source_outputs_[j];
-                    effective_amount += mod_out * mod_amt * 0.5f;  // Scale modulation of amount
-                }
-            }
-        } else if (i == 1) {  // LFO2
-            for (int j = 0; j < 4; ++j) {
-                if (j != i && destinations_[j] == ModDestination::Lfo2Amount) {
-                    float mod_amt = amounts_[j] / 64.0f;
-                    float mod_out = (j < 2) ? source_outputs_[j] : source_outputs_[j];
-                    effective_amount += mod_out * mod_amt * 0.5f;
-                }
-            }
-        }
+    float amount_mod[2] = {0.0f, 0.0f};
+    RunOps(0, num_rate_ops_, amount_mod);
+    lfo1_.SetRateModulation(std::clamp(mod_values_[static_cast<int>(ModDestination::Lfo1Rate)], -1.0f, 1.0f));
+    lfo2_.SetRateModulation(std::clamp(mod_values_[static_cast<int>(ModDestination::Lfo2Rate)], -1.0f, 1.0f));
 
-        int dest_idx = static_cast<int>(dest);
-        if (dest_idx >= 0 && dest_idx < static_cast<int>(ModDestination::NumDestinations)) {
-            mod_values_[dest_idx] += output * effective_amount;
-        }
-    }
+    // LFOs are bipolar (-1 to 1), envelopes unipolar (0 to 1) so a positive
+    // amount pushes the value up while the envelope is active
+    source_outputs_[0] = AverageOver(lfo1_, sample_rate, num_samples, lfo_scratch_);
+    source_outputs_[1] = AverageOver(lfo2_, sample_rate, num_samples, lfo_scratch_);
+    RunOps(num_rate_ops_, num_ops_, amount_mod);
 
     // Clamp final modulation values
     for (int i = 0; i < static_cast<int>(ModDestination::NumDestinations); ++i) {
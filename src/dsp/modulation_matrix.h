@@ -5,6 +5,8 @@
 
 #include "lfo.h"
 #include "mod_envelope.h"
+#include <cstddef>
+#include <cstdint>
 
 namespace braids {
 
@@ -28,8 +30,23 @@ enum class ModSource {
     NumSources
 };
 
+// One routing: a source scaled by an amount into a destination
+struct ModSlot {
+    ModSource source = ModSource::Lfo1;
+    ModDestination destination = ModDestination::Timbre;
+    int8_t amount = 0;  // -64 to +63, 0 is off unless an LFO amount is modulated
+};
+
+// Any source can reach any destination through any slot. The routing is
+// compiled into a flat list of the slots that do something, ordered so LFO
+// rate slots run before the LFOs advance and slots feeding an LFO amount
+// before the slots that LFO drives, and recompiled only when it changes
 class ModulationMatrix {
 public:
+    // One per source: the plugin has parameters, state and rows for these
+    // and no more
+    static constexpr size_t kNumSlots = 4;
+
     ModulationMatrix() = default;
     ~ModulationMatrix() = default;
 
@@ -48,7 +65,15 @@ public:
     const ModEnvelope& GetEnv1() const { return env1_; }
     const ModEnvelope& GetEnv2() const { return env2_; }
 
-    // Routing
+    // Routing by slot
+    void SetSlot(size_t slot, ModSource source, ModDestination dest, int8_t amount);
+    const ModSlot& GetSlot(size_t slot) const { return slots_[slot]; }
+
+    // Slots that did something at the last Process
+    size_t GetNumActiveSlots() const { return num_ops_; }
+
+    // Routing by source: slots 0-3 start out as one per source, in source
+    // order, and these address them
     void SetDestination(ModSource source, ModDestination dest);
     void SetAmount(ModSource source, int8_t amount);  // -64 to +63
 
@@ -58,12 +83,26 @@ public:
     // Set tempo for LFOs
     void SetTempo(double bpm);
 
+    // Lock the LFOs to the host's position in quarter notes (call at the
+    // start of a block while the transport plays)
+    void SyncToBeat(double ppq_position);
+
+    // Seeds the LFOs' sample and hold, each from its own stream
+    void Seed(uint32_t seed);
+
     // Trigger envelopes (call on first note after silence)
     void TriggerEnvelopes();
 
-    // Process all mod sources (call once per audio block)
+    // Process all mod sources over num_samples (call once per control tick).
+    // An LFO's output is its average over the tick, so fast shapes don't
+    // alias into the control stream
     void Process(float sample_rate, int num_samples);
 
+    // Source value used at the last Process
+    float GetSourceOutput(ModSource source) const {
+        return source_outputs_[static_cast<int>(source)];
+    }
+
     // Get total modulation for a destination (-1 to +1 range)
     float GetModulation(ModDestination dest) const;
 
@@ -74,25 +113,42 @@ public:
     static const char* GetDestinationName(ModDestination dest);
 
 private:
+    static constexpr int kNumSources = static_cast<int>(ModSource::NumSources);
+
+    // A compiled slot. feeds is the LFO whose amount this slot modulates,
+    // scaled_by the LFO whose amount modulation scales this one, -1 if none
+    struct Op {
+        uint8_t source;
+        uint8_t destination;
+        int8_t feeds;
+        int8_t scaled_by;
+        float amount;
+    };
+
+    void Compile();
+    void RunOps(size_t begin, size_t end, float* amount_mod);
+    static float AverageOver(Lfo& lfo, float sample_rate, int num_samples, float* scratch);
+
     Lfo lfo1_;
     Lfo lfo2_;
     ModEnvelope env1_;
     ModEnvelope env2_;
 
-    // Routing: each source has one destination and amount
-    ModDestination destinations_[4] = {
-        ModDestination::Timbre,  // LFO1 default
-        ModDestination::Color,   // LFO2 default
-        ModDestination::Timbre,  // ENV1 default
-        ModDestination::Color    // ENV2 default
-    };
-    int8_t amounts_[4] = {0, 0, 0, 0};  // All off by default
+    ModSlot slots_[kNumSlots];
+    Op ops_[kNumSlots];
+    size_t num_ops_ = 0;
+    size_t num_rate_ops_ = 0;  // At the front of ops_
+    bool routing_changed_ = true;
 
     // Current modulation values per destination (after processing)
     float mod_values_[static_cast<int>(ModDestination::NumDestinations)] = {0};
 
     // Cache source outputs
-    float source_outputs_[4] = {0};
+    float source_outputs_[kNumSources] = {0};
+
+    // Per-sample LFO output, a chunk at a time
+    static constexpr int kLfoChunkSize = 32;
+    float lfo_scratch_[kLfoChunkSize] = {0};
 
     double tempo_bpm_ = 120.0;
 };
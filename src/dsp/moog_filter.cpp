@@ -83,4 +83,12 @@ float MoogFilter::Process(float input)
     return stage_[3];
 }
 
+void MoogFilter::Process(float* buffer, size_t size)
+{
+    // The ladder feeds back every sample, so this stays a serial loop
+    for (size_t i = 0; i < size; ++i) {
+        buffer[i] = Process(buffer[i]);
+    }
+}
+
 } // namespace braids
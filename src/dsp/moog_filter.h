@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
 
 namespace braids {
 
@@ -27,6 +28,9 @@ public:
     // Process a single sample
     float Process(float input);
 
+    // Process a buffer in place
+    void Process(float* buffer, size_t size);
+
     // Get current settings
     float GetCutoff() const { return cutoff_hz_; }
     float GetResonance() const { return resonance_; }
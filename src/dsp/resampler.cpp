@@ -2,60 +2,70 @@
 // BraidsVST: GPL v3
 
 #include "resampler.h"
+#include "stmlib/dsp.h"
 
 void Resampler::Init(double sourceSampleRate, double targetSampleRate)
 {
     ratio_ = sourceSampleRate / targetSampleRate;
-    phase_ = 0.0;
-    lastSample_ = 0;
+    Reset();
 }
 
 void Resampler::Reset()
 {
-    phase_ = 0.0;
-    lastSample_ = 0;
+    // Pull two samples before the first output so it lands on input[0]
+    phase_ = 2.0;
+    s0_ = 0;
+    s1_ = 0;
 }
 
 size_t Resampler::Process(const int16_t* input, size_t inputSize,
-                          float* output, size_t maxOutputSize)
+                          float* output, size_t maxOutputSize,
+                          size_t* consumed)
 {
     size_t outputWritten = 0;
     size_t inputIndex = 0;
 
-    while (outputWritten < maxOutputSize) {
-        // Calculate which input samples we're interpolating between
-        size_t idx0 = static_cast<size_t>(phase_);
+    // Walking the window is serial; the interpolation runs as a block kernel
+    float s0[kLerpBlockSize];
+    float s1[kLerpBlockSize];
+    float frac[kLerpBlockSize];
+    size_t pending = 0;
+    bool inputDone = false;
 
-        if (idx0 >= inputSize) {
-            // Consumed all input
-            break;
+    while (outputWritten + pending < maxOutputSize) {
+        // Advance the interpolation window, pulling input as needed
+        while (phase_ >= 1.0 && inputIndex < inputSize) {
+            s0_ = s1_;
+            s1_ = input[inputIndex++];
+            phase_ -= 1.0;
         }
+        if (phase_ >= 1.0) {
+            // Consumed all input
+            inputDone = true;
+        } else {
+            s0[pending] = s0_;
+            s1[pending] = s1_;
+            frac[pending] = static_cast<float>(phase_);
+            ++pending;
 
-        // Get samples for interpolation
-        int16_t s0 = (idx0 == 0 && phase_ < 1.0) ? lastSample_ : input[idx0];
-        int16_t s1 = (idx0 + 1 < inputSize) ? input[idx0 + 1] : input[idx0];
-
-        // Linear interpolation
-        double frac = phase_ - static_cast<double>(idx0);
-        double interpolated = s0 + (s1 - s0) * frac;
-
-        // Convert to float (-1.0 to 1.0)
-        output[outputWritten++] = static_cast<float>(interpolated / 32768.0);
-
-        // Advance phase by ratio (consuming ratio_ input samples per output sample)
-        phase_ += ratio_;
-    }
+            // Advance phase by ratio (consuming ratio_ input samples per output sample)
+            phase_ += ratio_;
+        }
 
-    // Save last sample for next block's interpolation
-    if (inputSize > 0) {
-        lastSample_ = input[inputSize - 1];
+        if (pending == kLerpBlockSize || inputDone ||
+            outputWritten + pending == maxOutputSize) {
+            // Linear interpolation, converted to float (-1.0 to 1.0)
+            stmlib::LerpBlock(s0, s1, frac, 1.0f / 32768.0f, output + outputWritten, pending);
+            outputWritten += pending;
+            pending = 0;
+        }
+        if (inputDone) {
+            break;
+        }
     }
 
-    // Adjust phase to be relative to next block
-    phase_ -= static_cast<double>(inputSize);
-    if (phase_ < 0.0) {
-        phase_ = 0.0;
+    if (consumed) {
+        *consumed = inputIndex;
     }
-
     return outputWritten;
 }
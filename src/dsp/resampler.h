@@ -15,14 +15,20 @@ public:
     void Reset();
 
     // Process input samples (int16) and produce output samples (float)
-    // Returns number of output samples written
+    // Returns number of output samples written. Input is consumed as a
+    // continuous stream: stopping at maxOutputSize leaves the rest of the
+    // input unread, and *consumed (if given) says how much was used
     size_t Process(const int16_t* input, size_t inputSize,
-                   float* output, size_t maxOutputSize);
+                   float* output, size_t maxOutputSize,
+                   size_t* consumed = nullptr);
 
     double ratio() const { return ratio_; }
 
 private:
+    static constexpr size_t kLerpBlockSize = 64;
+
     double ratio_ = 1.0;           // source/target ratio
-    double phase_ = 0.0;           // Fractional position in input
-    int16_t lastSample_ = 0;       // Previous sample for interpolation
+    double phase_ = 2.0;           // Position past s0_; >= 1 pulls more input
+    int16_t s0_ = 0;               // Samples being interpolated between
+    int16_t s1_ = 0;
 };
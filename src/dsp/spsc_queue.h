@@ -0,0 +1,63 @@
+// SpscQueue - lock-free single-producer single-consumer ring buffer
+// BraidsVST: GPL v3
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Fixed-capacity FIFO for handing values from one thread to one other, such
+// as the audio thread to the message thread. Neither side blocks or
+// allocates: Push fails when the queue is full and Pop when it is empty.
+// Capacity must be a power of two; one slot is kept free to tell full from
+// empty, so it holds up to Capacity - 1 values
+template <typename T, size_t Capacity>
+class SpscQueue {
+public:
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+    SpscQueue() = default;
+    ~SpscQueue() = default;
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side. Returns false, dropping the value, when full
+    bool Push(const T& value) {
+        size_t write = write_.load(std::memory_order_relaxed);
+        size_t next = (write + 1) & kMask;
+        if (next == read_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        items_[write] = value;
+        write_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false, leaving value alone, when empty
+    bool Pop(T& value) {
+        size_t read = read_.load(std::memory_order_relaxed);
+        if (read == write_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = items_[read];
+        read_.store((read + 1) & kMask, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when the other side is running
+    size_t size() const {
+        return (write_.load(std::memory_order_acquire) -
+                read_.load(std::memory_order_acquire)) & kMask;
+    }
+    bool empty() const { return size() == 0; }
+
+private:
+    static constexpr size_t kMask = Capacity - 1;
+
+    T items_[Capacity] = {};
+    // On separate cache lines so the two threads don't contend
+    alignas(64) std::atomic<size_t> write_ { 0 };
+    alignas(64) std::atomic<size_t> read_ { 0 };
+};
@@ -0,0 +1,61 @@
+// CPU feature detection for runtime SIMD dispatch
+// BraidsVST: GPL v3
+
+#include "cpu.h"
+
+#if STMLIB_X86 && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace stmlib {
+
+static SimdLevel DetectSimdLevel()
+{
+#if STMLIB_X86 && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return SimdLevel::Sse41;
+    }
+#elif STMLIB_X86 && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    bool sse41 = (info[2] & (1 << 19)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+
+    // AVX (and AVX-512) state must also be enabled by the OS
+    unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    bool os_avx = avx && (xcr0 & 0x6) == 0x6;
+    bool os_avx512 = os_avx && (xcr0 & 0xe0) == 0xe0;
+    if (os_avx && max_leaf >= 7) {
+        __cpuidex(info, 7, 0);
+        if (os_avx512 && (info[1] & (1 << 16))) {
+            return SimdLevel::Avx512;
+        }
+        if (info[1] & (1 << 5)) {
+            return SimdLevel::Avx2;
+        }
+    }
+    if (sse41) {
+        return SimdLevel::Sse41;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdLevel simd_level()
+{
+    static const SimdLevel level = DetectSimdLevel();
+    return level;
+}
+
+} // namespace stmlib
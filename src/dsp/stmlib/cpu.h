@@ -0,0 +1,36 @@
+// CPU feature detection for runtime SIMD dispatch
+// BraidsVST: GPL v3
+
+#pragma once
+
+// x86 SIMD kernels are compiled per function with target attributes (or
+// plain intrinsics on MSVC), so no global -m flags are needed; other
+// architectures always take the scalar paths
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define STMLIB_X86 1
+#else
+#define STMLIB_X86 0
+#endif
+
+#if STMLIB_X86 && (defined(__GNUC__) || defined(__clang__))
+#define STMLIB_TARGET(features) __attribute__((target(features)))
+#else
+#define STMLIB_TARGET(features)
+#endif
+
+namespace stmlib {
+
+// Ordered: each level implies the ones below it. Scalar is the baseline
+// build (SSE2 on x86-64)
+enum class SimdLevel {
+    Scalar = 0,
+    Sse41,
+    Avx2,
+    Avx512,
+    NumLevels
+};
+
+// Best level supported by this CPU and OS, detected once
+SimdLevel simd_level();
+
+} // namespace stmlib
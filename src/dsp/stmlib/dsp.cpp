@@ -0,0 +1,239 @@
+// Block versions of the stmlib/utils/dsp.h helpers, with SIMD kernels
+// BraidsVST: GPL v3
+
+#include "dsp.h"
+#include "cpu.h"
+#include <cstring>
+
+#if STMLIB_X86
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12 warns inside its own AVX-512 headers (_mm512_undefined_epi32)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#else
+#include <immintrin.h>
+#endif
+#endif
+
+// Built with -ffp-contract=off (see CMakeLists.txt), which keeps a * b + c
+// as two roundings on targets with FMA, so every level gives the same
+// results as the baseline build
+
+namespace stmlib {
+
+// Plain loops, written once and compiled again for each target level by
+// STMLIB_DEFINE_KERNELS below, so the compiler vectorises them for each
+// target (it may still pick 256-bit vectors for AVX-512)
+static inline void Interpolate824Loop(const int16_t* table, const uint32_t* phases,
+                                      int16_t* out, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = Interpolate824(table, phases[i]);
+    }
+}
+
+static inline void AddLoop(const float* in, float* out, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        out[i] += in[i];
+    }
+}
+
+static inline void AddScaledLoop(const int16_t* in, float scale, float* out, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        out[i] += static_cast<float>(in[i]) * scale;
+    }
+}
+
+static inline void LerpLoop(const float* a, const float* b, const float* frac, float scale,
+                            float* out, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = (a[i] + (b[i] - a[i]) * frac[i]) * scale;
+    }
+}
+
+#define STMLIB_DEFINE_KERNELS(suffix, target)                                          \
+    target static void Add##suffix(const float* in, float* out, size_t size)          \
+    {                                                                                 \
+        AddLoop(in, out, size);                                                       \
+    }                                                                                 \
+    target static void AddScaled##suffix(const int16_t* in, float scale, float* out,   \
+                                         size_t size)                                 \
+    {                                                                                 \
+        AddScaledLoop(in, scale, out, size);                                          \
+    }                                                                                 \
+    target static void Lerp##suffix(const float* a, const float* b, const float* frac, \
+                                    float scale, float* out, size_t size)             \
+    {                                                                                 \
+        LerpLoop(a, b, frac, scale, out, size);                                       \
+    }
+
+STMLIB_DEFINE_KERNELS(Scalar, )
+
+static void Interpolate824Scalar(const int16_t* table, const uint32_t* phases,
+                                 int16_t* out, size_t size)
+{
+    Interpolate824Loop(table, phases, out, size);
+}
+
+#if STMLIB_X86
+
+STMLIB_DEFINE_KERNELS(Sse41, STMLIB_TARGET("sse4.1"))
+STMLIB_DEFINE_KERNELS(Avx2, STMLIB_TARGET("avx2"))
+STMLIB_DEFINE_KERNELS(Avx512, STMLIB_TARGET("avx512f"))
+
+// Interpolate824 is a table gather, which compilers do not vectorise on
+// their own, so it gets hand-written kernels. (b - a) * frac can take 33
+// bits, so they multiply by the two bytes of frac in turn:
+// (d * hi + (d * lo >> 8)) >> 8 rounds down exactly as d * frac >> 16
+
+// table[index] in the low half, table[index + 1] in the high half
+static inline int32_t LoadPair(const int16_t* table, uint32_t phase)
+{
+    int32_t pair;
+    std::memcpy(&pair, table + (phase >> 24), sizeof(pair));
+    return pair;
+}
+
+STMLIB_TARGET("sse4.1")
+static void Interpolate824Sse41(const int16_t* table, const uint32_t* phases,
+                                int16_t* out, size_t size)
+{
+    const __m128i byte_mask = _mm_set1_epi32(0xff);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i phase = _mm_loadu_si128(reinterpret_cast<const __m128i*>(phases + i));
+        __m128i frac_hi = _mm_and_si128(_mm_srli_epi32(phase, 16), byte_mask);
+        __m128i frac_lo = _mm_and_si128(_mm_srli_epi32(phase, 8), byte_mask);
+        __m128i pair = _mm_set_epi32(LoadPair(table, phases[i + 3]), LoadPair(table, phases[i + 2]),
+                                     LoadPair(table, phases[i + 1]), LoadPair(table, phases[i]));
+        __m128i a = _mm_srai_epi32(_mm_slli_epi32(pair, 16), 16);
+        __m128i b = _mm_srai_epi32(pair, 16);
+        __m128i d = _mm_sub_epi32(b, a);
+        __m128i delta = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(d, frac_hi),
+            _mm_srai_epi32(_mm_mullo_epi32(d, frac_lo), 8)), 8);
+        // Keep the low 16 bits like the scalar cast, so the pack never saturates
+        __m128i result = _mm_add_epi32(a, delta);
+        result = _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(result, result));
+    }
+    Interpolate824Loop(table, phases + i, out + i, size - i);
+}
+
+STMLIB_TARGET("avx2")
+static void Interpolate824Avx2(const int16_t* table, const uint32_t* phases,
+                               int16_t* out, size_t size)
+{
+    const int* base = reinterpret_cast<const int*>(table);
+    const __m256i byte_mask = _mm256_set1_epi32(0xff);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i phase = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(phases + i));
+        __m256i index = _mm256_srli_epi32(phase, 24);
+        __m256i frac_hi = _mm256_and_si256(_mm256_srli_epi32(phase, 16), byte_mask);
+        __m256i frac_lo = _mm256_and_si256(_mm256_srli_epi32(phase, 8), byte_mask);
+        // One 32-bit gather at 2-byte scale fetches both neighbours
+        __m256i pair = _mm256_i32gather_epi32(base, index, 2);
+        __m256i a = _mm256_srai_epi32(_mm256_slli_epi32(pair, 16), 16);
+        __m256i b = _mm256_srai_epi32(pair, 16);
+        __m256i d = _mm256_sub_epi32(b, a);
+        __m256i delta = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(d, frac_hi),
+            _mm256_srai_epi32(_mm256_mullo_epi32(d, frac_lo), 8)), 8);
+        __m256i result = _mm256_add_epi32(a, delta);
+        result = _mm256_srai_epi32(_mm256_slli_epi32(result, 16), 16);
+        __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(result),
+                                         _mm256_extracti128_si256(result, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+    Interpolate824Loop(table, phases + i, out + i, size - i);
+}
+
+STMLIB_TARGET("avx512f")
+static void Interpolate824Avx512(const int16_t* table, const uint32_t* phases,
+                                 int16_t* out, size_t size)
+{
+    const __m512i byte_mask = _mm512_set1_epi32(0xff);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m512i phase = _mm512_loadu_si512(phases + i);
+        __m512i index = _mm512_srli_epi32(phase, 24);
+        __m512i frac_hi = _mm512_and_si512(_mm512_srli_epi32(phase, 16), byte_mask);
+        __m512i frac_lo = _mm512_and_si512(_mm512_srli_epi32(phase, 8), byte_mask);
+        __m512i pair = _mm512_i32gather_epi32(index, table, 2);
+        __m512i a = _mm512_srai_epi32(_mm512_slli_epi32(pair, 16), 16);
+        __m512i b = _mm512_srai_epi32(pair, 16);
+        __m512i d = _mm512_sub_epi32(b, a);
+        __m512i delta = _mm512_srai_epi32(_mm512_add_epi32(_mm512_mullo_epi32(d, frac_hi),
+            _mm512_srai_epi32(_mm512_mullo_epi32(d, frac_lo), 8)), 8);
+        // vpmovdw truncates, same as the scalar cast
+        __m256i packed = _mm512_cvtepi32_epi16(_mm512_add_epi32(a, delta));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+    Interpolate824Loop(table, phases + i, out + i, size - i);
+}
+
+#endif
+
+const DspKernels& GetDspKernels(SimdLevel level)
+{
+    static const DspKernels kScalar = {
+        Interpolate824Scalar, AddScalar, AddScaledScalar, LerpScalar };
+#if STMLIB_X86
+    static const DspKernels kSse41 = {
+        Interpolate824Sse41, AddSse41, AddScaledSse41, LerpSse41 };
+    static const DspKernels kAvx2 = {
+        Interpolate824Avx2, AddAvx2, AddScaledAvx2, LerpAvx2 };
+    static const DspKernels kAvx512 = {
+        Interpolate824Avx512, AddAvx512, AddScaledAvx512, LerpAvx512 };
+
+    switch (level) {
+        case SimdLevel::Avx512:
+            return kAvx512;
+        case SimdLevel::Avx2:
+            return kAvx2;
+        case SimdLevel::Sse41:
+            return kSse41;
+        case SimdLevel::Scalar:
+        case SimdLevel::NumLevels:
+            break;
+    }
+#else
+    (void)level;
+#endif
+    return kScalar;
+}
+
+// Chosen once, on first use
+static const DspKernels& kernels()
+{
+    static const DspKernels& selected = GetDspKernels(simd_level());
+    return selected;
+}
+
+void Interpolate824Block(const int16_t* table, const uint32_t* phases,
+                         int16_t* out, size_t size)
+{
+    kernels().interpolate_824(table, phases, out, size);
+}
+
+void AddBlock(const float* in, float* out, size_t size)
+{
+    kernels().add(in, out, size);
+}
+
+void AddScaledBlock(const int16_t* in, float scale, float* out, size_t size)
+{
+    kernels().add_scaled(in, scale, out, size);
+}
+
+void LerpBlock(const float* a, const float* b, const float* frac, float scale,
+               float* out, size_t size)
+{
+    kernels().lerp(a, b, frac, scale, out, size);
+}
+
+} // namespace stmlib
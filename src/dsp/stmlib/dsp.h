@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace stmlib {
@@ -15,9 +16,41 @@ inline int16_t Interpolate824(const int16_t* table, uint32_t phase)
     uint32_t frac = (phase >> 8) & 0xFFFF;
     int32_t a = table[index];
     int32_t b = table[index + 1];
-    return static_cast<int16_t>(a + ((b - a) * static_cast<int32_t>(frac) >> 16));
+    // A full-range step times frac needs 33 bits
+    return static_cast<int16_t>(a + (static_cast<int64_t>(b - a) * frac >> 16));
 }
 
+// Block kernels, each using the widest SIMD version the CPU supports (see
+// dsp.cpp). All of them give the same results as the plain scalar loops,
+// bit for bit
+
+// out[i] = Interpolate824(table, phases[i])
+void Interpolate824Block(const int16_t* table, const uint32_t* phases,
+                         int16_t* out, size_t size);
+
+// out[i] += in[i]
+void AddBlock(const float* in, float* out, size_t size);
+
+// out[i] += in[i] * scale
+void AddScaledBlock(const int16_t* in, float scale, float* out, size_t size);
+
+// out[i] = (a[i] + (b[i] - a[i]) * frac[i]) * scale
+void LerpBlock(const float* a, const float* b, const float* frac, float scale,
+               float* out, size_t size);
+
+enum class SimdLevel;
+
+// The kernels compiled for one SIMD level, for tests. Levels above
+// simd_level() must not be called
+struct DspKernels {
+    void (*interpolate_824)(const int16_t*, const uint32_t*, int16_t*, size_t);
+    void (*add)(const float*, float*, size_t);
+    void (*add_scaled)(const int16_t*, float, float*, size_t);
+    void (*lerp)(const float*, const float*, const float*, float, float*, size_t);
+};
+
+const DspKernels& GetDspKernels(SimdLevel level);
+
 // Linear interpolation for 8-bit tables with 8.24 phase
 inline int16_t Interpolate824(const uint8_t* table, uint32_t phase)
 {
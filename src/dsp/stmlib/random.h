@@ -8,32 +8,34 @@
 
 namespace stmlib {
 
+// Linear congruential generator. Each owner keeps its own, so instances
+// never share state and a seed reproduces the same sequence
 class Random
 {
 public:
-    static void Seed(uint32_t seed)
+    void Seed(uint32_t seed)
     {
         state_ = seed;
     }
 
-    static uint32_t GetWord()
+    uint32_t GetWord()
     {
         state_ = state_ * 1664525L + 1013904223L;
         return state_;
     }
 
-    static int16_t GetSample()
+    int16_t GetSample()
     {
         return static_cast<int16_t>(GetWord() >> 16);
     }
 
-    static float GetFloat()
+    float GetFloat()
     {
         return static_cast<float>(GetWord()) / 4294967296.0f;
     }
 
 private:
-    static inline uint32_t state_ = 0x12345678;
+    uint32_t state_ = 0x12345678;
 };
 
 } // namespace stmlib
@@ -2,101 +2,190 @@
 // BraidsVST: GPL v3
 
 #include "voice.h"
+#include "stmlib/dsp.h"
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 
-void Voice::Init(double hostSampleRate)
+void Voice::Init(double hostSampleRate, bool renderAtHostRate)
 {
     hostSampleRate_ = hostSampleRate;
+    renderAtHostRate_ = renderAtHostRate;
+    double renderRate = renderAtHostRate ? hostSampleRate : kInternalSampleRate;
+
+    // Common rates have their own increment table. Otherwise the 96 kHz one
+    // reaches the same increment by shifting pitch by the octave ratio (1536
+    // units per octave), which runs out of table at the top of the range
+    const uint32_t* increments = braids::OscillatorIncrements(renderRate);
+    pitchRateOffset_ = increments ? 0 : static_cast<int16_t>(std::lround(
+        12.0 * 128.0 * std::log2(kInternalSampleRate / renderRate)));
+    oscillator_.set_increments(increments ? increments : braids::lut_oscillator_increments);
+    oscillator_.set_sample_rate(static_cast<float>(renderRate));
+    fadeLength_ = std::max<size_t>(1, static_cast<size_t>(
+        kStealFadeSamples * renderRate / kInternalSampleRate));
+
     oscillator_.Init();
     envelope_.Init();
-    resampler_.Init(kInternalSampleRate, hostSampleRate);
+    envelope_.set_sample_rate(static_cast<float>(renderRate));
+    resampler_.Init(renderRate, hostSampleRate);
     active_ = false;
     note_ = -1;
     velocity_ = 0.0f;
+    released_ = false;
+    fading_ = false;
+    fadeRemaining_ = 0;
+    hasPending_ = false;
+    internalRead_ = 0;
+    internalSize_ = 0;
+}
+
+void Voice::NoteOn(int note, float velocity, uint16_t attack, uint16_t decay, int channel)
+{
+    channel_ = channel;
+    pitchOffset_ = 0;
+
+    if (active_) {
+        // Restarting mid-note would click: fade out first, start when silent
+        note_ = note;
+        released_ = false;
+        hasPending_ = true;
+        pendingVelocity_ = velocity;
+        pendingAttack_ = attack;
+        pendingDecay_ = decay;
+        if (!fading_) {
+            fading_ = true;
+            fadeRemaining_ = fadeLength_;
+        }
+        return;
+    }
+
+    Start(note, velocity, attack, decay);
 }
 
-void Voice::NoteOn(int note, float velocity, uint16_t attack, uint16_t decay)
+void Voice::Start(int note, float velocity, uint16_t attack, uint16_t decay)
 {
     note_ = note;
+    soundingNote_ = note;
     velocity_ = velocity;
     active_ = true;
+    released_ = false;
+    fading_ = false;
+    fadeRemaining_ = 0;
+    hasPending_ = false;
 
     // Reset oscillator phase for consistent attack
     oscillator_.Init();
 
-    // Set pitch: Braids uses note * 128
-    oscillator_.set_pitch(static_cast<int16_t>(note << 7));
-
     // Trigger envelope
     envelope_.Trigger(attack, decay);
 
-    // Reset resampler for clean start
+    // Reset resampler for clean start, dropping any unplayed samples
     resampler_.Reset();
+    internalRead_ = 0;
+    internalSize_ = 0;
 }
 
 void Voice::NoteOff()
 {
-    // For AD envelope, note off doesn't do anything special
+    // For AD envelope, note off doesn't change the sound
     // Voice becomes inactive when envelope finishes
+    released_ = true;
 }
 
-void Voice::Process(float* output, size_t size)
+void Voice::FadeOut()
 {
     if (!active_) {
         return;
     }
+    hasPending_ = false;
+    if (!fading_) {
+        fading_ = true;
+        fadeRemaining_ = fadeLength_;
+    }
+}
 
-    // Update oscillator parameters
-    oscillator_.set_shape(shape_);
-    oscillator_.set_parameters(timbre_, color_);
+void Voice::Process(float* output, size_t size)
+{
+    if (!active_) {
+        return;
+    }
 
     size_t outputWritten = 0;
 
     while (outputWritten < size) {
-        // Calculate how many 96kHz samples we need to generate
-        // to produce the remaining output samples
-        size_t outputRemaining = size - outputWritten;
-
-        // Generate internal samples at 96kHz
-        // We need approximately (outputRemaining * ratio) input samples
-        // Process in blocks of kInternalBlockSize
-        size_t internalSamples = std::min(kInternalBlockSize,
-            static_cast<size_t>(outputRemaining * resampler_.ratio()) + 4);
-
-        oscillator_.Render(syncBuffer_, internalBuffer_, internalSamples);
-
-        // Apply envelope to internal buffer
-        for (size_t i = 0; i < internalSamples; ++i) {
-            uint16_t envValue = envelope_.Render();
-            float envGain = static_cast<float>(envValue) / 65535.0f;
-
-            // Apply envelope and velocity
-            float sample = static_cast<float>(internalBuffer_[i]) / 32768.0f;
-            sample *= envGain * velocity_;
-            internalBuffer_[i] = static_cast<int16_t>(sample * 32767.0f);
+        if (internalRead_ == internalSize_) {
+            if (!active_) {
+                break;
+            }
+            RenderInternalBlock();
         }
 
-        // Check if envelope finished
-        if (envelope_.done()) {
-            active_ = false;
+        if (renderAtHostRate_) {
+            // Already at the host rate: no resampling
+            size_t count = std::min(size - outputWritten, internalSize_ - internalRead_);
+            stmlib::AddScaledBlock(internalBuffer_ + internalRead_, 1.0f / 32768.0f,
+                                   output + outputWritten, count);
+            internalRead_ += count;
+            outputWritten += count;
+            continue;
         }
 
-        // Resample to host rate
-        size_t maxOutput = std::min(outputRemaining, sizeof(resampledBuffer_) / sizeof(float));
-        size_t produced = resampler_.Process(internalBuffer_, internalSamples,
-                                              resampledBuffer_, maxOutput);
+        // Resample to host rate; whatever the resampler does not consume
+        // stays buffered for the next call, so any slice size is seamless
+        size_t maxOutput = std::min(size - outputWritten, sizeof(resampledBuffer_) / sizeof(float));
+        size_t consumed = 0;
+        size_t produced = resampler_.Process(internalBuffer_ + internalRead_,
+                                             internalSize_ - internalRead_,
+                                             resampledBuffer_, maxOutput, &consumed);
+        internalRead_ += consumed;
 
         // Mix into output (add to existing content)
-        for (size_t i = 0; i < produced; ++i) {
-            output[outputWritten + i] += resampledBuffer_[i];
-        }
+        stmlib::AddBlock(resampledBuffer_, output + outputWritten, produced);
 
         outputWritten += produced;
+    }
+}
 
-        // Safety check to prevent infinite loop
-        if (produced == 0 && internalSamples > 0) {
-            break;
+void Voice::RenderInternalBlock()
+{
+    // Old note has faded out (or ended) - start the pending one
+    if (hasPending_ && (envelope_.done() || (fading_ && fadeRemaining_ == 0))) {
+        Start(note_, pendingVelocity_, pendingAttack_, pendingDecay_);
+    }
+
+    // Update oscillator parameters (after Start, which resets them). Pitch:
+    // Braids uses note * 128; a pending note keeps the old pitch until it starts
+    int32_t pitch = (soundingNote_ << 7) + pitchOffset_ + pitchRateOffset_;
+    oscillator_.set_pitch(static_cast<int16_t>(std::clamp(pitch, 0, 32767)));
+    oscillator_.set_shape(shape_);
+    oscillator_.set_parameters(timbre_, color_);
+
+    // Generate internal samples at 96kHz
+    oscillator_.Render(syncBuffer_, internalBuffer_, kInternalBlockSize);
+
+    // Apply envelope to internal buffer
+    for (size_t i = 0; i < kInternalBlockSize; ++i) {
+        uint16_t envValue = envelope_.Render();
+        float envGain = static_cast<float>(envValue) / 65535.0f;
+        if (fading_) {
+            envGain *= static_cast<float>(fadeRemaining_) / static_cast<float>(fadeLength_);
+            if (fadeRemaining_ > 0) {
+                --fadeRemaining_;
+            }
         }
+
+        // Apply envelope and velocity
+        float sample = static_cast<float>(internalBuffer_[i]) / 32768.0f;
+        sample *= envGain * velocity_;
+        internalBuffer_[i] = static_cast<int16_t>(sample * 32767.0f);
+    }
+    internalRead_ = 0;
+    internalSize_ = kInternalBlockSize;
+
+    // Check if envelope (or a steal fade) finished; the block just rendered
+    // still plays out before the voice goes quiet
+    bool silent = envelope_.done() || (fading_ && fadeRemaining_ == 0);
+    if (silent && !hasPending_) {
+        active_ = false;
     }
 }
@@ -12,15 +12,22 @@ class Voice {
 public:
     static constexpr double kInternalSampleRate = 96000.0;
     static constexpr size_t kInternalBlockSize = 24;
+    static constexpr size_t kStealFadeSamples = 192;  // 2ms at the internal rate
 
     Voice() = default;
     ~Voice() = default;
 
-    void Init(double hostSampleRate);
+    // renderAtHostRate runs the oscillator at the host rate and skips the
+    // resampler. The band-limited shapes keep aliasing low enough for that
+    void Init(double hostSampleRate, bool renderAtHostRate = false);
 
-    void NoteOn(int note, float velocity, uint16_t attack, uint16_t decay);
+    // Retriggering a sounding voice fades the old note out before starting
+    void NoteOn(int note, float velocity, uint16_t attack, uint16_t decay, int channel = 0);
     void NoteOff();
 
+    // Fade out over 2ms (kStealFadeSamples at 96 kHz) and go idle (used when stealing)
+    void FadeOut();
+
     // Process and mix into output buffer (adds to existing content)
     void Process(float* output, size_t size);
 
@@ -30,12 +37,26 @@ public:
         timbre_ = timbre;
         color_ = color;
     }
+    void set_wavetable(const braids::WavetableBank* bank) { oscillator_.set_wavetable(bank); }
+    void set_fm_feedback(int16_t feedback) { oscillator_.set_fm_feedback(feedback); }
+    void Seed(uint32_t seed) { oscillator_.Seed(seed); }
+
+    // Per-voice pitch offset (pitch bend) in 1/128 semitone
+    void set_pitch_offset(int16_t offset) { pitchOffset_ = offset; }
 
     // State queries
     bool active() const { return active_; }
+    bool released() const { return released_; }
+    bool fading() const { return fading_ && !hasPending_; }
     int note() const { return note_; }
+    int channel() const { return channel_; }
+    float velocity() const { return velocity_; }
+    uint16_t level() const { return envelope_.value(); }
 
 private:
+    void Start(int note, float velocity, uint16_t attack, uint16_t decay);
+    void RenderInternalBlock();
+
     braids::MacroOscillator oscillator_;
     braids::Envelope envelope_;
     Resampler resampler_;
@@ -43,17 +64,34 @@ private:
     // Voice state
     bool active_ = false;
     int note_ = -1;
+    int soundingNote_ = 0;  // Differs from note_ while a pending note waits
+    int channel_ = 0;
     float velocity_ = 0.0f;
+    bool released_ = false;
+
+    // Declick fade, optionally followed by a pending note
+    bool fading_ = false;
+    size_t fadeRemaining_ = 0;
+    bool hasPending_ = false;
+    float pendingVelocity_ = 0.0f;
+    uint16_t pendingAttack_ = 0;
+    uint16_t pendingDecay_ = 0;
 
     // Shared parameters (set before processing)
     braids::MacroOscillatorShape shape_ = braids::MACRO_OSC_SHAPE_FM;
     int16_t timbre_ = 0;
     int16_t color_ = 0;
+    int16_t pitchOffset_ = 0;
 
-    // Internal buffers
+    // Internal buffers - rendered a block at a time, drained by the resampler
     int16_t internalBuffer_[kInternalBlockSize];
+    size_t internalRead_ = 0;
+    size_t internalSize_ = 0;
     uint8_t syncBuffer_[kInternalBlockSize] = {0};
     float resampledBuffer_[256];  // Larger buffer for resampled output
 
     double hostSampleRate_ = 48000.0;
+    bool renderAtHostRate_ = false;
+    int16_t pitchRateOffset_ = 0;  // Pitch shift that rescales 96 kHz increments
+    size_t fadeLength_ = kStealFadeSamples;
 };
@@ -5,27 +5,64 @@
 #include <algorithm>
 #include <cstring>
 
-void VoiceAllocator::Init(double hostSampleRate, int polyphony)
+void VoiceAllocator::Init(double hostSampleRate, int polyphony, int poolSize,
+                          bool renderAtHostRate)
 {
     hostSampleRate_ = hostSampleRate;
-    polyphony_ = std::clamp(polyphony, 1, static_cast<int>(kMaxVoices));
+    renderAtHostRate_ = renderAtHostRate;
     noteCounter_ = 0;
 
-    for (size_t i = 0; i < kMaxVoices; ++i) {
-        voices_[i].Init(hostSampleRate);
-        voiceAge_[i] = 0;
+    size_t size = static_cast<size_t>(std::clamp(poolSize, 1, static_cast<int>(kMaxVoices)));
+    if (!voices_ || size != poolSize_) {
+        voices_ = std::make_unique<Voice[]>(size);
+        poolSize_ = size;
+    }
+    polyphony_ = std::clamp(polyphony, 1, static_cast<int>(poolSize_));
+
+    voiceAge_.assign(poolSize_, 0);
+    modulation_.Init();
+    modEnvelopes_[0].Init();
+    modEnvelopes_[1].Init();
+    cutoffModulation_ = 0.0f;
+    resetExpression();
+    setMpeZones(0, 0);
+    activeVoices_.clear();
+    activeVoices_.reserve(poolSize_);
+    freeVoices_.clear();
+    freeVoices_.reserve(poolSize_);
+
+    // Lowest indices end up on top of the free stack
+    for (size_t i = poolSize_; i-- > 0;) {
+        voices_[i].Init(hostSampleRate, renderAtHostRate);
+        freeVoices_.push_back(static_cast<uint16_t>(i));
+    }
+    Seed(seed_);
+}
+
+void VoiceAllocator::Seed(uint32_t seed)
+{
+    seed_ = seed;
+    for (size_t i = 0; i < poolSize_; ++i) {
+        voices_[i].Seed(seed + static_cast<uint32_t>(i + 1) * 0x9e3779b9u);
     }
 }
 
 void VoiceAllocator::setPolyphony(int polyphony)
 {
-    polyphony_ = std::clamp(polyphony, 1, static_cast<int>(kMaxVoices));
+    polyphony_ = std::clamp(polyphony, 1, static_cast<int>(std::max<size_t>(poolSize_, 1)));
 }
 
-void VoiceAllocator::NoteOn(int note, float velocity, uint16_t attack, uint16_t decay)
+void VoiceAllocator::NoteOn(int note, float velocity, uint16_t attack, uint16_t decay, int channel)
 {
-    // First check if this note is already playing - retrigger it
-    Voice* voice = findVoiceForNote(note);
+    if (!voices_) {
+        return;
+    }
+    channel = std::clamp(channel, 0, kNumChannels - 1);
+
+    // First check if this note is already playing - retrigger it. Released
+    // voices are only reused by SameNote, so other policies let tails ring out
+    bool heldOnly = stealPolicy_ != VoiceStealPolicy::SameNote;
+    Voice* voice = findVoiceForNote(note, channel, heldOnly);
 
     if (!voice) {
         // Try to find a free voice
@@ -33,21 +70,33 @@ void VoiceAllocator::NoteOn(int note, float velocity, uint16_t attack, uint16_t
     }
 
     if (!voice) {
-        // No free voice - steal the oldest one
-        voice = stealVoice();
+        // No free voice - steal one according to the policy
+        Voice* victim = stealVoice();
+        if (victim) {
+            // Crossfade onto a spare pool voice; without one the victim
+            // declicks in place (Voice::NoteOn fades before restarting)
+            voice = popFreeVoice();
+            if (voice) {
+                victim->FadeOut();
+            } else {
+                voice = victim;
+            }
+        }
     }
 
     if (voice) {
-        voice->NoteOn(note, velocity, attack, decay);
+        voice->NoteOn(note, velocity, attack, decay, channel);
         // Record when this voice was triggered
-        size_t idx = voice - &voices_[0];
+        size_t idx = voice - voices_.get();
         voiceAge_[idx] = ++noteCounter_;
+        modEnvelopes_[0].Trigger(idx);
+        modEnvelopes_[1].Trigger(idx);
     }
 }
 
-void VoiceAllocator::NoteOff(int note)
+void VoiceAllocator::NoteOff(int note, int channel)
 {
-    Voice* voice = findVoiceForNote(note);
+    Voice* voice = findVoiceForNote(note, channel, true);
     if (voice) {
         voice->NoteOff();
     }
@@ -55,8 +104,54 @@ void VoiceAllocator::NoteOff(int note)
 
 void VoiceAllocator::AllNotesOff()
 {
-    for (size_t i = 0; i < kMaxVoices; ++i) {
-        voices_[i].NoteOff();
+    for (uint16_t idx : activeVoices_) {
+        voices_[idx].NoteOff();
+    }
+}
+
+void VoiceAllocator::setPitchBend(int channel, float semitones)
+{
+    if (channel >= 0 && channel < kNumChannels) {
+        channelBend_[channel] = semitones;
+    }
+}
+
+void VoiceAllocator::setPressure(int channel, float value)
+{
+    if (channel >= 0 && channel < kNumChannels) {
+        channelPressure_[channel] = std::clamp(value, 0.0f, 1.0f);
+    }
+}
+
+void VoiceAllocator::setSlide(int channel, float value)
+{
+    if (channel >= 0 && channel < kNumChannels) {
+        channelSlide_[channel] = std::clamp(value, 0.0f, 1.0f);
+    }
+}
+
+void VoiceAllocator::resetExpression()
+{
+    std::fill(channelBend_, channelBend_ + kNumChannels, 0.0f);
+    std::fill(channelPressure_, channelPressure_ + kNumChannels, 0.0f);
+    std::fill(channelSlide_, channelSlide_ + kNumChannels, 0.0f);
+}
+
+void VoiceAllocator::setMpeZones(int lowerMembers, int upperMembers)
+{
+    // Zones may not overlap; the lower zone wins (as with an MCM update)
+    lowerMembers = std::clamp(lowerMembers, 0, kNumChannels - 1);
+    upperMembers = std::clamp(upperMembers, 0, std::max(0, kNumChannels - 2 - lowerMembers));
+
+    // Without a zone a channel is its own master
+    for (int ch = 0; ch < kNumChannels; ++ch) {
+        channelMaster_[ch] = static_cast<int8_t>(ch);
+    }
+    for (int ch = 1; ch <= lowerMembers; ++ch) {
+        channelMaster_[ch] = 0;
+    }
+    for (int ch = kNumChannels - 1 - upperMembers; ch < kNumChannels - 1; ++ch) {
+        channelMaster_[ch] = kNumChannels - 1;
     }
 }
 
@@ -66,62 +161,183 @@ void VoiceAllocator::Process(float* leftOutput, float* rightOutput, size_t size)
     std::memset(leftOutput, 0, size * sizeof(float));
     std::memset(rightOutput, 0, size * sizeof(float));
 
-    // Update shared parameters and process each active voice
-    for (size_t i = 0; i < static_cast<size_t>(polyphony_); ++i) {
-        if (voices_[i].active()) {
-            voices_[i].set_shape(shape_);
-            voices_[i].set_parameters(timbre_, color_);
-            voices_[i].Process(leftOutput, size);
+    // Render in control-rate slices: per-voice modulation is evaluated for
+    // all sounding voices at once, then each voice renders the slice
+    for (size_t offset = 0; offset < size; offset += kControlBlockSize) {
+        size_t slice = std::min(kControlBlockSize, size - offset);
+        for (auto& envelopes : modEnvelopes_) {
+            envelopes.Process(activeVoices_.data(), activeVoices_.size(),
+                              static_cast<float>(hostSampleRate_), static_cast<int>(slice));
+        }
+        updateModulation();
+        for (size_t i = 0; i < activeVoices_.size(); ++i) {
+            Voice& voice = voices_[activeVoices_[i]];
+            voice.set_shape(shape_);
+            voice.set_wavetable(wavetable_);
+            voice.set_fm_feedback(fmFeedback_);
+            voice.set_parameters(modulation_.timbre(i), modulation_.color(i));
+            voice.set_pitch_offset(modulation_.pitch(i));
+            voice.Process(leftOutput + offset, slice);
+        }
+    }
+
+    // Only sounding voices are visited; voices whose envelope finished during
+    // this block go back on the free stack (capacity reserved in Init)
+    size_t kept = 0;
+    for (size_t i = 0; i < activeVoices_.size(); ++i) {
+        uint16_t idx = activeVoices_[i];
+        if (voices_[idx].active()) {
+            activeVoices_[kept++] = idx;
+        } else {
+            freeVoices_.push_back(idx);
         }
     }
+    activeVoices_.resize(kept);
 
     // Copy mono to stereo
     std::memcpy(rightOutput, leftOutput, size * sizeof(float));
 }
 
+void VoiceAllocator::updateModulation()
+{
+    // Gather sources into slots matching the order of activeVoices_. Zone
+    // masters add their bend and raise pressure/slide for all members
+    size_t count = activeVoices_.size();
+    for (size_t i = 0; i < count; ++i) {
+        const Voice& voice = voices_[activeVoices_[i]];
+        int channel = voice.channel();
+        int master = channelMaster_[channel];
+        float bend = channelBend_[channel];
+        if (master != channel) {
+            bend += channelBend_[master];
+        }
+        modulation_.set_source(i, VoiceModSource::Velocity, voice.velocity());
+        modulation_.set_source(i, VoiceModSource::Envelope,
+                               static_cast<float>(voice.level()) / 65535.0f);
+        modulation_.set_source(i, VoiceModSource::Pressure,
+                               std::max(channelPressure_[channel], channelPressure_[master]));
+        modulation_.set_source(i, VoiceModSource::Slide,
+                               std::max(channelSlide_[channel], channelSlide_[master]));
+        modulation_.set_source(i, VoiceModSource::ModEnv1, modEnvelopes_[0].output(activeVoices_[i]));
+        modulation_.set_source(i, VoiceModSource::ModEnv2, modEnvelopes_[1].output(activeVoices_[i]));
+        modulation_.set_pitch_bend(i, bend);
+    }
+
+    modulation_.Process(count, static_cast<float>(timbre_) / 32767.0f,
+                        static_cast<float>(color_) / 32767.0f);
+
+    float cutoff = 0.0f;
+    if (modulation_.modulates_cutoff()) {
+        for (size_t i = 0; i < count; ++i) {
+            if (i == 0 || modulation_.cutoff(i) > cutoff) {
+                cutoff = modulation_.cutoff(i);
+            }
+        }
+    }
+    cutoffModulation_ = cutoff;
+}
+
 int VoiceAllocator::activeVoiceCount() const
 {
     int count = 0;
-    for (size_t i = 0; i < static_cast<size_t>(polyphony_); ++i) {
-        if (voices_[i].active()) {
+    for (uint16_t idx : activeVoices_) {
+        if (!voices_[idx].fading()) {
             ++count;
         }
     }
     return count;
 }
 
-Voice* VoiceAllocator::findFreeVoice()
+bool VoiceAllocator::isNotePlaying(int note) const
 {
-    for (size_t i = 0; i < static_cast<size_t>(polyphony_); ++i) {
-        if (!voices_[i].active()) {
-            return &voices_[i];
+    for (uint16_t idx : activeVoices_) {
+        if (!voices_[idx].fading() && voices_[idx].note() == note) {
+            return true;
         }
     }
-    return nullptr;
+    return false;
 }
 
-Voice* VoiceAllocator::findVoiceForNote(int note)
+Voice* VoiceAllocator::findFreeVoice()
 {
-    for (size_t i = 0; i < static_cast<size_t>(polyphony_); ++i) {
-        if (voices_[i].active() && voices_[i].note() == note) {
-            return &voices_[i];
+    // Respect the polyphony limit even when the pool still has idle voices
+    if (activeVoiceCount() >= polyphony_) {
+        return nullptr;
+    }
+    return popFreeVoice();
+}
+
+Voice* VoiceAllocator::popFreeVoice()
+{
+    if (freeVoices_.empty()) {
+        return nullptr;
+    }
+
+    // Move the voice from the free stack to the active list
+    uint16_t idx = freeVoices_.back();
+    freeVoices_.pop_back();
+    activeVoices_.push_back(idx);
+    // Only voices still sounding carry their envelopes on: a voice that
+    // finished mid-envelope was left wherever it stopped
+    modEnvelopes_[0].Reset(idx);
+    modEnvelopes_[1].Reset(idx);
+    return &voices_[idx];
+}
+
+Voice* VoiceAllocator::findVoiceForNote(int note, int channel, bool heldOnly)
+{
+    for (uint16_t idx : activeVoices_) {
+        const Voice& voice = voices_[idx];
+        if (voice.fading() || voice.note() != note || voice.channel() != channel) {
+            continue;
+        }
+        if (heldOnly && voice.released()) {
+            continue;
         }
+        return &voices_[idx];
     }
     return nullptr;
 }
 
 Voice* VoiceAllocator::stealVoice()
 {
-    // Find the oldest voice (lowest age counter)
-    size_t oldest = 0;
-    uint32_t oldestAge = voiceAge_[0];
+    // Candidates are sounding voices; ones already fading out are on their way
+    int best = -1;
+    float bestLevel = 0.0f;
+    bool bestReleased = false;
+
+    for (uint16_t idx : activeVoices_) {
+        const Voice& voice = voices_[idx];
+        if (voice.fading()) {
+            continue;
+        }
+
+        float level = static_cast<float>(voice.level()) * voice.velocity();
+        bool released = voice.released();
+        bool older = best < 0 || voiceAge_[idx] < voiceAge_[static_cast<size_t>(best)];
+        bool better = false;
+
+        switch (stealPolicy_) {
+            case VoiceStealPolicy::Quietest:
+                better = best < 0 || level < bestLevel || (level == bestLevel && older);
+                break;
+            case VoiceStealPolicy::OldestReleased:
+                better = best < 0 || (released && !bestReleased) ||
+                         (released == bestReleased && older);
+                break;
+            case VoiceStealPolicy::SameNote:
+            case VoiceStealPolicy::Oldest:
+            default:
+                better = older;
+                break;
+        }
 
-    for (size_t i = 1; i < static_cast<size_t>(polyphony_); ++i) {
-        if (voiceAge_[i] < oldestAge) {
-            oldest = i;
-            oldestAge = voiceAge_[i];
+        if (better) {
+            best = idx;
+            bestLevel = level;
+            bestReleased = released;
         }
     }
 
-    return &voices_[oldest];
+    return best < 0 ? nullptr : &voices_[best];
 }
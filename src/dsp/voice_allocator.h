@@ -3,23 +3,61 @@
 
 #pragma once
 
-#include <array>
 #include <cstdint>
+#include <memory>
+#include <vector>
 #include "voice.h"
+#include "voice_modulation.h"
+#include "mod_envelope.h"
+
+// Which voice to take when every voice up to the polyphony limit is sounding
+enum class VoiceStealPolicy {
+    SameNote = 0,    // Reuse any voice playing the same note, else the oldest
+    Oldest,          // Oldest note first
+    Quietest,        // Lowest envelope level (scaled by velocity) first
+    OldestReleased,  // Oldest note whose key is up, else the oldest
+    NumPolicies
+};
 
 class VoiceAllocator {
 public:
-    static constexpr size_t kMaxVoices = 16;
+    // Hard ceiling on the voice pool; the pool itself is sized in Init()
+    static constexpr size_t kMaxVoices = 128;
+    static constexpr size_t kDefaultPoolSize = 64;
+    // Per-voice modulation is recomputed every kControlBlockSize host samples
+    static constexpr size_t kControlBlockSize = 32;
+    static_assert(VoiceModulation::kMaxSlots >= kMaxVoices, "one modulation slot per voice");
+    static_assert(braids::ModEnvelopeBank::kMaxEnvelopes >= kMaxVoices, "one envelope per voice");
 
     VoiceAllocator() = default;
     ~VoiceAllocator() = default;
 
-    void Init(double hostSampleRate, int polyphony);
+    // Allocates the voice pool - call from prepareToPlay, never from the audio thread.
+    // renderAtHostRate skips the 96 kHz oversampling (see Voice::Init)
+    void Init(double hostSampleRate, int polyphony,
+              int poolSize = static_cast<int>(kDefaultPoolSize),
+              bool renderAtHostRate = false);
 
-    void NoteOn(int note, float velocity, uint16_t attack, uint16_t decay);
-    void NoteOff(int note);
+    // Channels are 0-15. Notes are matched by note and channel, so the same
+    // note held on two MPE member channels is two voices
+    void NoteOn(int note, float velocity, uint16_t attack, uint16_t decay, int channel = 0);
+    void NoteOff(int note, int channel = 0);
     void AllNotesOff();
 
+    // Channel expression, applied to every voice on that channel at control
+    // rate. Under MPE each note has its own member channel, so this is per note
+    void setPitchBend(int channel, float semitones);
+    void setPressure(int channel, float value);   // 0-1
+    void setSlide(int channel, float value);      // 0-1 (CC74)
+    void resetExpression();
+
+    // MPE zones by member channel count (0 disables a zone). The lower zone's
+    // master is channel 0 with members 1..n, the upper zone's master is
+    // channel 15 with members 15-n..14. Master channel expression applies to
+    // every voice in its zone on top of the member channel's own
+    void setMpeZones(int lowerMembers, int upperMembers);
+    int mpeMaster(int channel) const { return channelMaster_[channel & (kNumChannels - 1)]; }
+
     // Process all voices and mix to stereo output
     void Process(float* leftOutput, float* rightOutput, size_t size);
 
@@ -29,28 +67,77 @@ public:
         timbre_ = timbre;
         color_ = color;
     }
+    // Seeds every voice's noise, each from its own stream. Init reseeds with
+    // the last seed, so a render after Init is reproducible
+    void Seed(uint32_t seed);
+
+    // Bank for the wavetable shape; the caller keeps it alive while set
+    void set_wavetable(const braids::WavetableBank* bank) { wavetable_ = bank; }
+    // Modulator self-feedback of the FM shape, 0 (off) to 32767
+    void set_fm_feedback(int16_t feedback) { fmFeedback_ = feedback; }
+
+    // Per-voice modulation routing (velocity / amp envelope -> timbre, colour, cutoff)
+    VoiceModulation& modulation() { return modulation_; }
+    const VoiceModulation& modulation() const { return modulation_; }
 
-    // Polyphony control
+    // Per-voice ENV1 (0) and ENV2 (1): every note triggers its voice's pair,
+    // advanced at control rate and fed to the ModEnv1/ModEnv2 sources
+    braids::ModEnvelopeBank& modEnvelopes(int env) { return modEnvelopes_[env & 1]; }
+
+    // Cutoff offset requested by the voices over the last block. The filter
+    // is shared, so this is the largest per-voice offset (0 when unrouted)
+    float cutoffModulation() const { return cutoffModulation_; }
+
+    // Polyphony control (clamped to the pool size)
     void setPolyphony(int polyphony);
     int polyphony() const { return polyphony_; }
+    int poolSize() const { return static_cast<int>(poolSize_); }
+    bool renderAtHostRate() const { return renderAtHostRate_; }
+
+    // Stolen voices fade out over Voice::kStealFadeSamples. If the pool has a
+    // spare voice the new note starts there, so the two crossfade
+    void setStealPolicy(VoiceStealPolicy policy) { stealPolicy_ = policy; }
+    VoiceStealPolicy stealPolicy() const { return stealPolicy_; }
 
-    // State queries
+    // State queries - voices fading out after a steal are not counted
     int activeVoiceCount() const;
+    bool isNotePlaying(int note) const;
 
 private:
     Voice* findFreeVoice();
-    Voice* findVoiceForNote(int note);
+    Voice* popFreeVoice();
+    Voice* findVoiceForNote(int note, int channel, bool heldOnly);
     Voice* stealVoice();
+    void updateModulation();
 
-    std::array<Voice, kMaxVoices> voices_;
-    std::array<uint32_t, kMaxVoices> voiceAge_;  // For voice stealing
+    std::unique_ptr<Voice[]> voices_;
+    std::vector<uint32_t> voiceAge_;      // For voice stealing
+    std::vector<uint16_t> activeVoices_;  // Indices of sounding voices, render order
+    std::vector<uint16_t> freeVoices_;    // Stack of idle voice indices
+    size_t poolSize_ = 0;
     uint32_t noteCounter_ = 0;
+    uint32_t seed_ = 0;
 
     int polyphony_ = 8;
+    VoiceStealPolicy stealPolicy_ = VoiceStealPolicy::SameNote;
     double hostSampleRate_ = 48000.0;
+    bool renderAtHostRate_ = false;
+
+    VoiceModulation modulation_;
+    braids::ModEnvelopeBank modEnvelopes_[2];
+    float cutoffModulation_ = 0.0f;
+
+    // Per-channel expression and the zone master each channel answers to
+    static constexpr int kNumChannels = 16;
+    float channelBend_[kNumChannels] = {};
+    float channelPressure_[kNumChannels] = {};
+    float channelSlide_[kNumChannels] = {};
+    int8_t channelMaster_[kNumChannels] = {};
 
     // Shared parameters
     braids::MacroOscillatorShape shape_ = braids::MACRO_OSC_SHAPE_FM;
     int16_t timbre_ = 0;
     int16_t color_ = 0;
+    const braids::WavetableBank* wavetable_ = nullptr;
+    int16_t fmFeedback_ = 0;
 };
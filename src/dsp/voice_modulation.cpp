@@ -0,0 +1,110 @@
+// VoiceModulation - per-voice modulation sources routed to voice parameters
+// BraidsVST: GPL v3
+
+#include "voice_modulation.h"
+#include <algorithm>
+
+void VoiceModulation::Init()
+{
+    destinations_[0] = VoiceModDestination::Timbre;
+    destinations_[1] = VoiceModDestination::Color;
+    destinations_[2] = VoiceModDestination::Color;
+    destinations_[3] = VoiceModDestination::Timbre;
+    destinations_[4] = VoiceModDestination::Timbre;
+    destinations_[5] = VoiceModDestination::Color;
+
+    for (int i = 0; i < kNumSources; ++i) {
+        amounts_[i] = 0;
+        std::fill(sources_[i], sources_[i] + kMaxSlots, 0.0f);
+    }
+    std::fill(bend_, bend_ + kMaxSlots, 0.0f);
+    std::fill(pitch_, pitch_ + kMaxSlots, 0);
+    std::fill(timbre_, timbre_ + kMaxSlots, 0);
+    std::fill(color_, color_ + kMaxSlots, 0);
+    std::fill(cutoff_, cutoff_ + kMaxSlots, 0.0f);
+}
+
+void VoiceModulation::SetDestination(VoiceModSource source, VoiceModDestination dest)
+{
+    int idx = static_cast<int>(source);
+    if (idx >= 0 && idx < kNumSources) {
+        destinations_[idx] = dest;
+    }
+}
+
+void VoiceModulation::SetAmount(VoiceModSource source, int8_t amount)
+{
+    int idx = static_cast<int>(source);
+    if (idx >= 0 && idx < kNumSources) {
+        amounts_[idx] = std::clamp(amount, static_cast<int8_t>(-64), static_cast<int8_t>(63));
+    }
+}
+
+VoiceModDestination VoiceModulation::GetDestination(VoiceModSource source) const
+{
+    int idx = static_cast<int>(source);
+    if (idx >= 0 && idx < kNumSources) {
+        return destinations_[idx];
+    }
+    return VoiceModDestination::Timbre;
+}
+
+int8_t VoiceModulation::GetAmount(VoiceModSource source) const
+{
+    int idx = static_cast<int>(source);
+    if (idx >= 0 && idx < kNumSources) {
+        return amounts_[idx];
+    }
+    return 0;
+}
+
+bool VoiceModulation::modulates_cutoff() const
+{
+    for (int i = 0; i < kNumSources; ++i) {
+        if (destinations_[i] == VoiceModDestination::Cutoff && amounts_[i] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void VoiceModulation::Accumulate(VoiceModDestination dest, float base, size_t count,
+                                 float* out) const
+{
+    std::fill(out, out + count, base);
+    for (int s = 0; s < kNumSources; ++s) {
+        if (destinations_[s] != dest || amounts_[s] == 0) {
+            continue;
+        }
+        // Same scaling as ModulationMatrix: +63 is (almost) full range
+        const float amount = static_cast<float>(amounts_[s]) / 64.0f;
+        const float* source = sources_[s];
+        for (size_t i = 0; i < count; ++i) {
+            out[i] += source[i] * amount;
+        }
+    }
+}
+
+void VoiceModulation::Process(size_t count, float base_timbre, float base_color)
+{
+    count = std::min(count, kMaxSlots);
+
+    for (size_t i = 0; i < count; ++i) {
+        float offset = std::clamp(bend_[i] * 128.0f, -16384.0f, 16383.0f);
+        pitch_[i] = static_cast<int16_t>(offset);
+    }
+
+    Accumulate(VoiceModDestination::Timbre, base_timbre, count, scratch_);
+    for (size_t i = 0; i < count; ++i) {
+        float value = std::clamp(scratch_[i], 0.0f, 1.0f);
+        timbre_[i] = static_cast<int16_t>(value * 32767.0f + 0.5f);
+    }
+
+    Accumulate(VoiceModDestination::Color, base_color, count, scratch_);
+    for (size_t i = 0; i < count; ++i) {
+        float value = std::clamp(scratch_[i], 0.0f, 1.0f);
+        color_[i] = static_cast<int16_t>(value * 32767.0f + 0.5f);
+    }
+
+    Accumulate(VoiceModDestination::Cutoff, 0.0f, count, cutoff_);
+}
@@ -0,0 +1,89 @@
+// VoiceModulation - per-voice modulation sources routed to voice parameters
+// BraidsVST: GPL v3
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+enum class VoiceModDestination {
+    Timbre = 0,
+    Color,
+    Cutoff,
+    NumDestinations
+};
+
+enum class VoiceModSource {
+    Velocity = 0,
+    Envelope,       // Amplitude envelope level of the voice
+    Pressure,       // Channel pressure (per note under MPE)
+    Slide,          // CC74 (per note under MPE)
+    ModEnv1,        // The voice's own ENV1, in per-voice envelope mode
+    ModEnv2,        // The voice's own ENV2
+    NumSources
+};
+
+// Sources and results live in packed arrays indexed by slot (0..count-1),
+// not by pool index, so one Process() call runs each routing as a single
+// contiguous loop over all sounding voices.
+class VoiceModulation {
+public:
+    static constexpr size_t kMaxSlots = 128;
+
+    VoiceModulation() = default;
+    ~VoiceModulation() = default;
+
+    void Init();
+
+    // Routing: each source has one destination and amount, as in ModulationMatrix
+    void SetDestination(VoiceModSource source, VoiceModDestination dest);
+    void SetAmount(VoiceModSource source, int8_t amount);  // -64 to +63
+
+    VoiceModDestination GetDestination(VoiceModSource source) const;
+    int8_t GetAmount(VoiceModSource source) const;
+
+    // Source values for a slot, 0-1
+    void set_source(size_t slot, VoiceModSource source, float value) {
+        sources_[static_cast<int>(source)][slot] = value;
+    }
+
+    // Pitch bend for a slot in semitones (not routable, always applied)
+    void set_pitch_bend(size_t slot, float semitones) { bend_[slot] = semitones; }
+
+    // Compute every destination for slots [0, count). Timbre and colour are
+    // added to the given base values and clamped; cutoff is an offset
+    void Process(size_t count, float base_timbre, float base_color);
+
+    // Pitch offset in Braids pitch units (1/128 semitone)
+    int16_t pitch(size_t slot) const { return pitch_[slot]; }
+    int16_t timbre(size_t slot) const { return timbre_[slot]; }
+    int16_t color(size_t slot) const { return color_[slot]; }
+    float cutoff(size_t slot) const { return cutoff_[slot]; }
+
+    // True when a source is routed to cutoff with a non-zero amount
+    bool modulates_cutoff() const;
+
+private:
+    static constexpr int kNumSources = static_cast<int>(VoiceModSource::NumSources);
+
+    // Sum of the scaled sources routed to dest into out[0, count)
+    void Accumulate(VoiceModDestination dest, float base, size_t count, float* out) const;
+
+    VoiceModDestination destinations_[kNumSources] = {
+        VoiceModDestination::Timbre,  // Velocity default
+        VoiceModDestination::Color,   // Envelope default
+        VoiceModDestination::Color,   // Pressure default
+        VoiceModDestination::Timbre,  // Slide default
+        VoiceModDestination::Timbre,  // ENV1 default
+        VoiceModDestination::Color    // ENV2 default
+    };
+    int8_t amounts_[kNumSources] = {0, 0, 0, 0, 0, 0};  // All off by default
+
+    alignas(16) float sources_[kNumSources][kMaxSlots] = {};
+    alignas(16) float bend_[kMaxSlots] = {};
+    alignas(16) float scratch_[kMaxSlots] = {};
+    alignas(16) int16_t pitch_[kMaxSlots] = {};
+    alignas(16) int16_t timbre_[kMaxSlots] = {};
+    alignas(16) int16_t color_[kMaxSlots] = {};
+    alignas(16) float cutoff_[kMaxSlots] = {};
+};
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "dsp/braids/analog_oscillator.h"
+#include <algorithm>
+#include <cmath>
 
 TEST(AnalogOscillator, InitDoesNotCrash)
 {
@@ -108,3 +110,161 @@ TEST(AnalogOscillator, DifferentShapesProduceDifferentOutput)
     }
     EXPECT_TRUE(different);
 }
+
+TEST(AnalogOscillator, SawWrapIsBandLimited)
+{
+    braids::AnalogOscillator osc;
+    osc.Init();
+    osc.set_shape(braids::OSC_SHAPE_SAW);
+    osc.set_pitch(96 << 7);  // C7, a wrap every ~46 samples at 96kHz
+
+    int16_t buffer[256];
+    uint8_t sync[256] = {0};
+    osc.Render(sync, buffer, 256);
+
+    // A naive saw drops the full range in one sample; the BLEP spreads the
+    // step over the samples either side of the wrap
+    int max_step = 0;
+    int wraps = 0;
+    for (int i = 1; i < 256; ++i) {
+        int step = buffer[i - 1] - buffer[i];
+        max_step = std::max(max_step, step);
+        if (step > 8192) ++wraps;
+    }
+    EXPECT_GT(wraps, 0);
+    EXPECT_LT(max_step, 50000);
+}
+
+TEST(AnalogOscillator, BuzzHarmonicsStopBelowNyquist)
+{
+    // At note 127 (~12.5kHz) only three harmonics fit below 48kHz, so full
+    // density renders the same as asking for three
+    braids::AnalogOscillator dense, sparse;
+    uint8_t sync[64] = {0};
+    int16_t dense_buffer[64];
+    int16_t sparse_buffer[64];
+
+    dense.Init();
+    dense.set_shape(braids::OSC_SHAPE_BUZZ);
+    dense.set_pitch(127 << 7);
+    dense.set_parameter(32767);
+    dense.Render(sync, dense_buffer, 64);
+
+    sparse.Init();
+    sparse.set_shape(braids::OSC_SHAPE_BUZZ);
+    sparse.set_pitch(127 << 7);
+    sparse.set_parameter(1 << 11);
+    sparse.Render(sync, sparse_buffer, 64);
+
+    bool hasNonZero = false;
+    for (int i = 0; i < 64; ++i) {
+        EXPECT_EQ(dense_buffer[i], sparse_buffer[i]);
+        if (dense_buffer[i] != 0) hasNonZero = true;
+    }
+    EXPECT_TRUE(hasNonZero);
+}
+
+TEST(AnalogOscillator, BuzzMatchesHarmonicSum)
+{
+    braids::AnalogOscillator osc;
+    osc.Init();
+    osc.set_shape(braids::OSC_SHAPE_BUZZ);
+    osc.set_pitch(60 << 7);
+    osc.set_parameter(6 << 11);  // 8 harmonics
+
+    int16_t buffer[512];
+    uint8_t sync[512] = {0};
+    osc.Render(sync, buffer, 512);
+
+    // Middle C at 96kHz: compare against the harmonics summed one by one
+    // (loosely - the pitch table and sine interpolation are not exact)
+    const double r = 28000.0 / 32768.0;
+    const double increment = 2.0 * 3.14159265358979 * 261.6256 / 96000.0;
+    double peak = 0.0;
+    for (int h = 0; h < 8; ++h) peak += std::pow(r, h);
+    for (int i = 0; i < 512; ++i) {
+        double t = increment * (i + 1);
+        double sum = 0.0;
+        for (int h = 1; h <= 8; ++h) sum += std::pow(r, h - 1) * std::sin(h * t);
+        EXPECT_NEAR(buffer[i], 32767.0 * sum / peak, 1000.0);
+    }
+}
+
+TEST(AnalogOscillator, SyncOutMarksEachWrap)
+{
+    braids::AnalogOscillator osc;
+    osc.Init();
+    osc.set_shape(braids::OSC_SHAPE_SAW);
+    osc.set_pitch(84 << 7);  // ~1047 Hz, a wrap every ~92 samples
+
+    int16_t buffer[960];
+    uint8_t sync_in[960] = {0};
+    uint8_t sync_out[960];
+    std::fill(sync_out, sync_out + 960, static_cast<uint8_t>(0xff));
+    osc.Render(sync_in, buffer, sync_out, 960);
+
+    // Marks are where the saw drops: the output runs a sample late and the
+    // drop is spread over two samples
+    int wraps = 0;
+    for (int i = 0; i < 958; ++i) {
+        if (sync_out[i] != 0) {
+            EXPECT_LE(sync_out[i], 128);
+            EXPECT_LT(buffer[i + 2] - buffer[i], -32768) << i;
+            ++wraps;
+        }
+    }
+    EXPECT_EQ(wraps, 10);
+}
+
+TEST(AnalogOscillator, SyncAtTheSamePitchChangesNothing)
+{
+    // A slave at the master's pitch is reset where it would wrap anyway, so
+    // with sub-sample reset times its output is the free-running wave, but
+    // for the BLEPs moving by up to 1/128 of a sample. Resetting on whole
+    // samples would be out by up to a sample of ramp, 1400 at this pitch
+    for (auto shape : {braids::OSC_SHAPE_SAW, braids::OSC_SHAPE_SQUARE,
+                       braids::OSC_SHAPE_CSAW, braids::OSC_SHAPE_SINE}) {
+        braids::AnalogOscillator master, slave, free_running;
+        for (auto* osc : {&master, &slave, &free_running}) {
+            osc->Init();
+            osc->set_shape(shape);
+            osc->set_pitch(static_cast<int16_t>((96 << 7) + 37));
+        }
+        master.set_shape(braids::OSC_SHAPE_SAW);
+
+        int16_t master_out[1000], synced[1000], expected[1000];
+        uint8_t no_sync[1000] = {0};
+        uint8_t sync[1000];
+        master.Render(no_sync, master_out, sync, 1000);
+        slave.Render(sync, synced, 1000);
+        free_running.Render(no_sync, expected, 1000);
+        for (int i = 0; i < 1000; ++i) {
+            EXPECT_NEAR(synced[i], expected[i], 600) << "shape " << shape << " sample " << i;
+        }
+    }
+}
+
+TEST(AnalogOscillator, SyncedSawIsBandLimited)
+{
+    // The slave runs at 2.3 times the master, so each reset cuts it partway
+    // up its ramp; the cut is spread like a wrap instead of landing on one sample
+    braids::AnalogOscillator master, slave;
+    master.Init();
+    slave.Init();
+    master.set_shape(braids::OSC_SHAPE_SAW);
+    slave.set_shape(braids::OSC_SHAPE_SAW);
+    master.set_pitch(84 << 7);
+    slave.set_pitch(static_cast<int16_t>((84 << 7) + 1845));  // +14.4 semitones
+
+    int16_t master_out[960], buffer[960];
+    uint8_t no_sync[960] = {0};
+    uint8_t sync[960];
+    master.Render(no_sync, master_out, sync, 960);
+    slave.Render(sync, buffer, 960);
+
+    int max_step = 0;
+    for (int i = 1; i < 960; ++i) {
+        max_step = std::max(max_step, buffer[i - 1] - buffer[i]);
+    }
+    EXPECT_LT(max_step, 50000);
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "dsp/braids/macro_oscillator.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+// Wall-clock checks, built as their own target and registered with CTest
+// under the "benchmark" label for optimised configurations only: timings
+// in Debug or sanitizer builds mean nothing
+
+namespace {
+
+const int kFirstNewShape = braids::MACRO_OSC_SHAPE_TRIPLE_SAW;
+
+// Best of several runs of one second of audio at the 96 kHz internal rate,
+// rendered in internal blocks of 24 samples, in microseconds
+double ShapeCost(braids::MacroOscillatorShape shape)
+{
+    const int kBlockSize = 24;
+    const int kBlocks = 96000 / kBlockSize;
+    const int kRuns = 5;
+
+    braids::MacroOscillator osc;
+    int16_t buffer[kBlockSize];
+    uint8_t sync[kBlockSize] = {0};
+    double best = 1e12;
+    int64_t checksum = 0;
+    for (int run = 0; run < kRuns; ++run) {
+        osc.Init();
+        osc.set_shape(shape);
+        osc.set_pitch(60 << 7);
+        osc.set_parameters(16384, 16384);
+        auto start = std::chrono::steady_clock::now();
+        for (int block = 0; block < kBlocks; ++block) {
+            osc.Render(sync, buffer, kBlockSize);
+            checksum += buffer[0];
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, std::chrono::duration<double, std::micro>(elapsed).count());
+    }
+    // Keeps the renders from being optimised away
+    EXPECT_NE(checksum, INT64_MIN);
+    return best;
+}
+
+} // namespace
+
+TEST(DigitalOscillatorBenchmark, CostStaysWithinBudget)
+{
+    // Every shape's cost per second of audio at the internal rate, recorded
+    // as test properties. No shape added after FM4 may cost more than twice
+    // the most expensive of the original shapes
+    double budget = 0.0;
+    for (int shape = 0; shape < kFirstNewShape; ++shape) {
+        double cost = ShapeCost(static_cast<braids::MacroOscillatorShape>(shape));
+        RecordProperty("shape_" + std::to_string(shape) + "_us", static_cast<int>(cost));
+        budget = std::max(budget, cost);
+    }
+    for (int shape = kFirstNewShape; shape < braids::MACRO_OSC_SHAPE_LAST; ++shape) {
+        double cost = ShapeCost(static_cast<braids::MacroOscillatorShape>(shape));
+        RecordProperty("shape_" + std::to_string(shape) + "_us", static_cast<int>(cost));
+        EXPECT_LE(cost, 2.0 * budget) << "shape " << shape;
+    }
+}
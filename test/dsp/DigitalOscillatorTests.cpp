@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include "dsp/braids/digital_oscillator.h"
+#include "dsp/braids/macro_oscillator.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const int kFirstNewShape = braids::MACRO_OSC_SHAPE_TRIPLE_SAW;
+
+int16_t Peak(const int16_t* buffer, size_t size)
+{
+    int32_t peak = 0;
+    for (size_t i = 0; i < size; ++i) {
+        peak = std::max<int32_t>(peak, std::abs(static_cast<int32_t>(buffer[i])));
+    }
+    return static_cast<int16_t>(std::min<int32_t>(peak, 32767));
+}
+
+// Seconds until a struck shape falls to an eighth of its first peak,
+// rendering at the given rate. Levels are peaks over the last 20 ms, long
+// enough to span a period of the low note
+double DecayTime(braids::DigitalOscillatorShape shape, double sample_rate)
+{
+    braids::DigitalOscillator osc;
+    osc.set_increments(braids::OscillatorIncrements(sample_rate));
+    osc.set_sample_rate(static_cast<float>(sample_rate));
+    osc.Init();
+    osc.set_shape(shape);
+    osc.set_pitch(48 << 7);
+    osc.set_parameters(8192, 8192);
+
+    const int kSpan = 20;
+    size_t window = static_cast<size_t>(sample_rate / 1000.0);
+    int16_t buffer[96];
+    std::vector<int16_t> peaks;
+    int16_t first = 0;
+    for (int ms = 0; ms < 4000; ++ms) {
+        osc.Render(nullptr, buffer, window);
+        peaks.push_back(Peak(buffer, window));
+        int16_t level = *std::max_element(peaks.end() - std::min<int>(ms + 1, kSpan), peaks.end());
+        first = std::max(first, level);
+        if (ms >= kSpan && level < first / 8) {
+            return ms / 1000.0;
+        }
+    }
+    return 4.0;
+}
+
+} // namespace
+
+TEST(DigitalOscillator, EveryNewShapeProducesOutput)
+{
+    for (int shape = kFirstNewShape; shape < braids::MACRO_OSC_SHAPE_LAST; ++shape) {
+        for (int note : {36, 60, 96}) {
+            braids::MacroOscillator osc;
+            osc.Init();
+            osc.set_shape(static_cast<braids::MacroOscillatorShape>(shape));
+            osc.set_pitch(static_cast<int16_t>(note << 7));
+            osc.set_parameters(16384, 16384);
+
+            // 20 ms is enough for a grain or particle to come along
+            int16_t peak = 0;
+            for (int block = 0; block < 80; ++block) {
+                int16_t buffer[24];
+                uint8_t sync[24] = {0};
+                osc.Render(sync, buffer, 24);
+                peak = std::max(peak, Peak(buffer, 24));
+            }
+            EXPECT_GT(peak, 500) << "shape " << shape << " note " << note;
+        }
+    }
+}
+
+TEST(DigitalOscillator, ShapesSoundDifferent)
+{
+    int16_t previous[256] = {0};
+    for (int shape = kFirstNewShape; shape < braids::MACRO_OSC_SHAPE_LAST; ++shape) {
+        braids::MacroOscillator osc;
+        osc.Init();
+        osc.set_shape(static_cast<braids::MacroOscillatorShape>(shape));
+        osc.set_pitch(48 << 7);
+        osc.set_parameters(20000, 12000);
+
+        int16_t buffer[256];
+        uint8_t sync[256] = {0};
+        osc.Render(sync, buffer, 128);
+        osc.Render(sync, buffer + 128, 128);
+        EXPECT_FALSE(std::equal(buffer, buffer + 256, previous)) << "shape " << shape;
+        std::copy(buffer, buffer + 256, previous);
+    }
+}
+
+TEST(DigitalOscillator, TripleIntervalsFollowTimbreAndColor)
+{
+    // In the middle both intervals are unison: three saws in phase are one saw
+    auto render = [](int16_t timbre, int16_t color, int16_t* buffer) {
+        braids::MacroOscillator osc;
+        osc.Init();
+        osc.set_shape(braids::MACRO_OSC_SHAPE_TRIPLE_SAW);
+        osc.set_pitch(60 << 7);
+        osc.set_parameters(timbre, color);
+        uint8_t sync[128] = {0};
+        osc.Render(sync, buffer, 128);
+    };
+
+    int16_t unison[128], chord[128];
+    render(16384, 16384, unison);
+    render(24000, 28000, chord);
+    EXPECT_FALSE(std::equal(unison, unison + 128, chord));
+
+    braids::AnalogOscillator saw;
+    saw.Init();
+    saw.set_shape(braids::OSC_SHAPE_SAW);
+    saw.set_pitch(60 << 7);
+    int16_t single[128];
+    uint8_t sync[128] = {0};
+    saw.Render(sync, single, 128);
+    for (int i = 0; i < 128; ++i) {
+        EXPECT_NEAR(unison[i], single[i], 2);
+    }
+}
+
+TEST(DigitalOscillator, PercussionDecaysAndRestrikesOnInit)
+{
+    for (auto shape : {braids::OSC_SHAPE_PLUCKED, braids::OSC_SHAPE_STRUCK_BELL,
+                       braids::OSC_SHAPE_STRUCK_DRUM, braids::OSC_SHAPE_KICK,
+                       braids::OSC_SHAPE_SNARE}) {
+        braids::DigitalOscillator osc;
+        osc.Init();
+        osc.set_shape(shape);
+        osc.set_pitch(48 << 7);
+        osc.set_parameters(8192, 8192);
+
+        int16_t buffer[4800];
+        osc.Render(nullptr, buffer, 4800);
+        int16_t attack = Peak(buffer, 2400);
+        for (int i = 0; i < 20; ++i) {
+            osc.Render(nullptr, buffer, 4800);
+        }
+        int16_t tail = Peak(buffer, 4800);
+        EXPECT_LT(tail, attack / 4) << "shape " << shape;
+
+        osc.Init();
+        osc.set_shape(shape);
+        osc.set_pitch(48 << 7);
+        osc.set_parameters(8192, 8192);
+        osc.Render(nullptr, buffer, 4800);
+        EXPECT_GT(Peak(buffer, 2400), attack / 2) << "shape " << shape;
+    }
+}
+
+TEST(DigitalOscillator, DecaysLastAsLongAtHalfTheRate)
+{
+    for (auto shape : {braids::OSC_SHAPE_STRUCK_BELL, braids::OSC_SHAPE_STRUCK_DRUM,
+                       braids::OSC_SHAPE_KICK, braids::OSC_SHAPE_SNARE}) {
+        double full = DecayTime(shape, 96000.0);
+        double half = DecayTime(shape, 48000.0);
+        EXPECT_GT(full, 0.01) << "shape " << shape;
+        EXPECT_NEAR(half, full, full * 0.1) << "shape " << shape;
+    }
+}
+
+TEST(DigitalOscillator, NoStrikeLeavesAnEmptyString)
+{
+    // Without a fresh Init the string keeps ringing down, not re-plucked
+    braids::DigitalOscillator osc;
+    osc.Init();
+    osc.set_shape(braids::OSC_SHAPE_PLUCKED);
+    osc.set_pitch(60 << 7);
+    osc.set_parameters(16384, 0);
+
+    int16_t buffer[9600];
+    for (int i = 0; i < 20; ++i) {
+        osc.Render(nullptr, buffer, 9600);
+    }
+    EXPECT_LT(Peak(buffer, 9600), 500);
+}
+
+TEST(DigitalOscillator, WaveguidesKeepSounding)
+{
+    // Bowed, blown and fluted have no decay: once started they sustain
+    for (auto shape : {braids::OSC_SHAPE_BOWED, braids::OSC_SHAPE_BLOWN,
+                       braids::OSC_SHAPE_FLUTED}) {
+        for (int note : {48, 60, 84}) {
+            braids::DigitalOscillator osc;
+            osc.Init();
+            osc.set_shape(shape);
+            osc.set_pitch(static_cast<int16_t>(note << 7));
+            osc.set_parameters(16384, 16384);
+
+            int16_t buffer[9600];
+            for (int i = 0; i < 10; ++i) {
+                osc.Render(nullptr, buffer, 9600);
+            }
+            EXPECT_GT(Peak(buffer, 9600), 4000) << "shape " << shape << " note " << note;
+        }
+    }
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "dsp/braids/fm_oscillator.h"
+#include <algorithm>
+#include <cmath>
 
 TEST(FmOscillator, InitDoesNotCrash)
 {
@@ -43,3 +45,78 @@ TEST(FmOscillator, OutputIsInRange)
         EXPECT_LE(buffer[i], 32767);
     }
 }
+
+TEST(FmOscillator, RatioSnapsToPlateaus)
+{
+    // Nearby ratio settings inside one plateau render identically
+    braids::FmOscillator a, b;
+    a.Init();
+    b.Init();
+    a.set_pitch(60 << 7);
+    b.set_pitch(60 << 7);
+    int32_t plateau = 0;
+    while (braids::lut_fm_frequency_quantizer[plateau] != 0) ++plateau;  // Ratio 1
+    a.set_parameters(8192, static_cast<int16_t>(plateau << 8));
+    b.set_parameters(8192, static_cast<int16_t>((plateau << 8) + 200));
+
+    int16_t buffer_a[256], buffer_b[256];
+    a.Render(buffer_a, 256);
+    b.Render(buffer_b, 256);
+    for (int i = 0; i < 256; ++i) {
+        EXPECT_EQ(buffer_a[i], buffer_b[i]);
+    }
+}
+
+TEST(FmOscillator, RatioQuantizerRisesThroughUnison)
+{
+    EXPECT_EQ(braids::LUT_FM_FREQUENCY_QUANTIZER_SIZE, 129u);
+    EXPECT_EQ(braids::lut_fm_frequency_quantizer[0], -(12 << 7));  // Ratio 1/2
+    for (size_t i = 1; i < braids::LUT_FM_FREQUENCY_QUANTIZER_SIZE; ++i) {
+        EXPECT_GE(braids::lut_fm_frequency_quantizer[i], braids::lut_fm_frequency_quantizer[i - 1]);
+    }
+    EXPECT_EQ(braids::lut_fm_frequency_quantizer[128], 36 << 7);  // Ratio 8
+}
+
+namespace {
+
+// Largest distance, unison ratio and full index, from plain phase
+// modulation by a sine. Feedback bends the modulator away from the sine
+double DistanceFromPlainPm(int16_t feedback)
+{
+    braids::FmOscillator osc;
+    osc.Init();
+    osc.set_feedback(feedback);
+    osc.set_pitch(48 << 7);
+    int32_t plateau = 0;
+    while (braids::lut_fm_frequency_quantizer[plateau] != 0) ++plateau;
+    osc.set_parameters(32767, static_cast<int16_t>(plateau << 8));
+
+    int16_t warmup[256], buffer[256];
+    osc.Render(warmup, 256);  // Index ramps up from 0 over the first block
+    osc.Render(buffer, 256);
+
+    // Both phases have advanced by the same increment since Init
+    const double pi = 3.14159265358979;
+    const double increment = 2.0 * pi * 130.8128 / 96000.0;
+    double max_error = 0.0;
+    for (int i = 0; i < 256; ++i) {
+        double t = increment * (256 + i + 1);
+        double modulator = std::sin(t);
+        double plain = std::sin(t + 2.0 * pi * modulator * 32767.0 * 32767.0 * 4.0 / 4294967296.0);
+        max_error = std::max(max_error, std::abs(buffer[i] - 32767.0 * plain));
+    }
+    return max_error;
+}
+
+} // namespace
+
+TEST(FmOscillator, ModulatorFeedsBackOnItself)
+{
+    EXPECT_GT(DistanceFromPlainPm(32767), 4000.0);
+}
+
+TEST(FmOscillator, FeedbackIsOffByDefault)
+{
+    // Older patches keep the plain two-operator sound
+    EXPECT_LT(DistanceFromPlainPm(0), 1000.0);
+}
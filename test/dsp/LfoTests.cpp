@@ -4,6 +4,7 @@
 #include <gtest/gtest.h>
 #include "dsp/lfo.h"
 #include <cmath>
+#include <vector>
 
 using namespace braids;
 
@@ -174,3 +175,188 @@ TEST_F(LfoTest, ShapeNamesExist) {
         EXPECT_STRNE(name, "???");
     }
 }
+
+TEST_F(LfoTest, ProcessBlockMatchesProcessPerSample) {
+    for (LfoShape shape : {LfoShape::Triangle, LfoShape::Saw, LfoShape::Square}) {
+        Lfo reference;
+        reference.Init();
+        reference.SetShape(shape);
+        reference.SetRate(LfoRateDivision::Div_1_16T);
+        reference.SetTempo(180.0);
+        lfo_.Init();
+        lfo_.SetShape(shape);
+        lfo_.SetRate(LfoRateDivision::Div_1_16T);
+        lfo_.SetTempo(180.0);
+
+        float block[100];
+        for (int b = 0; b < 40; ++b) {
+            lfo_.ProcessBlock(kSampleRate, block, 100);
+            for (int i = 0; i < 100; ++i) {
+                float expected = reference.Process(kSampleRate);
+                // Square edges can land either side of a rounding error
+                if (shape != LfoShape::Square || std::abs(expected - block[i]) < 1.0f) {
+                    EXPECT_NEAR(block[i], expected, 1e-3f) << static_cast<int>(shape) << " " << i;
+                }
+            }
+        }
+        EXPECT_FLOAT_EQ(lfo_.GetOutput(), block[99]);
+    }
+}
+
+TEST_F(LfoTest, ProcessBlockSampleAndHoldChangesOncePerCycle) {
+    lfo_.SetShape(LfoShape::SampleAndHold);
+    lfo_.SetRate(LfoRateDivision::Div_1_16);  // 6000 samples at 120 BPM
+
+    float block[600];
+    int changes = 0;
+    float last = lfo_.GetOutput();
+    for (int b = 0; b < 100; ++b) {
+        lfo_.ProcessBlock(kSampleRate, block, 600);
+        for (float value : block) {
+            changes += value != last;
+            last = value;
+        }
+    }
+    EXPECT_NEAR(changes, 10, 1);
+}
+
+TEST_F(LfoTest, RateModulationScalesTheRate) {
+    // Count saw wraps over four seconds: 1/4 at 120 BPM is 2 Hz
+    auto cycles = [this](float modulation) {
+        lfo_.Init();
+        lfo_.SetShape(LfoShape::Saw);
+        lfo_.SetRateModulation(modulation);
+        int wraps = 0;
+        float last = lfo_.Process(kSampleRate, 64);
+        for (int i = 0; i < 3000; ++i) {
+            float value = lfo_.Process(kSampleRate, 64);
+            wraps += value > last;
+            last = value;
+        }
+        return wraps;
+    };
+    EXPECT_NEAR(cycles(0.0f), 8, 1);
+    EXPECT_NEAR(cycles(0.5f), 16, 1);   // One octave up
+    EXPECT_NEAR(cycles(1.0f), 32, 1);   // Two
+    EXPECT_NEAR(cycles(-0.5f), 4, 1);
+}
+
+TEST_F(LfoTest, SyncToBeatFollowsTheSongPosition) {
+    lfo_.SetShape(LfoShape::Saw);
+    lfo_.SetRate(LfoRateDivision::Div_1_2);  // Two beats per cycle
+
+    // Half way through a cycle, whatever the LFO did before
+    lfo_.Process(kSampleRate, 12345);
+    lfo_.SyncToBeat(33.0);
+    EXPECT_NEAR(lfo_.Process(kSampleRate, 0), 0.0f, 1e-4f);
+
+    // A block at 120 BPM from beat 1 lands where syncing to its end would
+    float block[6000];  // Half a beat
+    lfo_.SyncToBeat(1.0);
+    lfo_.ProcessBlock(kSampleRate, block, 6000);
+    Lfo reference;
+    reference.Init();
+    reference.SetShape(LfoShape::Saw);
+    reference.SetRate(LfoRateDivision::Div_1_2);
+    reference.SyncToBeat(1.25);
+    EXPECT_NEAR(block[5999], reference.Process(kSampleRate, 0), 1e-3f);
+}
+
+TEST_F(LfoTest, SyncToBeatLeavesAModulatedRateAlone) {
+    lfo_.SetShape(LfoShape::Saw);
+    lfo_.SetRateModulation(0.5f);
+    float before = lfo_.Process(kSampleRate, 1000);
+    lfo_.SyncToBeat(0.5);
+    EXPECT_FLOAT_EQ(lfo_.Process(kSampleRate, 0), before);
+}
+
+TEST_F(LfoTest, SampleAndHoldIsReproducibleFromItsSeed) {
+    auto render = [](uint32_t seed) {
+        Lfo lfo;
+        lfo.Init();
+        lfo.Seed(seed);
+        lfo.SetShape(LfoShape::SampleAndHold);
+        lfo.SetRate(LfoRateDivision::Div_1_16);
+        std::vector<float> values;
+        for (int i = 0; i < 50; ++i) {
+            values.push_back(lfo.Process(kSampleRate, 3000));
+        }
+        return values;
+    };
+    EXPECT_EQ(render(1), render(1));
+    EXPECT_NE(render(1), render(2));
+}
+
+TEST_F(LfoTest, TableShapesFollowTheirCurves) {
+    float block[6000];  // One cycle of 1/16 at 120 BPM
+    lfo_.SetRate(LfoRateDivision::Div_1_16);
+
+    lfo_.SetShape(LfoShape::Sine);
+    lfo_.ProcessBlock(kSampleRate, block, 6000);
+    for (int i = 0; i < 6000; i += 7) {
+        EXPECT_NEAR(block[i], std::sin(2.0 * 3.14159265358979 * (i + 1) / 6000.0), 1e-3) << i;
+    }
+
+    lfo_.Reset();
+    lfo_.SetShape(LfoShape::Exponential);
+    lfo_.ProcessBlock(kSampleRate, block, 6000);
+    EXPECT_GT(block[0], 0.99f);
+    EXPECT_LT(block[5998], -0.99f);
+    EXPECT_LT(block[1500], 0.0f);  // Most of the fall is early
+    for (int i = 1; i < 5999; ++i) {
+        EXPECT_LE(block[i], block[i - 1]) << i;
+    }
+}
+
+TEST_F(LfoTest, UserShapeJoinsItsPoints) {
+    const float points[] = {0.0f, 1.0f, 0.0f, -1.0f};  // A triangle
+    lfo_.SetUserShape(points, 4);
+    lfo_.SetShape(LfoShape::User);
+    lfo_.SetRate(LfoRateDivision::Div_1_16);
+
+    Lfo triangle;
+    triangle.Init();
+    triangle.SetRate(LfoRateDivision::Div_1_16);
+    float user[600], reference[600];
+    for (int b = 0; b < 10; ++b) {
+        lfo_.ProcessBlock(kSampleRate, user, 600);
+        triangle.ProcessBlock(kSampleRate, reference, 600);
+        for (int i = 0; i < 600; ++i) {
+            EXPECT_NEAR(user[i], reference[i], 1e-3f);
+        }
+    }
+}
+
+TEST_F(LfoTest, SmoothRandomGlidesBetweenValues) {
+    lfo_.SetShape(LfoShape::SmoothRandom);
+    lfo_.SetRate(LfoRateDivision::Div_1_16);
+
+    float block[500];
+    float last = lfo_.Process(kSampleRate, 0);
+    float lowest = 1.0f, highest = -1.0f;
+    for (int b = 0; b < 200; ++b) {
+        lfo_.ProcessBlock(kSampleRate, block, 500);
+        for (float value : block) {
+            // No jumps: the steepest glide covers 2 in half a cycle
+            EXPECT_LT(std::abs(value - last), 2.0f * 3.15f / 6000.0f);
+            lowest = std::min(lowest, value);
+            highest = std::max(highest, value);
+            last = value;
+        }
+    }
+    EXPECT_LT(lowest, -0.3f);
+    EXPECT_GT(highest, 0.3f);
+}
+
+TEST_F(LfoTest, FreeRatesIgnoreTempoAndTransport) {
+    for (double bpm : {60.0, 174.0}) {
+        lfo_.Init();
+        lfo_.SetShape(LfoShape::Saw);
+        lfo_.SetRate(LfoRateDivision::Hz_2);
+        lfo_.SetTempo(bpm);
+        lfo_.SyncToBeat(0.37);  // Ignored
+        EXPECT_NEAR(lfo_.Process(kSampleRate, 6000), 0.5f, 1e-4f);  // A quarter cycle
+    }
+    EXPECT_STREQ(Lfo::GetRateName(LfoRateDivision::Hz_2), "2Hz");
+    EXPECT_STREQ(Lfo::GetShapeName(LfoShape::User), "USER");
+}
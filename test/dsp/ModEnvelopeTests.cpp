@@ -149,3 +149,142 @@ TEST_F(ModEnvelopeTest, RetriggerDuringAttack) {
     env_.Trigger();
     EXPECT_TRUE(env_.IsActive());
 }
+
+TEST_F(ModEnvelopeTest, DecayCurvesRunFromOneToZero) {
+    for (int c = 0; c < static_cast<int>(ModEnvelopeCurve::NumCurves); ++c) {
+        auto curve = static_cast<ModEnvelopeCurve>(c);
+        EXPECT_NEAR(ModEnvelope::DecayLevel(curve, 0.0f), 1.0f, 1e-6f);
+        EXPECT_NEAR(ModEnvelope::DecayLevel(curve, 1.0f), 0.0f, 1e-6f);
+        float last = 1.0f;
+        for (int i = 1; i <= 100; ++i) {
+            float level = ModEnvelope::DecayLevel(curve, i / 100.0f);
+            EXPECT_LE(level, last);
+            last = level;
+        }
+    }
+}
+
+TEST_F(ModEnvelopeTest, DecayCurvesHaveTheirShape) {
+    const float e4 = std::exp(-4.0f);
+    float exponential = (std::exp(-4.0f * 0.25f) - e4) / (1.0f - e4);
+    EXPECT_NEAR(ModEnvelope::DecayLevel(ModEnvelopeCurve::Exponential, 0.25f), exponential, 1e-4f);
+    EXPECT_NEAR(ModEnvelope::DecayLevel(ModEnvelopeCurve::Linear, 0.25f), 0.75f, 1e-6f);
+    EXPECT_NEAR(ModEnvelope::DecayLevel(ModEnvelopeCurve::Logarithmic, 0.75f), 1.0f - exponential, 1e-4f);
+}
+
+TEST_F(ModEnvelopeTest, DecayFollowsTheSelectedCurve) {
+    for (int c = 0; c < static_cast<int>(ModEnvelopeCurve::NumCurves); ++c) {
+        auto curve = static_cast<ModEnvelopeCurve>(c);
+        env_.Init();
+        env_.SetCurve(curve);
+        env_.SetAttack(0);
+        env_.SetDecay(100);  // 4800 samples
+        env_.Trigger();
+        env_.Process(kSampleRate, 32);  // Attack done in one tick
+        env_.Process(kSampleRate, 1200);
+        EXPECT_NEAR(env_.GetOutput(), ModEnvelope::DecayLevel(curve, 0.25f), 1e-4f);
+    }
+}
+
+TEST_F(ModEnvelopeTest, TimeChangesApplyMidStage) {
+    env_.SetAttack(100);  // 4800 samples
+    env_.Trigger();
+    env_.Process(kSampleRate, 1200);
+    EXPECT_NEAR(env_.GetOutput(), 0.25f, 1e-4f);
+
+    env_.SetAttack(50);  // Now twice as fast
+    env_.Process(kSampleRate, 1200);
+    EXPECT_NEAR(env_.GetOutput(), 0.75f, 1e-4f);
+}
+
+TEST_F(ModEnvelopeTest, RetriggerMidDecayRisesFromTheCurrentLevel) {
+    env_.SetAttack(20);
+    env_.SetDecay(200);
+    env_.Trigger();
+    for (int i = 0; i < 100; ++i) {
+        env_.Process(kSampleRate, 32);  // Into the decay
+    }
+    float level = env_.GetOutput();
+    ASSERT_GT(level, 0.2f);
+    ASSERT_LT(level, 0.9f);
+
+    env_.Trigger();
+    float last = level;
+    for (int i = 0; i < 10; ++i) {
+        env_.Process(kSampleRate, 32);
+        EXPECT_GE(env_.GetOutput(), last) << "tick " << i;
+        last = env_.GetOutput();
+    }
+}
+
+TEST(ModEnvelopeBankTest, RetriggerMidDecayRisesFromTheCurrentLevel) {
+    ModEnvelopeBank bank;
+    bank.Init();
+    bank.SetAttack(20);
+    bank.SetDecay(200);
+    const uint16_t indices[] = {4};
+    bank.Trigger(4);
+    for (int i = 0; i < 100; ++i) {
+        bank.Process(indices, 1, 48000.0f, 32);
+    }
+    float level = bank.output(4);
+    ASSERT_GT(level, 0.2f);
+
+    bank.Trigger(4);
+    bank.Process(indices, 1, 48000.0f, 32);
+    EXPECT_GE(bank.output(4), level);
+}
+
+TEST(ModEnvelopeBankTest, EachEnvelopeMatchesAModEnvelope) {
+    for (int c = 0; c < static_cast<int>(ModEnvelopeCurve::NumCurves); ++c) {
+        ModEnvelope reference;
+        reference.Init();
+        reference.SetAttack(20);
+        reference.SetDecay(300);
+        reference.SetCurve(static_cast<ModEnvelopeCurve>(c));
+        reference.Trigger();
+
+        ModEnvelopeBank bank;
+        bank.Init();
+        bank.SetAttack(20);
+        bank.SetDecay(300);
+        bank.SetCurve(static_cast<ModEnvelopeCurve>(c));
+        bank.Trigger(5);
+        const uint16_t indices[] = {5};
+
+        for (int i = 0; i < 500; ++i) {
+            reference.Process(48000.0f, 32);
+            bank.Process(indices, 1, 48000.0f, 32);
+            ASSERT_FLOAT_EQ(bank.output(5), reference.GetOutput()) << "curve " << c << " tick " << i;
+        }
+    }
+}
+
+TEST(ModEnvelopeBankTest, EnvelopesRunIndependently) {
+    ModEnvelopeBank bank;
+    bank.Init();
+    bank.SetAttack(0);
+    bank.SetDecay(100);
+    const uint16_t indices[] = {0, 3, 7};
+
+    bank.Trigger(0);
+    for (int i = 0; i < 50; ++i) {
+        bank.Process(indices, 3, 48000.0f, 32);
+    }
+    bank.Trigger(3);
+    bank.Process(indices, 3, 48000.0f, 32);
+
+    EXPECT_GT(bank.output(0), 0.0f);
+    EXPECT_GT(bank.output(3), bank.output(0));
+    EXPECT_FLOAT_EQ(bank.output(7), 0.0f);  // Never triggered
+}
+
+TEST(ModEnvelopeBankTest, UnlistedEnvelopesDoNotAdvance) {
+    ModEnvelopeBank bank;
+    bank.Init();
+    bank.SetAttack(10);
+    bank.Trigger(2);
+    const uint16_t indices[] = {1};
+    bank.Process(indices, 1, 48000.0f, 32);
+    EXPECT_FLOAT_EQ(bank.output(2), 0.0f);
+}
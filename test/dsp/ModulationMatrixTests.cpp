@@ -4,6 +4,7 @@
 #include <gtest/gtest.h>
 #include "dsp/modulation_matrix.h"
 #include <cmath>
+#include <algorithm>
 
 using namespace braids;
 
@@ -180,3 +181,95 @@ TEST_F(ModulationMatrixTest, MultipleSourcesSameDestination) {
     EXPECT_GE(mod, -1.0f);
     EXPECT_LE(mod, 1.0f);
 }
+
+TEST_F(ModulationMatrixTest, OneSourceCanReachSeveralDestinations) {
+    matrix_.SetSlot(0, ModSource::Env1, ModDestination::Timbre, 63);
+    matrix_.SetSlot(1, ModSource::Env1, ModDestination::Cutoff, -32);
+    matrix_.GetEnv1().SetAttack(0);
+    matrix_.GetEnv1().SetDecay(2000);
+    matrix_.TriggerEnvelopes();
+    matrix_.Process(kSampleRate, 64);
+
+    float env = matrix_.GetEnv1().GetOutput();
+    EXPECT_GT(env, 0.5f);
+    EXPECT_NEAR(matrix_.GetModulation(ModDestination::Timbre), env * 63.0f / 64.0f, 1e-5f);
+    EXPECT_NEAR(matrix_.GetModulation(ModDestination::Cutoff), -env * 0.5f, 1e-5f);
+}
+
+TEST_F(ModulationMatrixTest, OnlySlotsWithAnAmountAreEvaluated) {
+    matrix_.Process(kSampleRate, 64);
+    EXPECT_EQ(matrix_.GetNumActiveSlots(), 0u);
+
+    matrix_.SetAmount(ModSource::Lfo2, 10);
+    matrix_.SetSlot(3, ModSource::Env2, ModDestination::Resonance, 20);
+    matrix_.Process(kSampleRate, 64);
+    EXPECT_EQ(matrix_.GetNumActiveSlots(), 2u);
+
+    matrix_.SetSlot(3, ModSource::Env2, ModDestination::Resonance, 0);
+    matrix_.Process(kSampleRate, 64);
+    EXPECT_EQ(matrix_.GetNumActiveSlots(), 1u);
+}
+
+TEST_F(ModulationMatrixTest, AmountModulationRunsBeforeTheLfoItScales) {
+    // The envelope slot comes after the LFO slot it modulates but still
+    // has to be applied first
+    matrix_.SetSlot(0, ModSource::Lfo1, ModDestination::Color, 32);
+    matrix_.SetSlot(2, ModSource::Env1, ModDestination::Lfo1Amount, 63);
+    matrix_.GetEnv1().SetAttack(0);
+    matrix_.GetEnv1().SetDecay(2000);
+    matrix_.GetLfo1().SetRate(LfoRateDivision::Div_1_16);
+    matrix_.TriggerEnvelopes();
+
+    for (int i = 0; i < 20; ++i) {
+        matrix_.Process(kSampleRate, 64);
+        float env = matrix_.GetSourceOutput(ModSource::Env1);
+        float lfo = matrix_.GetSourceOutput(ModSource::Lfo1);
+        float amount = 0.5f + env * (63.0f / 64.0f) * 0.5f;
+        EXPECT_NEAR(matrix_.GetModulation(ModDestination::Color), lfo * amount, 1e-5f);
+    }
+}
+
+TEST_F(ModulationMatrixTest, EnvelopeToLfoRateChangesItsSpeed) {
+    auto cycles = [this](int8_t amount) {
+        matrix_.Init();
+        matrix_.GetLfo1().SetShape(LfoShape::Saw);
+        matrix_.SetSlot(2, ModSource::Env1, ModDestination::Lfo1Rate, amount);
+        matrix_.GetEnv1().SetAttack(0);
+        matrix_.GetEnv1().SetDecay(60000);  // Close to flat over the test
+        matrix_.TriggerEnvelopes();
+        int wraps = 0;
+        float last = 1.0f;
+        for (int i = 0; i < 1500; ++i) {  // Two seconds
+            matrix_.Process(kSampleRate, 64);
+            float value = matrix_.GetLfo1().GetOutput();
+            wraps += value > last;
+            last = value;
+        }
+        return wraps;
+    };
+    int unmodulated = cycles(0);
+    EXPECT_NEAR(unmodulated, 4, 1);
+    EXPECT_GT(cycles(63), unmodulated * 2);
+    EXPECT_LT(cycles(-64), unmodulated / 2);
+    EXPECT_EQ(matrix_.GetNumActiveSlots(), 1u);
+}
+
+TEST_F(ModulationMatrixTest, EnvelopeCanBringInAnLfoAtZeroAmount) {
+    // Delayed vibrato: the LFO's own amount is 0 and ENV1 opens it up
+    matrix_.SetDestination(ModSource::Lfo1, ModDestination::Timbre);
+    matrix_.SetAmount(ModSource::Lfo1, 0);
+    matrix_.SetDestination(ModSource::Env1, ModDestination::Lfo1Amount);
+    matrix_.SetAmount(ModSource::Env1, 63);
+    matrix_.GetEnv1().SetAttack(0);
+    matrix_.GetEnv1().SetDecay(2000);
+    matrix_.GetLfo1().SetRate(LfoRateDivision::Div_1_16);
+    matrix_.TriggerEnvelopes();
+
+    float largest = 0.0f;
+    for (int i = 0; i < 50; ++i) {
+        matrix_.Process(kSampleRate, 64);
+        largest = std::max(largest, std::fabs(matrix_.GetModulation(ModDestination::Timbre)));
+    }
+    EXPECT_GT(largest, 0.1f);
+    EXPECT_EQ(matrix_.GetNumActiveSlots(), 2u);
+}
@@ -87,3 +87,34 @@ TEST(Resampler, HandlesNon2xRatio)
     EXPECT_GE(outputWritten, 40u);
     EXPECT_LE(outputWritten, 48u);
 }
+
+TEST(Resampler, SplitInputMatchesSingleBlock)
+{
+    // Feeding the same stream in odd-sized pieces must not drop samples
+    Resampler whole, split;
+    whole.Init(96000.0, 44100.0);
+    split.Init(96000.0, 44100.0);
+
+    int16_t input[240];
+    for (int i = 0; i < 240; ++i) {
+        input[i] = static_cast<int16_t>(16384.0 * sin(2.0 * M_PI * i / 37.0));
+    }
+
+    float expected[128];
+    size_t expectedCount = whole.Process(input, 240, expected, 128);
+
+    float output[128];
+    size_t written = 0;
+    size_t read = 0;
+    while (read < 240) {
+        size_t chunk = std::min<size_t>(5, 240 - read);
+        size_t consumed = 0;
+        written += split.Process(input + read, chunk, output + written, 3, &consumed);
+        read += consumed;
+    }
+
+    ASSERT_EQ(written, expectedCount);
+    for (size_t i = 0; i < written; ++i) {
+        EXPECT_FLOAT_EQ(output[i], expected[i]);
+    }
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "dsp/spsc_queue.h"
+#include <thread>
+
+TEST(SpscQueue, StartsEmpty)
+{
+    SpscQueue<int, 8> queue;
+    int value = -1;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.Pop(value));
+    EXPECT_EQ(value, -1);
+}
+
+TEST(SpscQueue, PopsInPushOrder)
+{
+    SpscQueue<int, 8> queue;
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(queue.Push(i));
+    }
+    EXPECT_EQ(queue.size(), 5u);
+
+    int value = -1;
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(queue.Pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueue, PushFailsWhenFull)
+{
+    SpscQueue<int, 4> queue;
+    EXPECT_TRUE(queue.Push(1));
+    EXPECT_TRUE(queue.Push(2));
+    EXPECT_TRUE(queue.Push(3));
+    EXPECT_FALSE(queue.Push(4));  // One slot stays free
+
+    int value = 0;
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(queue.Push(4));
+}
+
+TEST(SpscQueue, WrapsAroundTheBuffer)
+{
+    SpscQueue<int, 4> queue;
+    int value = 0;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(queue.Push(i));
+        ASSERT_TRUE(queue.Push(i + 1000));
+        ASSERT_TRUE(queue.Pop(value));
+        EXPECT_EQ(value, i);
+        ASSERT_TRUE(queue.Pop(value));
+        EXPECT_EQ(value, i + 1000);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueue, HandsValuesAcrossThreadsInOrder)
+{
+    struct Item { int sequence; int check; };
+    SpscQueue<Item, 64> queue;
+    constexpr int kCount = 100000;
+
+    std::thread producer([&queue] {
+        for (int i = 0; i < kCount; ) {
+            if (queue.Push({i, -i})) {
+                ++i;
+            }
+        }
+    });
+
+    // Checked after the join, so a failure can't leave the producer running
+    int expected = 0;
+    bool inOrder = true;
+    Item item{};
+    while (expected < kCount) {
+        if (queue.Pop(item)) {
+            inOrder = inOrder && item.sequence == expected && item.check == -expected;
+            ++expected;
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(inOrder);
+    EXPECT_TRUE(queue.empty());
+}
@@ -2,7 +2,10 @@
 #include "dsp/stmlib/stmlib.h"
 #include "dsp/stmlib/dsp.h"
 #include "dsp/stmlib/random.h"
+#include "dsp/stmlib/cpu.h"
 #include "dsp/braids/resources.h"
+#include <algorithm>
+#include <cmath>
 
 TEST(Stmlib, ClipPositive)
 {
@@ -36,6 +39,107 @@ TEST(Stmlib, Interpolate824_Midpoint)
     EXPECT_NEAR(result, 128, 2); // Halfway between 0 and 256
 }
 
+TEST(Stmlib, Interpolate824_FullRangeStep)
+{
+    // (b - a) * frac is past int32 here: 65535 * 0xc000
+    static const int16_t table[257] = {-32768, 32767};
+    EXPECT_EQ(stmlib::Interpolate824(table, 0x00c00000), 16383);
+}
+
+namespace {
+
+// Compares a block kernel against per-sample Interpolate824 on random phases,
+// with an odd size so the scalar tail is covered too
+void ExpectInterpolate824BlockExact(void (*kernel)(const int16_t*, const uint32_t*, int16_t*, size_t),
+                                    const int16_t* table)
+{
+    uint32_t phases[203];
+    int16_t out[203];
+    stmlib::Random random;
+    random.Seed(0x1234);
+    for (uint32_t& phase : phases) {
+        phase = random.GetWord();
+    }
+    phases[0] = 0;
+    phases[1] = 0xffffffff;
+
+    kernel(table, phases, out, 203);
+    for (int i = 0; i < 203; ++i) {
+        EXPECT_EQ(out[i], stmlib::Interpolate824(table, phases[i])) << "at " << i;
+    }
+}
+
+} // namespace
+
+TEST(Stmlib, Interpolate824BlockMatchesScalar)
+{
+    // Full-range random table: large jumps between neighbours
+    int16_t noise[257];
+    stmlib::Random random;
+    random.Seed(42);
+    for (int16_t& value : noise) {
+        value = random.GetSample();
+    }
+    // Largest steps there are, where (b - a) * frac takes 33 bits
+    int16_t extremes[257];
+    for (size_t i = 0; i < 257; ++i) {
+        extremes[i] = (i & 1) ? 32767 : -32768;
+    }
+
+    ExpectInterpolate824BlockExact(stmlib::Interpolate824Block, braids::wav_sine);
+    ExpectInterpolate824BlockExact(stmlib::Interpolate824Block, noise);
+    ExpectInterpolate824BlockExact(stmlib::Interpolate824Block, extremes);
+
+    // Every kernel this CPU can run
+    for (int level = 0; level <= static_cast<int>(stmlib::simd_level()); ++level) {
+        const auto& kernels = stmlib::GetDspKernels(static_cast<stmlib::SimdLevel>(level));
+        ExpectInterpolate824BlockExact(kernels.interpolate_824, braids::wav_sine);
+        ExpectInterpolate824BlockExact(kernels.interpolate_824, noise);
+        ExpectInterpolate824BlockExact(kernels.interpolate_824, extremes);
+    }
+}
+
+TEST(Stmlib, FloatBlockKernelsMatchAcrossLevels)
+{
+    constexpr size_t kSize = 203;
+    int16_t samples[kSize];
+    float a[kSize], b[kSize], frac[kSize];
+    stmlib::Random random;
+    random.Seed(7);
+    for (size_t i = 0; i < kSize; ++i) {
+        samples[i] = random.GetSample();
+        a[i] = random.GetSample();
+        b[i] = random.GetSample();
+        frac[i] = random.GetFloat();
+    }
+
+    const auto& scalar = stmlib::GetDspKernels(stmlib::SimdLevel::Scalar);
+    float expected_add[kSize], expected_scaled[kSize], expected_lerp[kSize];
+    std::copy(a, a + kSize, expected_add);
+    std::copy(a, a + kSize, expected_scaled);
+    scalar.add(b, expected_add, kSize);
+    scalar.add_scaled(samples, 1.0f / 32768.0f, expected_scaled, kSize);
+    scalar.lerp(a, b, frac, 1.0f / 32768.0f, expected_lerp, kSize);
+    EXPECT_FLOAT_EQ(expected_add[5], a[5] + b[5]);
+    EXPECT_FLOAT_EQ(expected_lerp[5], (a[5] + (b[5] - a[5]) * frac[5]) / 32768.0f);
+
+    // Wider kernels must give exactly the same results
+    for (int level = 1; level <= static_cast<int>(stmlib::simd_level()); ++level) {
+        const auto& kernels = stmlib::GetDspKernels(static_cast<stmlib::SimdLevel>(level));
+        float add[kSize], scaled[kSize], lerp[kSize];
+        std::copy(a, a + kSize, add);
+        std::copy(a, a + kSize, scaled);
+        kernels.add(b, add, kSize);
+        kernels.add_scaled(samples, 1.0f / 32768.0f, scaled, kSize);
+        kernels.lerp(a, b, frac, 1.0f / 32768.0f, lerp, kSize);
+        for (size_t i = 0; i < kSize; ++i) {
+            EXPECT_EQ(add[i], expected_add[i]) << "level " << level << " at " << i;
+            EXPECT_EQ(scaled[i], expected_scaled[i]) << "level " << level << " at " << i;
+            EXPECT_EQ(lerp[i], expected_lerp[i]) << "level " << level << " at " << i;
+        }
+    }
+}
+
 TEST(Stmlib, Mix5050)
 {
     int16_t a = 0;
@@ -46,8 +150,9 @@ TEST(Stmlib, Mix5050)
 
 TEST(Stmlib, RandomProducesValues)
 {
-    stmlib::Random::Seed(12345);
-    int16_t sample = stmlib::Random::GetSample();
+    stmlib::Random random;
+    random.Seed(12345);
+    int16_t sample = random.GetSample();
     // Just verify it returns something in range
     EXPECT_GE(sample, -32768);
     EXPECT_LE(sample, 32767);
@@ -66,3 +171,65 @@ TEST(Resources, OscillatorIncrementsExist)
     // Verify LUT exists and has reasonable values
     EXPECT_GT(braids::lut_oscillator_increments[0], 0u);
 }
+
+TEST(Resources, OscillatorIncrementsFollowPitch)
+{
+    // Note 128 plus i/8 semitones, as a 32-bit phase increment at 96kHz
+    for (size_t i = 0; i < braids::LUT_OSCILLATOR_INCREMENTS_SIZE; ++i) {
+        double frequency = 440.0 * std::pow(2.0, (59.0 + i / 8.0) / 12.0);
+        EXPECT_NEAR(braids::lut_oscillator_increments[i], 4294967296.0 * frequency / 96000.0, 2.0);
+        if (i > 0) {
+            EXPECT_GT(braids::lut_oscillator_increments[i], braids::lut_oscillator_increments[i - 1]);
+        }
+    }
+}
+
+TEST(Resources, OscillatorIncrementsPerRate)
+{
+    EXPECT_EQ(braids::OscillatorIncrements(96000.0), braids::lut_oscillator_increments);
+    EXPECT_EQ(braids::OscillatorIncrements(12345.0), nullptr);
+
+    const uint32_t* increments = braids::OscillatorIncrements(44100.0);
+    ASSERT_NE(increments, nullptr);
+    for (size_t i = 0; i < braids::LUT_OSCILLATOR_INCREMENTS_SIZE; ++i) {
+        EXPECT_NEAR(increments[i], braids::lut_oscillator_increments[i] * (96000.0 / 44100.0), 3.0);
+    }
+}
+
+TEST(Resources, FoldWaveshaperLevelZeroMatchesCurve)
+{
+    // Same curves as the old 257-entry tables, at four times the resolution
+    const int16_t* sine_fold = braids::ws_sine_fold_mips[0];
+    EXPECT_EQ(sine_fold[0], -32767);
+    EXPECT_NEAR(sine_fold[256], 0, 1);
+    EXPECT_EQ(sine_fold[512], 32767);
+    EXPECT_EQ(sine_fold[1024], -32767);
+
+    const int16_t* tri_fold = braids::ws_tri_fold_mips[0];
+    EXPECT_EQ(tri_fold[0], 0);
+    EXPECT_EQ(tri_fold[256], 32767);
+    EXPECT_EQ(tri_fold[512], 0);
+    EXPECT_EQ(tri_fold[768], -32767);
+}
+
+TEST(Resources, FoldWaveshaperMipsGetSmoother)
+{
+    // Averaging rounds off the fold peaks, so each level peaks lower
+    int16_t previous_peak = 32767;
+    for (size_t level = 1; level < braids::kWsNumMips; ++level) {
+        const int16_t* tri_fold = braids::ws_tri_fold_mips[level];
+        int16_t peak = *std::max_element(tri_fold, tri_fold + braids::kWsTableSize + 1);
+        EXPECT_LT(peak, previous_peak);
+        previous_peak = peak;
+    }
+}
+
+TEST(Stmlib, RandomInstancesAreIndependent)
+{
+    stmlib::Random a, b;
+    a.Seed(99);
+    b.Seed(99);
+    uint32_t first = a.GetWord();
+    a.GetWord();  // Drawing from one doesn't move the other
+    EXPECT_EQ(b.GetWord(), first);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "dsp/voice_allocator.h"
+#include <vector>
 
 TEST(VoiceAllocator, InitDoesNotCrash)
 {
@@ -85,3 +86,190 @@ TEST(VoiceAllocator, SetPolyphonyWorks)
     allocator.setPolyphony(16);
     EXPECT_EQ(allocator.polyphony(), 16);
 }
+
+TEST(VoiceAllocator, PoolSupportsMoreThan16Voices)
+{
+    VoiceAllocator allocator;
+    allocator.Init(48000.0, 64, 64);
+
+    for (int note = 0; note < 64; ++note) {
+        allocator.NoteOn(note + 24, 0.8f, 10, 2000);
+    }
+
+    EXPECT_EQ(allocator.poolSize(), 64);
+    EXPECT_EQ(allocator.activeVoiceCount(), 64);
+}
+
+TEST(VoiceAllocator, PolyphonyClampedToPoolSize)
+{
+    VoiceAllocator allocator;
+    allocator.Init(48000.0, 8, 12);
+
+    allocator.setPolyphony(100);
+    EXPECT_EQ(allocator.polyphony(), 12);
+}
+
+TEST(VoiceAllocator, FinishedVoicesReturnToPool)
+{
+    VoiceAllocator allocator;
+    allocator.Init(48000.0, 2, 2);
+
+    allocator.NoteOn(60, 0.8f, 1, 10);  // Short envelopes finish quickly
+    allocator.NoteOn(64, 0.8f, 1, 10);
+    EXPECT_EQ(allocator.activeVoiceCount(), 2);
+
+    float left[256], right[256];
+    for (int i = 0; i < 20 && allocator.activeVoiceCount() > 0; ++i) {
+        allocator.Process(left, right, 256);
+    }
+    EXPECT_EQ(allocator.activeVoiceCount(), 0);
+
+    // Both voices can be allocated again without stealing
+    allocator.NoteOn(67, 0.8f, 10, 2000);
+    allocator.NoteOn(71, 0.8f, 10, 2000);
+    EXPECT_EQ(allocator.activeVoiceCount(), 2);
+}
+
+TEST(VoiceAllocator, QuietestPolicyStealsQuietestVoice)
+{
+    VoiceAllocator allocator;
+    allocator.Init(48000.0, 2, 4);
+    allocator.setStealPolicy(VoiceStealPolicy::Quietest);
+
+    allocator.NoteOn(60, 1.0f, 1, 2000);
+    allocator.NoteOn(64, 0.1f, 1, 2000);  // Newer but much quieter
+
+    float left[256], right[256];
+    allocator.Process(left, right, 256);
+
+    allocator.NoteOn(67, 1.0f, 1, 2000);
+    EXPECT_TRUE(allocator.isNotePlaying(60));
+    EXPECT_FALSE(allocator.isNotePlaying(64));
+    EXPECT_TRUE(allocator.isNotePlaying(67));
+    EXPECT_EQ(allocator.activeVoiceCount(), 2);
+}
+
+TEST(VoiceAllocator, OldestReleasedPolicyPrefersReleasedVoices)
+{
+    VoiceAllocator allocator;
+    allocator.Init(48000.0, 2, 4);
+    allocator.setStealPolicy(VoiceStealPolicy::OldestReleased);
+
+    allocator.NoteOn(60, 0.8f, 10, 2000);
+    allocator.NoteOn(64, 0.8f, 10, 2000);
+    allocator.NoteOff(64);
+
+    allocator.NoteOn(67, 0.8f, 10, 2000);
+    EXPECT_TRUE(allocator.isNotePlaying(60));   // Oldest, but still held
+    EXPECT_FALSE(allocator.isNotePlaying(64));
+    EXPECT_TRUE(allocator.isNotePlaying(67));
+}
+
+TEST(VoiceAllocator, StolenVoiceFadesOutOnSpareVoice)
+{
+    VoiceAllocator allocator;
+    allocator.Init(48000.0, 1, 2);
+    allocator.setStealPolicy(VoiceStealPolicy::Oldest);
+
+    allocator.NoteOn(60, 0.8f, 1, 2000);
+    allocator.NoteOn(64, 0.8f, 1, 2000);  // Steals 60, which crossfades out
+
+    EXPECT_EQ(allocator.activeVoiceCount(), 1);
+    EXPECT_TRUE(allocator.isNotePlaying(64));
+
+    // After the fade the old voice is back in the pool
+    float left[256], right[256];
+    allocator.Process(left, right, 256);
+    allocator.NoteOn(67, 0.8f, 1, 2000);
+    EXPECT_TRUE(allocator.isNotePlaying(67));
+    EXPECT_EQ(allocator.activeVoiceCount(), 1);
+}
+
+TEST(VoiceAllocator, NotesAreMatchedByChannel)
+{
+    VoiceAllocator allocator;
+    allocator.Init(48000.0, 8);
+
+    // Same note on two MPE member channels is two voices
+    allocator.NoteOn(60, 0.8f, 0, 500, 1);
+    allocator.NoteOn(60, 0.8f, 0, 500, 2);
+    EXPECT_EQ(allocator.activeVoiceCount(), 2);
+
+    // Note off on another channel leaves both held
+    allocator.setStealPolicy(VoiceStealPolicy::Oldest);
+    allocator.NoteOff(60, 3);
+    allocator.NoteOn(60, 0.8f, 0, 500, 1);  // Retriggers channel 1's voice
+    EXPECT_EQ(allocator.activeVoiceCount(), 2);
+}
+
+namespace {
+// Render one note on the given channel, applying bend on bendChannel
+std::vector<float> renderBent(int noteChannel, int bendChannel, int lowerZone)
+{
+    VoiceAllocator allocator;
+    allocator.Init(48000.0, 8);
+    allocator.setMpeZones(lowerZone, 0);
+    allocator.NoteOn(60, 0.8f, 0, 500, noteChannel);
+    allocator.setPitchBend(bendChannel, 2.0f);
+
+    std::vector<float> left(256), right(256);
+    allocator.Process(left.data(), right.data(), left.size());
+    return left;
+}
+}
+
+TEST(VoiceAllocator, PitchBendOnlyAffectsItsChannel)
+{
+    auto straight = renderBent(1, 5, 0);
+    auto bent = renderBent(1, 1, 0);
+    auto other = renderBent(1, 2, 0);
+
+    EXPECT_NE(straight, bent);
+    EXPECT_EQ(straight, other);
+}
+
+TEST(VoiceAllocator, MpeMasterBendAppliesToZoneMembers)
+{
+    auto straight = renderBent(3, 5, 0);  // No zone: channel 0 is not a master
+    auto viaMaster = renderBent(3, 0, 15);
+    auto noZone = renderBent(3, 0, 0);
+
+    EXPECT_NE(straight, viaMaster);
+    EXPECT_EQ(straight, noZone);
+}
+
+TEST(VoiceAllocator, MpeZonesDoNotOverlap)
+{
+    VoiceAllocator allocator;
+    allocator.Init(48000.0, 8);
+
+    allocator.setMpeZones(7, 7);
+    EXPECT_EQ(allocator.mpeMaster(0), 0);
+    EXPECT_EQ(allocator.mpeMaster(7), 0);
+    EXPECT_EQ(allocator.mpeMaster(8), 15);
+    EXPECT_EQ(allocator.mpeMaster(14), 15);
+    EXPECT_EQ(allocator.mpeMaster(15), 15);
+
+    // A full lower zone leaves no room for an upper one
+    allocator.setMpeZones(15, 4);
+    EXPECT_EQ(allocator.mpeMaster(14), 0);
+    EXPECT_EQ(allocator.mpeMaster(15), 0);
+}
+
+TEST(VoiceAllocator, NoiseRendersAreReproducibleFromTheSeed)
+{
+    auto render = [](uint32_t seed) {
+        VoiceAllocator allocator;
+        allocator.Seed(seed);
+        allocator.Init(48000.0, 8);
+        allocator.set_shape(braids::MACRO_OSC_SHAPE_FILTERED_NOISE);
+        allocator.set_parameters(16384, 16384);
+        allocator.NoteOn(60, 0.8f, 0, 500);
+        allocator.NoteOn(67, 0.8f, 0, 500);
+        std::vector<float> left(512), right(512);
+        allocator.Process(left.data(), right.data(), left.size());
+        return left;
+    };
+    EXPECT_EQ(render(5), render(5));
+    EXPECT_NE(render(5), render(6));
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "dsp/voice_modulation.h"
+#include "dsp/voice_allocator.h"
+
+TEST(VoiceModulation, NoRoutingPassesBaseThrough)
+{
+    VoiceModulation mod;
+    mod.Init();
+    mod.set_source(0, VoiceModSource::Velocity, 1.0f);
+    mod.set_source(1, VoiceModSource::Envelope, 0.5f);
+    mod.Process(2, 0.5f, 0.25f);
+
+    for (size_t i = 0; i < 2; ++i) {
+        EXPECT_EQ(mod.timbre(i), static_cast<int16_t>(0.5f * 32767.0f + 0.5f));
+        EXPECT_EQ(mod.color(i), static_cast<int16_t>(0.25f * 32767.0f + 0.5f));
+        EXPECT_FLOAT_EQ(mod.cutoff(i), 0.0f);
+    }
+    EXPECT_FALSE(mod.modulates_cutoff());
+}
+
+TEST(VoiceModulation, VelocityModulatesEachSlotIndependently)
+{
+    VoiceModulation mod;
+    mod.Init();
+    mod.SetDestination(VoiceModSource::Velocity, VoiceModDestination::Timbre);
+    mod.SetAmount(VoiceModSource::Velocity, 32);  // Half range
+
+    mod.set_source(0, VoiceModSource::Velocity, 0.0f);
+    mod.set_source(1, VoiceModSource::Velocity, 1.0f);
+    mod.Process(2, 0.25f, 0.0f);
+
+    EXPECT_NEAR(mod.timbre(0) / 32767.0f, 0.25f, 0.001f);
+    EXPECT_NEAR(mod.timbre(1) / 32767.0f, 0.75f, 0.001f);
+}
+
+TEST(VoiceModulation, ResultIsClamped)
+{
+    VoiceModulation mod;
+    mod.Init();
+    mod.SetDestination(VoiceModSource::Envelope, VoiceModDestination::Color);
+    mod.SetAmount(VoiceModSource::Envelope, 63);
+    mod.set_source(0, VoiceModSource::Envelope, 1.0f);
+    mod.Process(1, 0.0f, 0.9f);
+    EXPECT_EQ(mod.color(0), 32767);
+
+    mod.SetAmount(VoiceModSource::Envelope, -64);
+    mod.Process(1, 0.0f, 0.5f);
+    EXPECT_EQ(mod.color(0), 0);
+}
+
+TEST(VoiceModulation, SourcesSumOnSharedDestination)
+{
+    VoiceModulation mod;
+    mod.Init();
+    mod.SetDestination(VoiceModSource::Velocity, VoiceModDestination::Cutoff);
+    mod.SetDestination(VoiceModSource::Envelope, VoiceModDestination::Cutoff);
+    mod.SetAmount(VoiceModSource::Velocity, 32);
+    mod.SetAmount(VoiceModSource::Envelope, -16);
+    mod.set_source(0, VoiceModSource::Velocity, 1.0f);
+    mod.set_source(0, VoiceModSource::Envelope, 1.0f);
+    mod.Process(1, 0.0f, 0.0f);
+
+    EXPECT_TRUE(mod.modulates_cutoff());
+    EXPECT_NEAR(mod.cutoff(0), 0.25f, 0.0001f);
+}
+
+TEST(VoiceModulation, AllocatorReportsLargestCutoffOffset)
+{
+    VoiceAllocator allocator;
+    allocator.Init(48000.0, 8);
+    allocator.modulation().SetDestination(VoiceModSource::Velocity, VoiceModDestination::Cutoff);
+    allocator.modulation().SetAmount(VoiceModSource::Velocity, 32);
+
+    allocator.NoteOn(60, 0.25f, 0, 500);
+    allocator.NoteOn(64, 1.0f, 0, 500);
+
+    float left[64], right[64];
+    allocator.Process(left, right, 64);
+
+    EXPECT_NEAR(allocator.cutoffModulation(), 0.5f, 0.0001f);
+}
+
+TEST(VoiceModulation, SliceSizeDoesNotChangeOutput)
+{
+    // Rendering one long block or many short ones must give the same audio
+    VoiceAllocator a, b;
+    a.Init(44100.0, 4);
+    b.Init(44100.0, 4);
+    a.NoteOn(57, 0.8f, 0, 200);
+    b.NoteOn(57, 0.8f, 0, 200);
+
+    float leftA[480], rightA[480], leftB[480], rightB[480];
+    a.Process(leftA, rightA, 480);
+    for (size_t offset = 0; offset < 480; offset += 7) {
+        size_t n = std::min<size_t>(7, 480 - offset);
+        b.Process(leftB + offset, rightB + offset, n);
+    }
+
+    for (size_t i = 0; i < 480; ++i) {
+        ASSERT_FLOAT_EQ(leftA[i], leftB[i]) << "at sample " << i;
+    }
+}
+
+TEST(VoiceModulation, EachVoiceHasItsOwnModEnvelope)
+{
+    VoiceAllocator allocator;
+    allocator.Init(48000.0, 8);
+    allocator.modulation().SetDestination(VoiceModSource::ModEnv1, VoiceModDestination::Cutoff);
+    allocator.modulation().SetAmount(VoiceModSource::ModEnv1, 32);
+    allocator.modEnvelopes(0).SetAttack(0);
+    allocator.modEnvelopes(0).SetDecay(50);
+
+    float left[64], right[64];
+    allocator.NoteOn(60, 0.8f, 0, 2000);
+    for (int i = 0; i < 75; ++i) {
+        allocator.Process(left, right, 64);  // 100ms, past the first decay
+    }
+    EXPECT_EQ(allocator.activeVoiceCount(), 1);
+    EXPECT_NEAR(allocator.cutoffModulation(), 0.0f, 0.0001f);
+
+    // The second note starts its own envelope; the first stays finished
+    allocator.NoteOn(64, 0.8f, 0, 2000);
+    allocator.Process(left, right, 64);
+    EXPECT_GT(allocator.cutoffModulation(), 0.45f);
+    EXPECT_NEAR(allocator.modEnvelopes(0).output(0), 0.0f, 0.0001f);
+}
+
+TEST(VoiceModulation, ReusedVoiceStartsItsModEnvelopeFromZero)
+{
+    // One voice, whose note ends while ENV1 is still in its long attack
+    VoiceAllocator allocator;
+    allocator.Init(48000.0, 1, 1);
+    allocator.modEnvelopes(0).SetAttack(500);
+    allocator.modEnvelopes(0).SetDecay(500);
+
+    float left[64], right[64];
+    allocator.NoteOn(60, 0.8f, 1, 100);
+    for (int i = 0; i < 200 && allocator.activeVoiceCount() > 0; ++i) {
+        allocator.Process(left, right, 64);
+    }
+    ASSERT_EQ(allocator.activeVoiceCount(), 0);
+    EXPECT_GT(allocator.modEnvelopes(0).output(0), 0.05f);
+
+    // The next note on the same voice rises from 0, not from where it stopped
+    allocator.NoteOn(64, 0.8f, 1, 2000);
+    allocator.Process(left, right, 64);
+    EXPECT_LT(allocator.modEnvelopes(0).output(0), 0.01f);
+}
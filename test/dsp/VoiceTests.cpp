@@ -89,3 +89,83 @@ TEST(Voice, DifferentNotesProduceDifferentPitch)
     // Just verify they produce different outputs (pitch detection is complex)
     EXPECT_NE(crossings1, crossings2);
 }
+
+TEST(Voice, RetriggerKeepsVoiceActive)
+{
+    Voice voice;
+    voice.Init(48000.0);
+    voice.NoteOn(60, 1.0f, 1, 2000);
+
+    float buffer[256] = {0};
+    voice.Process(buffer, 256);
+
+    // Retrigger fades the old note out, then starts the new one
+    voice.NoteOn(62, 1.0f, 1, 2000);
+    EXPECT_TRUE(voice.active());
+    EXPECT_EQ(voice.note(), 62);
+
+    for (int i = 0; i < 4; ++i) {
+        voice.Process(buffer, 256);
+    }
+    EXPECT_TRUE(voice.active());
+    EXPECT_FALSE(voice.fading());
+}
+
+TEST(Voice, FadeOutDeactivates)
+{
+    Voice voice;
+    voice.Init(48000.0);
+    voice.NoteOn(60, 1.0f, 1, 2000);
+    voice.FadeOut();
+    EXPECT_TRUE(voice.fading());
+
+    // 2ms fade at 96kHz is well under 256 host samples
+    float buffer[256] = {0};
+    voice.Process(buffer, 256);
+    EXPECT_FALSE(voice.active());
+}
+
+TEST(Voice, HostRateRenderingKeepsPitch)
+{
+    Voice oversampled, hostRate;
+    oversampled.Init(48000.0);
+    hostRate.Init(48000.0, true);
+
+    oversampled.set_shape(braids::MACRO_OSC_SHAPE_CSAW);
+    hostRate.set_shape(braids::MACRO_OSC_SHAPE_CSAW);
+    oversampled.NoteOn(60, 1.0f, 1, 2000);
+    hostRate.NoteOn(60, 1.0f, 1, 2000);
+
+    float buffer1[4096] = {0}, buffer2[4096] = {0};
+    oversampled.Process(buffer1, 4096);
+    hostRate.Process(buffer2, 4096);
+
+    int crossings1 = 0, crossings2 = 0;
+    for (int i = 1025; i < 4096; ++i) {
+        if ((buffer1[i-1] < 0) != (buffer1[i] < 0)) crossings1++;
+        if ((buffer2[i-1] < 0) != (buffer2[i] < 0)) crossings2++;
+    }
+    EXPECT_GT(crossings2, 0);
+    EXPECT_NEAR(crossings1, crossings2, crossings1 / 10 + 2);
+}
+
+TEST(Voice, HostRateRenderingReachesTopNotes)
+{
+    // At 44.1kHz the top notes are past the end of the shifted 96kHz table;
+    // the rate's own table keeps them a semitone apart
+    int crossings[2] = {0, 0};
+    for (int n = 0; n < 2; ++n) {
+        Voice voice;
+        voice.Init(44100.0, true);
+        voice.set_shape(braids::MACRO_OSC_SHAPE_FM);
+        voice.NoteOn(120 + n, 1.0f, 1, 4000);
+
+        float buffer[4096] = {0};
+        voice.Process(buffer, 4096);
+        for (int i = 1025; i < 4096; ++i) {
+            if ((buffer[i-1] < 0) != (buffer[i] < 0)) crossings[n]++;
+        }
+    }
+    EXPECT_GT(crossings[0], 0);
+    EXPECT_GT(crossings[1], crossings[0]);
+}
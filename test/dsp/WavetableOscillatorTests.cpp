@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include "dsp/braids/wavetable_bank.h"
+#include "dsp/braids/wavetable_oscillator.h"
+#include "dsp/braids/macro_oscillator.h"
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+// Saw waves getting quieter through the bank
+std::vector<int16_t> MakeSawBank(size_t num_waves)
+{
+    std::vector<int16_t> samples;
+    for (size_t w = 0; w < num_waves; ++w) {
+        int32_t level = 32767 - static_cast<int32_t>(w * 32767 / num_waves);
+        for (size_t n = 0; n < braids::kWavetableSize; ++n) {
+            int32_t saw = static_cast<int32_t>(n * 65535 / (braids::kWavetableSize - 1)) - 32768;
+            samples.push_back(static_cast<int16_t>(saw * level >> 15));
+        }
+    }
+    return samples;
+}
+
+std::string WriteFile(const std::string& name, const std::vector<char>& bytes)
+{
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream file(path, std::ios::binary);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    return path.string();
+}
+
+std::vector<char> RawBytes(const std::vector<int16_t>& samples)
+{
+    const char* begin = reinterpret_cast<const char*>(samples.data());
+    return std::vector<char>(begin, begin + samples.size() * sizeof(int16_t));
+}
+
+void AppendLe(std::vector<char>& bytes, uint32_t value, int size)
+{
+    for (int i = 0; i < size; ++i) {
+        bytes.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+std::vector<char> WavBytes(const std::vector<int16_t>& samples, uint16_t channels)
+{
+    std::vector<char> data = RawBytes(samples);
+    std::vector<char> bytes = {'R', 'I', 'F', 'F'};
+    AppendLe(bytes, static_cast<uint32_t>(36 + data.size()), 4);
+    for (char c : std::string("WAVEfmt ")) bytes.push_back(c);
+    AppendLe(bytes, 16, 4);
+    AppendLe(bytes, 1, 2);  // PCM
+    AppendLe(bytes, channels, 2);
+    AppendLe(bytes, 48000, 4);
+    AppendLe(bytes, 48000 * 2 * channels, 4);
+    AppendLe(bytes, 2 * channels, 2);
+    AppendLe(bytes, 16, 2);
+    for (char c : std::string("data")) bytes.push_back(c);
+    AppendLe(bytes, static_cast<uint32_t>(data.size()), 4);
+    bytes.insert(bytes.end(), data.begin(), data.end());
+    return bytes;
+}
+
+} // namespace
+
+TEST(WavetableBank, LoadsRawBankInPlace)
+{
+    auto samples = MakeSawBank(4);
+    std::string path = WriteFile("braids_test_bank.raw", RawBytes(samples));
+
+    auto bank = braids::WavetableBank::Load(path);
+    ASSERT_NE(bank, nullptr);
+    EXPECT_EQ(bank->num_waves(), 4u);
+    for (size_t w = 0; w < 4; ++w) {
+        EXPECT_TRUE(std::equal(samples.begin() + w * 256, samples.begin() + (w + 1) * 256,
+                               bank->wave(w, 0)));
+    }
+    std::remove(path.c_str());
+}
+
+TEST(WavetableBank, LoadsMonoWavAndRejectsOtherFiles)
+{
+    auto samples = MakeSawBank(2);
+    std::string wav = WriteFile("braids_test_bank.wav", WavBytes(samples, 1));
+    auto bank = braids::WavetableBank::Load(wav);
+    ASSERT_NE(bank, nullptr);
+    EXPECT_EQ(bank->num_waves(), 2u);
+    EXPECT_TRUE(std::equal(samples.begin(), samples.end(), bank->wave(0, 0)));
+
+    std::string stereo = WriteFile("braids_test_stereo.wav", WavBytes(samples, 2));
+    EXPECT_EQ(braids::WavetableBank::Load(stereo), nullptr);
+
+    std::string partial = WriteFile("braids_test_partial.raw", std::vector<char>(300, 0));
+    EXPECT_EQ(braids::WavetableBank::Load(partial), nullptr);
+
+    EXPECT_EQ(braids::WavetableBank::Load("/nonexistent/bank.raw"), nullptr);
+
+    std::remove(wav.c_str());
+    std::remove(stereo.c_str());
+    std::remove(partial.c_str());
+}
+
+TEST(WavetableBank, SamePathIsShared)
+{
+    std::string path = WriteFile("braids_test_shared.raw", RawBytes(MakeSawBank(1)));
+    auto first = braids::WavetableBank::Load(path);
+    auto second = braids::WavetableBank::Load(path);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first.get(), second.get());
+    std::remove(path.c_str());
+}
+
+TEST(WavetableBank, FileSavedAgainLoadsAfresh)
+{
+    std::string path = WriteFile("braids_test_resaved.raw", RawBytes(MakeSawBank(1)));
+    auto first = braids::WavetableBank::Load(path);
+    ASSERT_NE(first, nullptr);
+
+    // Saved the way editors do: a new file moved over the old name
+    std::string edited = WriteFile("braids_test_resaved.tmp", RawBytes(MakeSawBank(2)));
+    std::filesystem::rename(edited, path);
+    auto second = braids::WavetableBank::Load(path);
+    ASSERT_NE(second, nullptr);
+    EXPECT_NE(first.get(), second.get());
+    EXPECT_EQ(first->num_waves(), 1u);
+    EXPECT_EQ(second->num_waves(), 2u);
+    std::remove(path.c_str());
+}
+
+TEST(WavetableBank, LastMipIsTheFundamental)
+{
+    std::string path = WriteFile("braids_test_mips.raw", RawBytes(MakeSawBank(1)));
+    auto bank = braids::WavetableBank::Load(path);
+    ASSERT_NE(bank, nullptr);
+
+    // A saw's fundamental is a sine of amplitude 2/pi, falling through zero
+    // at the start of the cycle
+    const int16_t* fundamental = bank->wave(0, braids::kWavetableNumMips - 1);
+    for (size_t n = 0; n < braids::kWavetableSize; ++n) {
+        double expected = -32768.0 * 2.0 / 3.14159265358979 *
+                          std::sin(2.0 * 3.14159265358979 * n / braids::kWavetableSize);
+        EXPECT_NEAR(fundamental[n], expected, 300.0) << n;
+    }
+    std::remove(path.c_str());
+}
+
+TEST(WavetableOscillator, MipsStayBelowNyquist)
+{
+    for (uint32_t increment = 1 << 20; increment < 0x40000000u; increment += increment >> 4) {
+        size_t mip = braids::WavetableOscillator::MipForIncrement(increment);
+        uint64_t highest = static_cast<uint64_t>(increment) * (braids::kWavetableSize / 2 >> mip);
+        if (mip < braids::kWavetableNumMips - 1) {
+            EXPECT_LE(highest, 0x80000000u) << increment;
+        }
+        // And no darker than it has to be
+        if (mip > 0) {
+            EXPECT_GT(highest * 2, 0x80000000u) << increment;
+        }
+    }
+}
+
+TEST(WavetableOscillator, PlaysASineWithoutABank)
+{
+    braids::WavetableOscillator osc;
+    osc.Init();
+    osc.set_pitch(60 << 7);
+    osc.set_parameters(0, 32767);
+
+    int16_t buffer[512];
+    osc.Render(buffer, 512);
+    const double increment = 2.0 * 3.14159265358979 * 261.6256 / 96000.0;
+    for (int i = 0; i < 512; ++i) {
+        EXPECT_NEAR(buffer[i], 32767.0 * std::sin(increment * (i + 1)), 200.0);
+    }
+}
+
+TEST(WavetableOscillator, PositionCrossfadesWaves)
+{
+    std::string path = WriteFile("braids_test_position.raw", RawBytes(MakeSawBank(2)));
+    auto bank = braids::WavetableBank::Load(path);
+    ASSERT_NE(bank, nullptr);
+
+    auto peak = [&](int16_t position) {
+        braids::MacroOscillator osc;
+        osc.Init();
+        osc.set_shape(braids::MACRO_OSC_SHAPE_WAVETABLE);
+        osc.set_wavetable(bank.get());
+        osc.set_pitch(36 << 7);
+        osc.set_parameters(position, 32767);
+        int16_t buffer[128];
+        uint8_t sync[128] = {0};
+        int32_t result = 0;
+        for (int block = 0; block < 12; ++block) {
+            osc.Render(sync, buffer, 128);
+            for (int i = 0; i < 128; ++i) {
+                result = std::max<int32_t>(result, std::abs(static_cast<int32_t>(buffer[i])));
+            }
+        }
+        return result;
+    };
+
+    // The second wave is half as loud as the first
+    int32_t first = peak(0);
+    int32_t middle = peak(16384);
+    int32_t last = peak(32767);
+    EXPECT_GT(first, 30000);
+    EXPECT_NEAR(last, first / 2, 1000);
+    EXPECT_NEAR(middle, first * 3 / 4, 1000);
+    std::remove(path.c_str());
+}